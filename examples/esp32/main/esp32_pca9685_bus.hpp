@@ -28,7 +28,10 @@ extern "C" {
 #include "driver/i2c_master.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #ifdef __cplusplus
 }
@@ -49,6 +52,9 @@ static constexpr const char* TAG_I2C = "PCA9685_I2C";
  */
 class Esp32Pca9685I2cBus : public pca9685::I2cInterface<Esp32Pca9685I2cBus> {
 public:
+  /// Largest payload accepted by Write() (excluding the register byte)
+  static constexpr size_t MAX_WRITE_LEN = 64;
+
   /**
    * @brief I2C bus configuration structure
    */
@@ -167,10 +173,10 @@ public:
       return false;
     }
 
-    // Prepare write buffer: register address + data
-    std::array<uint8_t, 32> write_buffer{}; // Max 32 bytes (register + 31 data bytes)
-    if (len > 31) {
-      ESP_LOGE(TAG_I2C, "Write length %zu exceeds maximum (31 bytes)", len);
+    // Prepare write buffer: register address + data (64 bytes = all 16 LEDn channels)
+    std::array<uint8_t, 1 + MAX_WRITE_LEN> write_buffer{};
+    if (len > MAX_WRITE_LEN) {
+      ESP_LOGE(TAG_I2C, "Write length %zu exceeds maximum (%zu bytes)", len, MAX_WRITE_LEN);
       return false;
     }
 
@@ -235,6 +241,76 @@ public:
     vTaskDelay(pdMS_TO_TICKS(1));
   }
 
+  /**
+   * @brief Microsecond delay callback for PCA9685 retry-policy backoff.
+   *
+   * Pass to driver via SetRetryDelayUs(Esp32Pca9685I2cBus::RetryDelayUs). Delays of 1 ms
+   * or more block the task for at least the requested time: rounded up to whole ticks,
+   * plus one because vTaskDelay() may return up to a tick early. Shorter delays busy-wait,
+   * as blocking would cost a whole tick.
+   */
+  static void RetryDelayUs(uint32_t delay_us) noexcept {
+    if (delay_us < 1000U) {
+      esp_rom_delay_us(delay_us);
+      return;
+    }
+    const auto ticks = static_cast<TickType_t>((delay_us + TICK_US - 1U) / TICK_US);
+    vTaskDelay(ticks + 1U);
+  }
+
+  /**
+   * @brief Microsecond sleep for pca9685::FrameScheduler.
+   *
+   * Blocks the task for the whole RTOS ticks in @p delay_us and busy-waits only for a
+   * sub-tick remainder. vTaskDelay() may return up to a tick early; the scheduler re-checks
+   * its clock and sleeps again for what is left, by then aligned to the tick.
+   */
+  static void SleepUs(uint32_t delay_us) noexcept {
+    const auto ticks = static_cast<TickType_t>(delay_us / TICK_US);
+    if (ticks > 0) {
+      vTaskDelay(ticks);
+    } else {
+      esp_rom_delay_us(delay_us);
+    }
+  }
+
+  /**
+   * @brief Monotonic microsecond clock for PCA9685 driver latency histograms.
+   *
+   * Pass to driver via SetClock(Esp32Pca9685I2cBus::NowUs). Truncates the 64-bit
+   * esp_timer value; the driver handles 32-bit wrap-around.
+   */
+  static uint32_t NowUs() noexcept {
+    return static_cast<uint32_t>(esp_timer_get_time());
+  }
+
+  /**
+   * @brief FreeRTOS mutex lock policy for pca9685::BusArbiter.
+   *
+   * Statically allocated, with priority inheritance, so a low-priority task holding
+   * the bus for one transaction cannot be starved by medium-priority tasks.
+   */
+  class FreeRtosMutexLock {
+  public:
+    FreeRtosMutexLock() noexcept : handle_(xSemaphoreCreateMutexStatic(&storage_)) {}
+    ~FreeRtosMutexLock() noexcept {
+      vSemaphoreDelete(handle_);
+    }
+    FreeRtosMutexLock(const FreeRtosMutexLock&) = delete;
+    FreeRtosMutexLock& operator=(const FreeRtosMutexLock&) = delete;
+
+    void lock() noexcept {
+      (void)xSemaphoreTake(handle_, portMAX_DELAY);
+    }
+    void unlock() noexcept {
+      (void)xSemaphoreGive(handle_);
+    }
+
+  private:
+    StaticSemaphore_t storage_{};
+    SemaphoreHandle_t handle_;
+  };
+
   /**
    * @brief Get the I2C configuration
    * @return Reference to the I2C configuration
@@ -252,6 +328,9 @@ public:
   }
 
 private:
+  /// Length of one RTOS tick in microseconds
+  static constexpr uint32_t TICK_US = 1000000U / configTICK_RATE_HZ;
+
   I2CConfig config_;
   i2c_master_bus_handle_t bus_handle_;
   bool initialized_;
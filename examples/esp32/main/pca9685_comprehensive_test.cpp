@@ -16,6 +16,8 @@
  */
 
 // System headers
+#include <array>
+#include <cstring>
 #include <memory>
 
 // Third-party headers (ESP-IDF)
@@ -26,6 +28,7 @@ extern "C" {
 #include "driver/i2c_master.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #ifdef __cplusplus
 }
@@ -35,6 +38,17 @@ extern "C" {
 #include "TestFramework.h"
 #include "esp32_pca9685_bus.hpp"
 #include "pca9685.hpp"
+#include "pca9685_animation.hpp"
+#include "pca9685_async.hpp"
+#include "pca9685_bus_arbiter.hpp"
+#include "pca9685_bus_monitor.hpp"
+#include "pca9685_dither.hpp"
+#include "pca9685_fault_injector.hpp"
+#include "pca9685_frame_mailbox.hpp"
+#include "pca9685_frame_stream.hpp"
+#include "pca9685_scheduler.hpp"
+#include "pca9685_trace.hpp"
+#include "pca9685_trajectory.hpp"
 
 // Use fully qualified name for the class
 using PCA9685Driver = pca9685::PCA9685<Esp32Pca9685I2cBus>;
@@ -56,6 +70,10 @@ static constexpr bool ENABLE_STRESS_TESTS = true;
 // PCA9685 I2C address (default 0x40, can be changed via A0-A5 pins)
 static constexpr uint8_t PCA9685_I2C_ADDRESS = 0x40;
 
+// Clock wired to the EXTCLK pin in Hz (0 = none: the EXTCLK switch is skipped, since it
+// stops the outputs until a power cycle when no clock is present)
+static constexpr uint32_t PCA9685_EXTCLK_HZ = 0;
+
 //=============================================================================
 // SHARED TEST RESOURCES
 //=============================================================================
@@ -375,320 +393,1633 @@ static bool test_duty_cycle() noexcept {
   return true;
 }
 
-//=============================================================================
-// ADVANCED TEST CASES
-//=============================================================================
-
 /**
- * @brief Test SetAllPwm and channel full-on/full-off
+ * @brief Test the ReadyHandle hot-path API
  */
-static bool test_all_channel_control() noexcept {
-  ESP_LOGI(TAG, "Testing all-channel and full-on/off control...");
+static bool test_ready_handle() noexcept {
+  ESP_LOGI(TAG, "Testing ReadyHandle hot-path setters...");
 
   if (!g_driver) {
     ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
 
-  if (!g_driver->SetPwmFreq(200.0f)) {
-    ESP_LOGE(TAG, "Failed to set frequency");
-    return false;
-  }
-
-  // SetAllPwm: set all channels to 25%
-  if (!g_driver->SetAllPwm(0, 1024)) {
-    ESP_LOGE(TAG, "SetAllPwm(0, 1024) failed");
-    return false;
-  }
-  vTaskDelay(pdMS_TO_TICKS(10));
-
-  // SetAllPwm: set all channels to 75%
-  if (!g_driver->SetAllPwm(0, 3072)) {
-    ESP_LOGE(TAG, "SetAllPwm(0, 3072) failed");
+  auto pwm = g_driver->GetReadyHandle();
+  if (!pwm) {
+    ESP_LOGE(TAG, "GetReadyHandle() returned an invalid handle");
     return false;
   }
-  vTaskDelay(pdMS_TO_TICKS(10));
 
-  // SetChannelFullOn / SetChannelFullOff for each channel
+  // Runtime channel index: range-checked only
   for (uint8_t ch = 0; ch < 16; ++ch) {
-    if (!g_driver->SetChannelFullOn(ch)) {
-      ESP_LOGE(TAG, "SetChannelFullOn(%d) failed", ch);
+    if (!pwm.SetPwm(ch, 0, 1024)) {
+      ESP_LOGE(TAG, "handle.SetPwm(%d) failed", ch);
       return false;
     }
   }
-  vTaskDelay(pdMS_TO_TICKS(10));
-
-  for (uint8_t ch = 0; ch < 16; ++ch) {
-    if (!g_driver->SetChannelFullOff(ch)) {
-      ESP_LOGE(TAG, "SetChannelFullOff(%d) failed", ch);
-      return false;
-    }
+  if (pwm.SetPwm(16, 0, 0) || !g_driver->HasError(PCA9685Driver::Error::OutOfRange)) {
+    ESP_LOGE(TAG, "handle.SetPwm(16, ...) should fail with OutOfRange");
+    return false;
   }
-  vTaskDelay(pdMS_TO_TICKS(10));
+  g_driver->ClearErrorFlags();
 
-  // Return to normal PWM after full-on/off test
-  if (!g_driver->SetAllPwm(0, 0)) {
-    ESP_LOGE(TAG, "Failed to clear all channels");
+  // Compile-time channel index: no runtime checks
+  if (!pwm.SetPwm<0>(0, 2048) || !pwm.SetDuty<15>(0.75f) || !pwm.SetChannelFullOn<7>() ||
+      !pwm.SetChannelFullOff<7>()) {
+    ESP_LOGE(TAG, "Compile-time channel setters failed");
     return false;
   }
 
-  ESP_LOGI(TAG, "✅ All-channel and full-on/off tests passed");
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  for (int i = 0; i < 100; ++i) {
+    (void)pwm.SetPwm<0>(0, static_cast<uint16_t>(i * 40));
+  }
+  ESP_LOGI(TAG, "  100 handle writes: %lu us",
+           (unsigned long)(Esp32Pca9685I2cBus::NowUs() - start_us));
+
+  ESP_LOGI(TAG, "✅ ReadyHandle tests passed");
   return true;
 }
 
 /**
- * @brief Test prescale readback and frequency boundary values
+ * @brief Test frame staging and phase-staggered duty writes
  */
-static bool test_prescale_readback() noexcept {
-  ESP_LOGI(TAG, "Testing prescale readback and frequency boundaries...");
+static bool test_phase_stagger() noexcept {
+  ESP_LOGI(TAG, "Testing frame staging and phase staggering...");
 
   if (!g_driver) {
     ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
 
-  // Test boundary frequencies and verify prescale readback
-  struct FreqTest {
-    float freq_hz;
-    uint8_t expected_prescale; // prescale = round(25MHz / (4096 * freq)) - 1
-  };
-  FreqTest freq_tests[] = {
-      {50.0f, 121}, // 25e6 / (4096 * 50) - 1 = 121.07 -> 121
-      {200.0f, 29}, // 25e6 / (4096 * 200) - 1 = 29.52 -> 30   (approximate)
-      {1000.0f, 5}, // 25e6 / (4096 * 1000) - 1 = 5.10 -> 5
-      {24.0f, 253}, // Min valid frequency
-      {1526.0f, 3}, // Max valid frequency (prescale min = 3)
-  };
-
-  for (const auto& test : freq_tests) {
-    if (!g_driver->SetPwmFreq(test.freq_hz)) {
-      ESP_LOGE(TAG, "Failed to set frequency %.0f Hz", test.freq_hz);
+  g_driver->SetPhaseMode(PCA9685Driver::PhaseMode::Even);
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (g_driver->GetPhaseOffset(ch) != ch * 256) {
+      ESP_LOGE(TAG, "Even offset of channel %d is %u", ch, g_driver->GetPhaseOffset(ch));
       return false;
     }
-    vTaskDelay(pdMS_TO_TICKS(5));
-
-    uint8_t prescale = 0;
-    if (!g_driver->GetPrescale(prescale)) {
-      ESP_LOGE(TAG, "Failed to read prescale at %.0f Hz", test.freq_hz);
+    if (!g_driver->StageDuty(ch, 0.5f)) {
+      ESP_LOGE(TAG, "StageDuty(%d) failed", ch);
       return false;
     }
+  }
+  if (!g_driver->CommitFrame()) {
+    ESP_LOGE(TAG, "CommitFrame() failed (even phases)");
+    return false;
+  }
+  if (!g_driver->SetDuty(3, 0.25f)) {
+    ESP_LOGE(TAG, "SetDuty with phase offset failed");
+    return false;
+  }
 
-    // Allow +/- 1 tolerance for rounding differences
-    int diff = static_cast<int>(prescale) - static_cast<int>(test.expected_prescale);
-    if (diff < -1 || diff > 1) {
-      ESP_LOGE(TAG, "Prescale mismatch at %.0f Hz: got %d, expected %d (±1)", test.freq_hz,
-               prescale, test.expected_prescale);
-      return false;
-    }
-    ESP_LOGI(TAG, "  %.0f Hz -> prescale=%d (expected %d) ✓", test.freq_hz, prescale,
-             test.expected_prescale);
+  g_driver->SetPhaseMode(PCA9685Driver::PhaseMode::LoadBalanced);
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    (void)g_driver->StageDutyTicks(ch, static_cast<uint16_t>(256 * (ch % 4)));
   }
+  if (!g_driver->CommitFrame()) {
+    ESP_LOGE(TAG, "CommitFrame() failed (load-balanced phases)");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Load-balanced offsets: ch1=%u ch2=%u ch3=%u", g_driver->GetPhaseOffset(1),
+           g_driver->GetPhaseOffset(2), g_driver->GetPhaseOffset(3));
 
-  // Test out-of-range frequencies (should fail gracefully)
-  if (g_driver->SetPwmFreq(10.0f)) {
-    ESP_LOGW(TAG, "10 Hz was accepted (below 24 Hz min) -- unexpected but not fatal");
+  if (g_driver->StageDutyTicks(0, 4097) || g_driver->StagePwm(16, 0, 0)) {
+    ESP_LOGE(TAG, "Out-of-range staging should fail");
+    return false;
   }
   g_driver->ClearErrorFlags();
 
-  if (g_driver->SetPwmFreq(2000.0f)) {
-    ESP_LOGW(TAG, "2000 Hz was accepted (above 1526 Hz max) -- unexpected but not fatal");
+  g_driver->SetPhaseMode(PCA9685Driver::PhaseMode::None);
+  if (!g_driver->SetAllPwm(0, 0)) {
+    ESP_LOGE(TAG, "SetAllPwm() failed");
+    return false;
   }
-  g_driver->ClearErrorFlags();
 
-  ESP_LOGI(TAG, "✅ Prescale readback and boundary tests passed");
+  ESP_LOGI(TAG, "✅ Phase staggering tests passed");
   return true;
 }
 
 /**
- * @brief Test sleep/wake power management
+ * @brief Test gamma-corrected brightness setters
  */
-static bool test_sleep_wake() noexcept {
-  ESP_LOGI(TAG, "Testing sleep/wake power management...");
+static bool test_gamma_brightness() noexcept {
+  ESP_LOGI(TAG, "Testing gamma / CIE brightness lookup...");
 
   if (!g_driver) {
     ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
 
-  // Set up a known PWM state before sleep
-  if (!g_driver->SetPwmFreq(100.0f)) {
-    ESP_LOGE(TAG, "Failed to set frequency before sleep test");
+  static_assert(pca9685::GAMMA_2_2_TABLE[256] == PCA9685Driver::DUTY_FULL_SCALE_,
+                "Gamma table must end at full scale");
+  if (pca9685::GammaLookup(pca9685::GAMMA_2_2_TABLE, 32768) >= 1024 ||
+      pca9685::GammaLookup8(pca9685::GAMMA_CIE1931_TABLE, 0) != 0) {
+    ESP_LOGE(TAG, "Unexpected gamma table values");
     return false;
   }
-  if (!g_driver->SetDuty(0, 0.5f)) {
-    ESP_LOGE(TAG, "Failed to set duty before sleep");
+
+  g_driver->SetGammaTable(&pca9685::GAMMA_CIE1931_TABLE);
+  if (!g_driver->SetBrightness(0, 65535) || !g_driver->SetBrightness(1, 0) ||
+      !g_driver->SetBrightness(2, 1000)) {
+    ESP_LOGE(TAG, "SetBrightness() failed");
     return false;
   }
-  vTaskDelay(pdMS_TO_TICKS(10));
 
-  // Enter sleep
-  if (!g_driver->Sleep()) {
-    ESP_LOGE(TAG, "Sleep() failed");
+  // Fade all channels up through the LUT, one frame per step
+  uint8_t levels[16];
+  for (uint16_t step = 0; step <= 255; step += 15) {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      levels[ch] = static_cast<uint8_t>(step);
+    }
+    if (!g_driver->StageBrightness(0, levels, 16) || !g_driver->CommitFrame()) {
+      ESP_LOGE(TAG, "Brightness frame %u failed", step);
+      return false;
+    }
+  }
+
+  if (g_driver->StageBrightness(8, levels, 9) || g_driver->SetBrightness(16, 0)) {
+    ESP_LOGE(TAG, "Out-of-range brightness should fail");
     return false;
   }
-  ESP_LOGI(TAG, "  Device in sleep mode");
-  vTaskDelay(pdMS_TO_TICKS(50));
+  g_driver->ClearErrorFlags();
 
-  // Wake and verify device is responsive
-  if (!g_driver->Wake()) {
-    ESP_LOGE(TAG, "Wake() failed");
+  g_driver->SetGammaTable(nullptr);
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Gamma brightness tests passed");
+  return true;
+}
+
+/**
+ * @brief Test sigma-delta dithering through frame commits
+ */
+static bool test_dither() noexcept {
+  ESP_LOGI(TAG, "Testing temporal dithering...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
-  ESP_LOGI(TAG, "  Device woke up");
-  vTaskDelay(pdMS_TO_TICKS(10));
 
-  // Verify device is functional after wake: set PWM on all channels
+  pca9685::Dither<16> dither;
+  dither.SetThreshold(256);
   for (uint8_t ch = 0; ch < 16; ++ch) {
-    if (!g_driver->SetDuty(ch, 0.25f)) {
-      ESP_LOGE(TAG, "Failed to set duty on ch %d after wake", ch);
-      return false;
-    }
+    (void)dither.SetTarget(ch, static_cast<uint16_t>(ch * 13)); // 0 to 12.2 ticks
   }
 
-  // Multiple sleep/wake cycles
-  for (int cycle = 0; cycle < 5; ++cycle) {
-    if (!g_driver->Sleep()) {
-      ESP_LOGE(TAG, "Sleep() failed on cycle %d", cycle);
-      return false;
+  // Over 16 frames every output must average to its 16-bit target exactly
+  std::array<uint32_t, 16> sum{};
+  int commits = 0;
+  for (int frame = 0; frame < 16; ++frame) {
+    if (dither.Step() != 0) {
+      if (!dither.Stage(*g_driver) || !g_driver->CommitFrame()) {
+        ESP_LOGE(TAG, "Dither frame %d commit failed", frame);
+        return false;
+      }
+      ++commits;
     }
-    vTaskDelay(pdMS_TO_TICKS(10));
-    if (!g_driver->Wake()) {
-      ESP_LOGE(TAG, "Wake() failed on cycle %d", cycle);
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      sum[ch] += dither.GetOutput(ch);
+    }
+  }
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (sum[ch] != dither.GetTarget(ch)) {
+      ESP_LOGE(TAG, "Channel %d averages %lu/16, expected %lu/16", ch, (unsigned long)sum[ch],
+               (unsigned long)dither.GetTarget(ch));
       return false;
     }
-    vTaskDelay(pdMS_TO_TICKS(10));
   }
+  ESP_LOGI(TAG, "  16 frames, %d commits", commits);
 
-  ESP_LOGI(TAG, "✅ Sleep/wake tests passed (5 cycles)");
+  // Above the threshold targets are rounded and stop changing
+  dither.SetAllTargets(40000);
+  (void)dither.Step();
+  if (dither.Step() != 0) {
+    ESP_LOGE(TAG, "Targets above the threshold should not dither");
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Dither tests passed");
   return true;
 }
 
 /**
- * @brief Test output configuration (invert, driver mode)
+ * @brief Test the trajectory generator driving frame commits
  */
-static bool test_output_config() noexcept {
-  ESP_LOGI(TAG, "Testing output configuration...");
+static bool test_trajectory() noexcept {
+  ESP_LOGI(TAG, "Testing trajectory generator with frame commits...");
 
   if (!g_driver) {
     ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
 
-  // Test output invert toggle
-  if (!g_driver->SetOutputInvert(true)) {
-    ESP_LOGE(TAG, "SetOutputInvert(true) failed");
+  using Motion = pca9685::Trajectory<16>;
+  Motion motion;
+  Motion::Limits limits;
+  limits.max_velocity = 8 << 8;
+  limits.max_accel = 2 << 8;
+  limits.profile = Motion::Profile::SCurve;
+  limits.min_ticks = 205;
+  limits.max_ticks = 410;
+  motion.SetAllLimits(limits);
+  motion.JumpAll(205);
+  motion.SetAllTargets(410);
+
+  int frames = 0;
+  while (!motion.AllAtTarget() && frames < 500) {
+    motion.Step();
+    if (!motion.Stage(*g_driver) || !g_driver->CommitFrame()) {
+      ESP_LOGE(TAG, "Frame %d commit failed", frames);
+      return false;
+    }
+    ++frames;
+  }
+  if (!motion.AllAtTarget() || motion.GetPosition(0) != 410) {
+    ESP_LOGE(TAG, "Trajectory did not settle (position %u after %d frames)",
+             motion.GetPosition(0), frames);
     return false;
   }
-  vTaskDelay(pdMS_TO_TICKS(5));
+  ESP_LOGI(TAG, "  205 -> 410 ticks in %d frames", frames);
 
-  if (!g_driver->SetOutputInvert(false)) {
-    ESP_LOGE(TAG, "SetOutputInvert(false) failed");
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Trajectory tests passed");
+  return true;
+}
+
+/**
+ * @brief Test table-driven animation playback through frame commits
+ */
+static bool test_animation_player() noexcept {
+  ESP_LOGI(TAG, "Testing animation player with frame commits...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
-  vTaskDelay(pdMS_TO_TICKS(5));
 
-  // Test output driver mode
-  if (!g_driver->SetOutputDriverMode(true)) { // totem-pole
-    ESP_LOGE(TAG, "SetOutputDriverMode(totem-pole) failed");
-    return false;
+  static constexpr auto SINE = pca9685::SineTable<64>();
+  static_assert(SINE[0] == 32768 && SINE[16] == 65535 && SINE[48] == 0, "Sine table shape");
+
+  pca9685::AnimationPlayer<16> player;
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    const int track = player.AddTrack(ch, SINE, 64, static_cast<uint16_t>(ch * 4096));
+    if (track < 0 || !player.SetTrackRange(track, 0, 4096)) {
+      ESP_LOGE(TAG, "AddTrack(%d) failed", ch);
+      return false;
+    }
   }
-  vTaskDelay(pdMS_TO_TICKS(5));
 
-  if (!g_driver->SetOutputDriverMode(false)) { // open-drain
-    ESP_LOGE(TAG, "SetOutputDriverMode(open-drain) failed");
-    return false;
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  for (int frame = 0; frame < 128; ++frame) {
+    (void)player.Step();
+    if (!player.Stage(*g_driver) || !g_driver->CommitFrame()) {
+      ESP_LOGE(TAG, "Frame %d commit failed", frame);
+      return false;
+    }
   }
-  vTaskDelay(pdMS_TO_TICKS(5));
+  ESP_LOGI(TAG, "  128 frames x 16 channels: %lu us",
+           (unsigned long)(Esp32Pca9685I2cBus::NowUs() - start_us));
 
-  // Restore default (totem-pole)
-  if (!g_driver->SetOutputDriverMode(true)) {
-    ESP_LOGE(TAG, "Failed to restore totem-pole mode");
+  // Two full periods played: every track is back at its start phase
+  (void)player.Step();
+  if (player.GetOutput(0) != 2048 || player.GetOutput(12) != 0) {
+    ESP_LOGE(TAG, "Unexpected outputs after two periods: ch0=%u ch12=%u", player.GetOutput(0),
+             player.GetOutput(12));
     return false;
   }
 
-  ESP_LOGI(TAG, "✅ Output configuration tests passed");
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Animation player tests passed");
   return true;
 }
 
 /**
- * @brief Test error flag management
+ * @brief Test streaming playback of an encoded frame stream
  */
-static bool test_error_handling() noexcept {
-  ESP_LOGI(TAG, "Testing error flag management...");
+static bool test_frame_stream() noexcept {
+  ESP_LOGI(TAG, "Testing frame stream encode/decode playback...");
 
   if (!g_driver) {
     ESP_LOGE(TAG, "Driver not initialized");
     return false;
   }
 
-  // After successful operations, no errors should be set
-  g_driver->ClearErrorFlags();
-  if (g_driver->HasAnyError()) {
-    ESP_LOGE(TAG, "Error flags not cleared");
-    return false;
-  }
+  struct BufferSink {
+    uint8_t data[1024];
+    size_t size = 0;
+    bool Write(const uint8_t* bytes, size_t n) {
+      if (size + n > sizeof(data)) {
+        return false;
+      }
+      memcpy(data + size, bytes, n);
+      size += n;
+      return true;
+    }
+  };
+  static BufferSink sink;
+  sink.size = 0;
 
-  // Trigger an out-of-range error: channel 255 is invalid
-  bool result = g_driver->SetPwm(255, 0, 2048);
-  if (result) {
-    ESP_LOGE(TAG, "SetPwm(255,...) should have failed");
+  // 64-frame fade: every channel ramps up 40 ticks per frame, channel 0 jumps at frame 32
+  pca9685::FrameStreamWriter<BufferSink> writer(sink);
+  if (!writer.Begin(1, 20)) {
+    ESP_LOGE(TAG, "Writer Begin() failed");
     return false;
   }
-  if (!g_driver->HasError(PCA9685Driver::Error::OutOfRange)) {
-    ESP_LOGE(TAG, "Expected OutOfRange error flag after invalid channel");
-    return false;
+  for (uint16_t frame = 0; frame < 64; ++frame) {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      const uint16_t value = (ch == 0 && frame >= 32) ? 4096 : static_cast<uint16_t>(frame * 40);
+      (void)writer.SetValue(0, ch, value);
+    }
+    if (!writer.EndFrame()) {
+      ESP_LOGE(TAG, "EndFrame(%u) failed", frame);
+      return false;
+    }
   }
-  ESP_LOGI(TAG, "  Invalid channel correctly rejected with OutOfRange error");
+  (void)writer.End();
+  ESP_LOGI(TAG, "  64 frames x 16 channels encoded in %u bytes", (unsigned)sink.size);
 
-  // Clear and verify
-  g_driver->ClearError(PCA9685Driver::Error::OutOfRange);
-  if (g_driver->HasError(PCA9685Driver::Error::OutOfRange)) {
-    ESP_LOGE(TAG, "OutOfRange flag not cleared");
+  pca9685::MemorySource source(sink.data, sink.size);
+  pca9685::FrameStreamReader<pca9685::MemorySource, 1, 16> reader(source);
+  if (!reader.Begin() || reader.GetHeader().frame_period_ms != 20) {
+    ESP_LOGE(TAG, "Reader Begin() failed");
     return false;
   }
-
-  // Trigger out-of-range PWM value
-  result = g_driver->SetPwm(0, 5000, 0);
-  if (result) {
-    ESP_LOGE(TAG, "SetPwm(0, 5000, 0) should have failed (on > 4095)");
-    return false;
+  pca9685::StreamResult result;
+  while ((result = reader.Next()) == pca9685::StreamResult::Frame) {
+    if (!reader.Stage(*g_driver) || !g_driver->CommitFrame()) {
+      ESP_LOGE(TAG, "Frame %lu commit failed", (unsigned long)reader.GetFrameIndex());
+      return false;
+    }
   }
-  ESP_LOGI(TAG, "  Invalid PWM value correctly rejected");
-  g_driver->ClearErrorFlags();
-
-  // Trigger out-of-range frequency
-  result = g_driver->SetPwmFreq(5.0f);
-  if (result) {
-    ESP_LOGE(TAG, "SetPwmFreq(5.0) should have failed (below 24 Hz)");
+  if (result != pca9685::StreamResult::End || reader.GetFrameIndex() != 64 ||
+      reader.GetValue(0, 0) != 4096 || reader.GetValue(0, 15) != 63 * 40) {
+    ESP_LOGE(TAG, "Unexpected end state: frames=%lu ch0=%u ch15=%u",
+             (unsigned long)reader.GetFrameIndex(), reader.GetValue(0, 0), reader.GetValue(0, 15));
     return false;
   }
-  ESP_LOGI(TAG, "  Invalid frequency correctly rejected");
-  g_driver->ClearErrorFlags();
 
-  // Verify GetLastError returns something meaningful
-  g_driver->SetPwm(255, 0, 0); // Force an error
-  auto last_err = g_driver->GetLastError();
-  if (last_err == PCA9685Driver::Error::None) {
-    ESP_LOGE(TAG, "GetLastError() returned None after forced error");
+  // Truncated stream must be reported, not played
+  pca9685::MemorySource truncated(sink.data, sink.size / 2);
+  pca9685::FrameStreamReader<pca9685::MemorySource> partial(truncated);
+  if (!partial.Begin()) {
+    ESP_LOGE(TAG, "Truncated stream header rejected");
     return false;
   }
-  g_driver->ClearErrorFlags();
-
-  // After clearing, verify clean state
-  g_driver->SetDuty(0, 0.5f); // Should succeed
-  if (g_driver->HasAnyError()) {
-    ESP_LOGE(TAG, "Error flags set after valid operation");
+  while ((result = partial.Next()) == pca9685::StreamResult::Frame) {
+  }
+  if (result != pca9685::StreamResult::Error) {
+    ESP_LOGE(TAG, "Truncated stream not detected");
     return false;
   }
 
-  ESP_LOGI(TAG, "✅ Error handling tests passed");
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Frame stream tests passed");
   return true;
 }
 
 /**
- * @brief Stress test: rapid consecutive I2C operations
+ * @brief Frame producer for test_frame_scheduler(): toggle channel 0 and commit.
  */
-static bool test_stress_rapid_writes() noexcept {
+static bool scheduler_test_frame(void* context, const pca9685::FrameTick& tick) {
+  auto* frames = static_cast<uint32_t*>(context);
+  *frames += tick.frames;
+  return g_driver->StageDutyTicks(0, (tick.frame % 2 == 0) ? 1024 : 3072) &&
+         g_driver->CommitFrame();
+}
+
+/**
+ * @brief Test the deadline-based frame scheduler
+ */
+static bool test_frame_scheduler() noexcept {
+  ESP_LOGI(TAG, "Testing frame scheduler...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  static constexpr uint32_t PERIOD_US = 5000;
+  static constexpr uint32_t FRAMES = 100;
+  uint32_t produced = 0;
+  pca9685::FrameScheduler<1> scheduler(Esp32Pca9685I2cBus::NowUs,
+                                       Esp32Pca9685I2cBus::SleepUs, PERIOD_US);
+  if (scheduler.AddTask(scheduler_test_frame, &produced, pca9685::OverloadPolicy::Merge) != 0) {
+    ESP_LOGE(TAG, "AddTask() failed");
+    return false;
+  }
+
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  (void)scheduler.Run(FRAMES);
+  const uint32_t elapsed_us = Esp32Pca9685I2cBus::NowUs() - start_us;
+
+  const pca9685::SchedulerStats& stats = scheduler.GetStats();
+  ESP_LOGI(TAG, "  %lu frames in %lu us: %lu missed, %lu overruns, jitter max %lu us",
+           (unsigned long)stats.frames_run, (unsigned long)elapsed_us,
+           (unsigned long)stats.frames_missed, (unsigned long)stats.overruns,
+           (unsigned long)stats.max_jitter_us);
+
+  // Merged frames keep the producer on the timeline; absolute deadlines prevent drift
+  if (produced != FRAMES || stats.frames_run + stats.frames_missed != FRAMES ||
+      stats.task_failures != 0) {
+    ESP_LOGE(TAG, "Producer saw %lu frames", (unsigned long)produced);
+    return false;
+  }
+  if (elapsed_us > (FRAMES * PERIOD_US) + PERIOD_US) {
+    ESP_LOGE(TAG, "Schedule drifted: %lu us for %lu frames", (unsigned long)elapsed_us,
+             (unsigned long)FRAMES);
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Frame scheduler tests passed");
+  return true;
+}
+
+using ArbitratedBus =
+    pca9685::BusArbiter<Esp32Pca9685I2cBus, Esp32Pca9685I2cBus::FreeRtosMutexLock>;
+using ArbitratedDriver = pca9685::PCA9685<ArbitratedBus::Port>;
+
+struct ArbiterWorker {
+  ArbitratedDriver* driver;
+  uint8_t channel;
+  int failures;
+  SemaphoreHandle_t done;
+};
+
+/**
+ * @brief Worker for test_bus_arbiter(): hammer one channel through its own port.
+ */
+static void arbiter_worker_task(void* arg) {
+  auto* worker = static_cast<ArbiterWorker*>(arg);
+  for (int i = 0; i < 200; ++i) {
+    if (!worker->driver->SetPwm(worker->channel, 0, static_cast<uint16_t>((i * 20) & 4095))) {
+      ++worker->failures;
+    }
+  }
+  xSemaphoreGive(worker->done);
+  vTaskDelete(nullptr);
+}
+
+/**
+ * @brief Test two drivers in two tasks sharing the bus through a BusArbiter
+ */
+static bool test_bus_arbiter() noexcept {
+  ESP_LOGI(TAG, "Testing shared-bus arbitration...");
+
+  if (!g_i2c_bus) {
+    ESP_LOGE(TAG, "I2C bus not initialized");
+    return false;
+  }
+
+  ArbitratedBus arbiter(*g_i2c_bus);
+  ArbitratedBus::Port port_a(arbiter);
+  ArbitratedBus::Port port_b(arbiter);
+  ArbitratedDriver driver_a(&port_a, PCA9685_I2C_ADDRESS);
+  ArbitratedDriver driver_b(&port_b, PCA9685_I2C_ADDRESS);
+  if (!driver_a.EnsureInitialized() || !driver_b.EnsureInitialized()) {
+    ESP_LOGE(TAG, "Arbitrated driver initialization failed");
+    return false;
+  }
+
+  ArbiterWorker worker{&driver_b, 1, 0, xSemaphoreCreateBinary()};
+  if (worker.done == nullptr ||
+      xTaskCreate(arbiter_worker_task, "arb_worker", 4096, &worker, 5, nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start worker task");
+    return false;
+  }
+  int failures = 0;
+  for (int i = 0; i < 200; ++i) {
+    if (!driver_a.SetPwm(0, 0, static_cast<uint16_t>((i * 20) & 4095))) {
+      ++failures;
+    }
+  }
+  const bool finished = xSemaphoreTake(worker.done, pdMS_TO_TICKS(5000)) == pdTRUE;
+  vSemaphoreDelete(worker.done);
+  if (!finished) {
+    ESP_LOGE(TAG, "Worker task did not finish");
+    return false;
+  }
+
+  ESP_LOGI(TAG, "  %lu transactions, %lu merged", (unsigned long)arbiter.GetTransactionCount(),
+           (unsigned long)arbiter.GetMergedCount());
+  if (failures != 0 || worker.failures != 0) {
+    ESP_LOGE(TAG, "Arbitrated writes failed: %d / %d", failures, worker.failures);
+    return false;
+  }
+
+  (void)driver_a.SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Bus arbiter tests passed");
+  return true;
+}
+
+struct MailboxProducer {
+  pca9685::FrameMailbox* mailbox;
+  uint32_t frames;
+  SemaphoreHandle_t done;
+};
+
+/**
+ * @brief Producer for test_frame_mailbox(): publish a ramp of complete frames.
+ */
+static void mailbox_producer_task(void* arg) {
+  auto* producer = static_cast<MailboxProducer*>(arg);
+  pca9685::ChannelFrame frame;
+  for (uint32_t i = 1; i <= producer->frames; ++i) {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      frame.ticks[ch] = static_cast<uint16_t>((i * 16 + ch) % 4097);
+    }
+    producer->mailbox->Publish(frame);
+    if ((i % 8) == 0) {
+      vTaskDelay(1);
+    }
+  }
+  xSemaphoreGive(producer->done);
+  vTaskDelete(nullptr);
+}
+
+/**
+ * @brief Test handing frames from a producer task to the bus task through a FrameMailbox
+ */
+static bool test_frame_mailbox() noexcept {
+  ESP_LOGI(TAG, "Testing frame mailbox...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  pca9685::FrameMailbox mailbox;
+  MailboxProducer producer{&mailbox, 256, xSemaphoreCreateBinary()};
+  if (producer.done == nullptr ||
+      xTaskCreate(mailbox_producer_task, "mbx_producer", 4096, &producer, 5, nullptr) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start producer task");
+    return false;
+  }
+
+  // Apply whatever is latest until the producer finishes, then the final frame
+  int failures = 0;
+  bool finished = false;
+  for (int i = 0; i < 5000 && !finished; ++i) {
+    finished = xSemaphoreTake(producer.done, 0) == pdTRUE;
+    if (!mailbox.Apply(*g_driver)) {
+      ++failures;
+    }
+    vTaskDelay(1);
+  }
+  vSemaphoreDelete(producer.done);
+  if (!finished || !mailbox.Apply(*g_driver)) {
+    ESP_LOGE(TAG, "Producer did not finish or final frame failed");
+    return false;
+  }
+
+  const pca9685::ChannelFrame& last = mailbox.Front();
+  ESP_LOGI(TAG, "  %lu frames published, %lu overwritten before being applied",
+           (unsigned long)mailbox.GetPublishCount(), (unsigned long)mailbox.GetOverwrittenCount());
+  if (failures != 0 || last.ticks[0] != (producer.frames * 16) % 4097) {
+    ESP_LOGE(TAG, "Mailbox apply failed (%d failures, ch0 = %u)", failures, last.ticks[0]);
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Frame mailbox tests passed");
+  return true;
+}
+
+using AsyncBus = pca9685::QueuedBusAdapter<Esp32Pca9685I2cBus>;
+using AsyncDriver = pca9685::AsyncPCA9685<AsyncBus>;
+
+/**
+ * @brief Coroutine for test_async_driver(): initialise, then commit a ramp of frames.
+ */
+static pca9685::Task<bool> async_ramp(AsyncDriver& dev, uint16_t frames) noexcept {
+  if (!co_await dev.EnsureInitializedAsync()) {
+    co_return false;
+  }
+  for (uint16_t frame = 0; frame < frames; ++frame) {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      (void)dev.StageDutyTicks(ch, static_cast<uint16_t>((frame * 64 + ch * 16) % 4097));
+    }
+    if (!co_await dev.CommitFrameAsync()) {
+      co_return false;
+    }
+  }
+  co_return co_await dev.SetAllPwmAsync(0, 0);
+}
+
+/**
+ * @brief Test the coroutine front-end over a queued adapter of the blocking bus
+ */
+static bool test_async_driver() noexcept {
+  ESP_LOGI(TAG, "Testing coroutine driver...");
+
+  if (!g_i2c_bus) {
+    ESP_LOGE(TAG, "I2C bus not initialized");
+    return false;
+  }
+
+  AsyncBus bus(*g_i2c_bus);
+  AsyncDriver dev(&bus, PCA9685_I2C_ADDRESS);
+  auto task = async_ramp(dev, 32);
+  task.Start();
+  if (task.IsDone() || bus.IsIdle()) {
+    ESP_LOGE(TAG, "Task should be waiting for its first transfer");
+    return false;
+  }
+
+  size_t transfers = 0;
+  while (!task.IsDone() && transfers < 1000) {
+    transfers += bus.Poll(1);
+  }
+  ESP_LOGI(TAG, "  %u transfers", static_cast<unsigned>(transfers));
+  if (!task.IsDone() || !task.GetResult() || dev.GetErrorFlags() != 0) {
+    ESP_LOGE(TAG, "Async ramp failed (errors 0x%04X)", dev.GetErrorFlags());
+    return false;
+  }
+
+  ESP_LOGI(TAG, "✅ Coroutine driver tests passed");
+  return true;
+}
+
+//=============================================================================
+// ADVANCED TEST CASES
+//=============================================================================
+
+/**
+ * @brief Test SetAllPwm and channel full-on/full-off
+ */
+static bool test_all_channel_control() noexcept {
+  ESP_LOGI(TAG, "Testing all-channel and full-on/off control...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  if (!g_driver->SetPwmFreq(200.0f)) {
+    ESP_LOGE(TAG, "Failed to set frequency");
+    return false;
+  }
+
+  // SetAllPwm: set all channels to 25%
+  if (!g_driver->SetAllPwm(0, 1024)) {
+    ESP_LOGE(TAG, "SetAllPwm(0, 1024) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  // SetAllPwm: set all channels to 75%
+  if (!g_driver->SetAllPwm(0, 3072)) {
+    ESP_LOGE(TAG, "SetAllPwm(0, 3072) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  // SetChannelFullOn / SetChannelFullOff for each channel
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (!g_driver->SetChannelFullOn(ch)) {
+      ESP_LOGE(TAG, "SetChannelFullOn(%d) failed", ch);
+      return false;
+    }
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (!g_driver->SetChannelFullOff(ch)) {
+      ESP_LOGE(TAG, "SetChannelFullOff(%d) failed", ch);
+      return false;
+    }
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  // Return to normal PWM after full-on/off test
+  if (!g_driver->SetAllPwm(0, 0)) {
+    ESP_LOGE(TAG, "Failed to clear all channels");
+    return false;
+  }
+
+  ESP_LOGI(TAG, "✅ All-channel and full-on/off tests passed");
+  return true;
+}
+
+/**
+ * @brief Test prescale readback and frequency boundary values
+ */
+static bool test_prescale_readback() noexcept {
+  ESP_LOGI(TAG, "Testing prescale readback and frequency boundaries...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Test boundary frequencies and verify prescale readback
+  struct FreqTest {
+    float freq_hz;
+    uint8_t expected_prescale; // prescale = round(25MHz / (4096 * freq)) - 1
+  };
+  FreqTest freq_tests[] = {
+      {50.0f, 121}, // 25e6 / (4096 * 50) - 1 = 121.07 -> 121
+      {200.0f, 29}, // 25e6 / (4096 * 200) - 1 = 29.52 -> 30   (approximate)
+      {1000.0f, 5}, // 25e6 / (4096 * 1000) - 1 = 5.10 -> 5
+      {24.0f, 253}, // Min valid frequency
+      {1526.0f, 3}, // Max valid frequency (prescale min = 3)
+  };
+
+  for (const auto& test : freq_tests) {
+    if (!g_driver->SetPwmFreq(test.freq_hz)) {
+      ESP_LOGE(TAG, "Failed to set frequency %.0f Hz", test.freq_hz);
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(5));
+
+    uint8_t prescale = 0;
+    if (!g_driver->GetPrescale(prescale)) {
+      ESP_LOGE(TAG, "Failed to read prescale at %.0f Hz", test.freq_hz);
+      return false;
+    }
+
+    // Allow +/- 1 tolerance for rounding differences
+    int diff = static_cast<int>(prescale) - static_cast<int>(test.expected_prescale);
+    if (diff < -1 || diff > 1) {
+      ESP_LOGE(TAG, "Prescale mismatch at %.0f Hz: got %d, expected %d (±1)", test.freq_hz,
+               prescale, test.expected_prescale);
+      return false;
+    }
+    ESP_LOGI(TAG, "  %.0f Hz -> prescale=%d (expected %d) ✓", test.freq_hz, prescale,
+             test.expected_prescale);
+  }
+
+  // Test out-of-range frequencies (should fail gracefully)
+  if (g_driver->SetPwmFreq(10.0f)) {
+    ESP_LOGW(TAG, "10 Hz was accepted (below 24 Hz min) -- unexpected but not fatal");
+  }
+  g_driver->ClearErrorFlags();
+
+  if (g_driver->SetPwmFreq(2000.0f)) {
+    ESP_LOGW(TAG, "2000 Hz was accepted (above 1526 Hz max) -- unexpected but not fatal");
+  }
+  g_driver->ClearErrorFlags();
+
+  ESP_LOGI(TAG, "✅ Prescale readback and boundary tests passed");
+  return true;
+}
+
+/**
+ * @brief Test clock-source aware prescale math (calibrated oscillator, EXTCLK)
+ */
+static bool test_clock_source() noexcept {
+  ESP_LOGI(TAG, "Testing clock source configuration...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  // A 26 MHz calibration changes the 50 Hz prescale from 121 to 126
+  g_driver->SetOscillatorHz(26000000);
+  uint8_t prescale = 0;
+  if (!g_driver->SetPwmFreq(50.0F) || !g_driver->GetPrescale(prescale) || prescale != 126) {
+    ESP_LOGE(TAG, "Calibrated prescale: got %d, expected 126", prescale);
+    g_driver->SetOscillatorHz(PCA9685Driver::OSC_FREQ_);
+    return false;
+  }
+  ESP_LOGI(TAG, "  26 MHz calibration: 50 Hz -> prescale=%d, range %.1f-%.1f Hz ✓", prescale,
+           g_driver->GetMinPwmFreq(), g_driver->GetMaxPwmFreq());
+
+  if (g_driver->EnableExternalClock(PCA9685Driver::MAX_EXT_CLOCK_HZ_ + 1) ||
+      !g_driver->HasError(PCA9685Driver::Error::OutOfRange) || g_driver->IsExternalClock()) {
+    ESP_LOGE(TAG, "EXTCLK above 50 MHz should be rejected without touching the device");
+    return false;
+  }
+  g_driver->ClearErrorFlags();
+
+  if constexpr (PCA9685_EXTCLK_HZ != 0) {
+    if (!g_driver->EnableExternalClock(PCA9685_EXTCLK_HZ)) {
+      ESP_LOGE(TAG, "EXTCLK switch failed");
+      return false;
+    }
+    const float max_hz = g_driver->GetMaxPwmFreq(); // Prescale 3: the fastest setting
+    if (!g_driver->SetPwmFreq(max_hz) || !g_driver->GetPrescale(prescale) || prescale != 3) {
+      ESP_LOGE(TAG, "EXTCLK at %lu Hz: %.0f Hz failed (prescale %d)",
+               (unsigned long)PCA9685_EXTCLK_HZ, max_hz, prescale);
+      return false;
+    }
+    ESP_LOGI(TAG, "  EXTCLK %lu Hz: %.0f Hz PWM ✓", (unsigned long)PCA9685_EXTCLK_HZ, max_hz);
+  } else {
+    g_driver->SetOscillatorHz(PCA9685Driver::OSC_FREQ_);
+    ESP_LOGI(TAG, "  No clock on EXTCLK (PCA9685_EXTCLK_HZ = 0): switch skipped");
+  }
+
+  if (!g_driver->SetPwmFreq(50.0F)) {
+    ESP_LOGE(TAG, "Failed to return to 50 Hz");
+    return false;
+  }
+  ESP_LOGI(TAG, "✅ Clock source tests passed");
+  return true;
+}
+
+/**
+ * @brief Test the non-blocking frequency switch and its deferred RESTART
+ */
+static bool test_fast_frequency_switch() noexcept {
+  ESP_LOGI(TAG, "Testing fast frequency switching...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  PCA9685Driver pwm(g_i2c_bus.get(), PCA9685_I2C_ADDRESS);
+  pwm.SetClock(Esp32Pca9685I2cBus::NowUs);
+  if (!pwm.EnsureInitialized() || !pwm.SetPwmFreq(50.0F) || !pwm.SetPwm(0, 0, 2048)) {
+    ESP_LOGE(TAG, "Setup failed");
+    return false;
+  }
+
+  // Servo -> LED -> servo, servicing the RESTART from a polling loop
+  const float freqs[] = {1000.0F, 50.0F};
+  const uint8_t prescales[] = {5, 121};
+  for (size_t i = 0; i < 2; ++i) {
+    const uint32_t start = Esp32Pca9685I2cBus::NowUs();
+    if (!pwm.SetPwmFreqFast(freqs[i])) {
+      ESP_LOGE(TAG, "SetPwmFreqFast(%.0f) failed", freqs[i]);
+      return false;
+    }
+    const uint32_t switched = Esp32Pca9685I2cBus::NowUs();
+    uint32_t polls = 0;
+    while (pwm.IsRestartPending()) {
+      if (!pwm.ServiceRestart()) {
+        ESP_LOGE(TAG, "ServiceRestart failed");
+        return false;
+      }
+      ++polls;
+    }
+    const uint32_t restarted = Esp32Pca9685I2cBus::NowUs();
+    uint8_t prescale = 0;
+    if (!pwm.GetPrescale(prescale) || prescale != prescales[i] ||
+        restarted - switched < PCA9685Driver::OSC_SETTLE_US_ - 1) {
+      ESP_LOGE(TAG, "%.0f Hz: prescale %d (expected %d), restart after %lu us", freqs[i],
+               prescale, prescales[i], (unsigned long)(restarted - switched));
+      return false;
+    }
+    ESP_LOGI(TAG, "  %.0f Hz: switch %lu us (caller free), RESTART after %lu us, %lu polls ✓",
+             freqs[i], (unsigned long)(switched - start), (unsigned long)(restarted - switched),
+             (unsigned long)polls);
+  }
+
+  // Keep the shared driver's caches in step with the device
+  if (!g_driver->SetPwmFreq(50.0F) || !g_driver->SetAllPwm(0, 0)) {
+    ESP_LOGE(TAG, "Failed to restore the shared driver state");
+    return false;
+  }
+  ESP_LOGI(TAG, "✅ Fast frequency switch tests passed");
+  return true;
+}
+
+/**
+ * @brief Test sleep/wake power management
+ */
+static bool test_sleep_wake() noexcept {
+  ESP_LOGI(TAG, "Testing sleep/wake power management...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Set up a known PWM state before sleep
+  if (!g_driver->SetPwmFreq(100.0f)) {
+    ESP_LOGE(TAG, "Failed to set frequency before sleep test");
+    return false;
+  }
+  if (!g_driver->SetDuty(0, 0.5f)) {
+    ESP_LOGE(TAG, "Failed to set duty before sleep");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  // Enter sleep
+  if (!g_driver->Sleep()) {
+    ESP_LOGE(TAG, "Sleep() failed");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Device in sleep mode");
+  vTaskDelay(pdMS_TO_TICKS(50));
+
+  // Wake and verify device is responsive
+  if (!g_driver->Wake()) {
+    ESP_LOGE(TAG, "Wake() failed");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Device woke up");
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  // Verify device is functional after wake: set PWM on all channels
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (!g_driver->SetDuty(ch, 0.25f)) {
+      ESP_LOGE(TAG, "Failed to set duty on ch %d after wake", ch);
+      return false;
+    }
+  }
+
+  // Multiple sleep/wake cycles
+  for (int cycle = 0; cycle < 5; ++cycle) {
+    if (!g_driver->Sleep()) {
+      ESP_LOGE(TAG, "Sleep() failed on cycle %d", cycle);
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+    if (!g_driver->Wake()) {
+      ESP_LOGE(TAG, "Wake() failed on cycle %d", cycle);
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+
+  ESP_LOGI(TAG, "✅ Sleep/wake tests passed (5 cycles)");
+  return true;
+}
+
+/**
+ * @brief Test non-blocking wake: ready-at time, queued channel writes, timed RESTART
+ */
+static bool test_wake_async() noexcept {
+  ESP_LOGI(TAG, "Testing non-blocking wake...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  using PowerState = PCA9685Driver::PowerState;
+  PCA9685Driver pwm(g_i2c_bus.get(), PCA9685_I2C_ADDRESS);
+  pwm.SetClock(Esp32Pca9685I2cBus::NowUs);
+  if (!pwm.EnsureInitialized() || !pwm.SetPwm(0, 0, 2048) || !pwm.Sleep() ||
+      pwm.GetPowerState() != PowerState::Asleep) {
+    ESP_LOGE(TAG, "Setup failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(10));
+
+  const uint32_t start = Esp32Pca9685I2cBus::NowUs();
+  if (!pwm.WakeAsync() || pwm.GetPowerState() != PowerState::Settling) {
+    ESP_LOGE(TAG, "WakeAsync failed");
+    return false;
+  }
+  const uint32_t returned = Esp32Pca9685I2cBus::NowUs();
+  // Queued until the RESTART: no bus traffic, so the held outputs are not released early
+  if (!pwm.SetPwm(1, 0, 1024) || !pwm.SetDuty(2, 0.75F)) {
+    ESP_LOGE(TAG, "Writes while settling should be queued");
+    return false;
+  }
+  uint32_t polls = 0;
+  while (pwm.GetPowerState() == PowerState::Settling) {
+    if (!pwm.ServiceRestart()) {
+      ESP_LOGE(TAG, "ServiceRestart failed");
+      return false;
+    }
+    ++polls;
+  }
+  const uint32_t ready = Esp32Pca9685I2cBus::NowUs();
+  uint16_t mismatch = 0;
+  if (ready - returned < PCA9685Driver::OSC_SETTLE_US_ - 1 || !pwm.Verify(mismatch) ||
+      mismatch != 0) {
+    ESP_LOGE(TAG, "Restart after %lu us, mismatch 0x%04X", (unsigned long)(ready - returned),
+             mismatch);
+    return false;
+  }
+  ESP_LOGI(TAG, "  WakeAsync returned in %lu us, awake after %lu us (%lu polls) ✓",
+           (unsigned long)(returned - start), (unsigned long)(ready - start),
+           (unsigned long)polls);
+
+  (void)g_driver->SetAllPwm(0, 0); // Rewrite through the shared driver's shadow image
+  ESP_LOGI(TAG, "✅ Non-blocking wake tests passed");
+  return true;
+}
+
+/**
+ * @brief Test the idle-sleep power policy: sleep after the timeout, wake on a channel write
+ */
+static bool test_idle_power_policy() noexcept {
+  ESP_LOGI(TAG, "Testing idle-sleep power policy...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  constexpr uint32_t IDLE_TIMEOUT_US = 20000;
+  using PowerState = PCA9685Driver::PowerState;
+  PCA9685Driver pwm(g_i2c_bus.get(), PCA9685_I2C_ADDRESS);
+  pwm.SetClock(Esp32Pca9685I2cBus::NowUs);
+  pca9685::PowerPolicy::Config cfg;
+  cfg.idle_timeout_us = IDLE_TIMEOUT_US;
+  pwm.SetPowerPolicy(cfg);
+  if (!pwm.EnsureInitialized() || !pwm.SetAllPwm(0, 0) || !pwm.GetPowerPolicy().IsIdle()) {
+    ESP_LOGE(TAG, "Setup failed");
+    return false;
+  }
+
+  if (!pwm.ServicePowerPolicy() || pwm.GetPowerState() != PowerState::Awake) {
+    ESP_LOGE(TAG, "Slept before the idle timeout");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(30));
+  if (!pwm.ServicePowerPolicy() || pwm.GetPowerState() != PowerState::Asleep) {
+    ESP_LOGE(TAG, "Idle device not put to sleep");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(50));
+
+  // An application write turns a channel on: the driver wakes the device first
+  if (!pwm.SetPwm(0, 0, 2048) || pwm.GetPowerState() != PowerState::Awake) {
+    ESP_LOGE(TAG, "Channel write did not wake the device");
+    return false;
+  }
+  uint16_t mismatch = 0;
+  if (!pwm.Verify(mismatch) || mismatch != 0) {
+    ESP_LOGE(TAG, "Channel mismatch 0x%04X after wake", mismatch);
+    return false;
+  }
+  const auto& policy = pwm.GetPowerPolicy();
+  const uint64_t asleep_us = policy.GetAsleepUs(Esp32Pca9685I2cBus::NowUs());
+  if (policy.GetSleepCount() != 1 || policy.GetWakeCount() != 1 || asleep_us < 40000) {
+    ESP_LOGE(TAG, "Metrics: %lu sleeps, %lu wakes, %llu us asleep",
+             (unsigned long)policy.GetSleepCount(), (unsigned long)policy.GetWakeCount(),
+             (unsigned long long)asleep_us);
+    return false;
+  }
+  ESP_LOGI(TAG, "  Asleep %llu us, woken by a channel write ✓", (unsigned long long)asleep_us);
+
+  (void)g_driver->SetAllPwm(0, 0); // Rewrite through the shared driver's shadow image
+  ESP_LOGI(TAG, "✅ Idle power policy tests passed");
+  return true;
+}
+
+/**
+ * @brief Test brown-out detection and fast state restore
+ *
+ * Emulates a power loss by writing the power-on defaults (MODE1 = SLEEP|ALLCALL,
+ * PRE_SCALE = 0x1E) behind the driver's back, then checks that VerifyAndRestore()
+ * detects it and replays the cached configuration.
+ */
+static bool test_state_restore() noexcept {
+  ESP_LOGI(TAG, "Testing brown-out detection and state restore...");
+
+  if (!g_driver || !g_i2c_bus) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  if (!g_driver->SetPwmFreq(200.0f) || !g_driver->SetPwm(0, 0, 1024)) {
+    ESP_LOGE(TAG, "Failed to set up known state");
+    return false;
+  }
+  uint8_t expected_prescale = 0;
+  if (!g_driver->GetPrescale(expected_prescale)) {
+    ESP_LOGE(TAG, "Failed to read prescale");
+    return false;
+  }
+
+  // Consistent device: verification must not rewrite anything
+  const uint32_t restores_before = g_driver->GetRestoreCount();
+  if (!g_driver->VerifyAndRestore() || g_driver->GetRestoreCount() != restores_before) {
+    ESP_LOGE(TAG, "VerifyAndRestore() restored a consistent device");
+    return false;
+  }
+
+  // Emulate power-on defaults
+  const uint8_t por_mode1 = 0x11;
+  const uint8_t por_prescale = 0x1E;
+  if (!g_i2c_bus->Write(PCA9685_I2C_ADDRESS, 0x00, &por_mode1, 1) ||
+      !g_i2c_bus->Write(PCA9685_I2C_ADDRESS, 0xFE, &por_prescale, 1)) {
+    ESP_LOGE(TAG, "Failed to emulate power loss");
+    return false;
+  }
+
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  if (!g_driver->VerifyAndRestore()) {
+    ESP_LOGE(TAG, "VerifyAndRestore() failed");
+    return false;
+  }
+  const uint32_t restore_us = Esp32Pca9685I2cBus::NowUs() - start_us;
+  if (g_driver->GetRestoreCount() != restores_before + 1) {
+    ESP_LOGE(TAG, "Power loss not detected");
+    return false;
+  }
+
+  uint8_t prescale = 0;
+  if (!g_driver->GetPrescale(prescale) || prescale != expected_prescale) {
+    ESP_LOGE(TAG, "Prescale not restored: got %d, expected %d", prescale, expected_prescale);
+    return false;
+  }
+  ESP_LOGI(TAG, "  Detected and restored in %lu us", (unsigned long)restore_us);
+
+  ESP_LOGI(TAG, "✅ State restore tests passed");
+  return true;
+}
+
+/**
+ * @brief Test bulk channel readback and Verify() against the shadow image
+ */
+static bool test_channel_verify() noexcept {
+  ESP_LOGI(TAG, "Testing channel readback and verification...");
+
+  if (!g_driver || !g_i2c_bus) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    (void)g_driver->StagePwm(ch, 0, static_cast<uint16_t>(ch * 200));
+  }
+  if (!g_driver->CommitFrame()) {
+    ESP_LOGE(TAG, "Failed to write known channel values");
+    return false;
+  }
+
+  std::array<PCA9685Driver::ChannelValue, 16> values{};
+  if (!g_driver->ReadAllChannels(values)) {
+    ESP_LOGE(TAG, "ReadAllChannels() failed");
+    return false;
+  }
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (values[ch].on_time != 0 || values[ch].off_time != ch * 200) {
+      ESP_LOGE(TAG, "Channel %d read back %u/%u", ch, values[ch].on_time, values[ch].off_time);
+      return false;
+    }
+  }
+
+  uint16_t mismatch = 0xFFFF;
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  if (!g_driver->Verify(mismatch) || mismatch != 0) {
+    ESP_LOGE(TAG, "Verify() of a consistent device reported 0x%04X", mismatch);
+    return false;
+  }
+  ESP_LOGI(TAG, "  Verified 16 channels in %lu us",
+           (unsigned long)(Esp32Pca9685I2cBus::NowUs() - start_us));
+
+  // Change channel 5 behind the driver's back
+  const std::array<uint8_t, 4> corrupt = {0x00, 0x00, 0x34, 0x02};
+  if (!g_i2c_bus->Write(PCA9685_I2C_ADDRESS, 0x06 + (4 * 5), corrupt.data(), corrupt.size()) ||
+      !g_driver->Verify(mismatch) || mismatch != (1U << 5)) {
+    ESP_LOGE(TAG, "Verify() missed the corrupted channel (0x%04X)", mismatch);
+    return false;
+  }
+  if (!g_driver->RestoreState() || !g_driver->Verify(mismatch) || mismatch != 0) {
+    ESP_LOGE(TAG, "RestoreState() did not repair the channel (0x%04X)", mismatch);
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0);
+  ESP_LOGI(TAG, "✅ Channel verification tests passed");
+  return true;
+}
+
+/**
+ * @brief Test output configuration (invert, driver mode)
+ */
+static bool test_output_config() noexcept {
+  ESP_LOGI(TAG, "Testing output configuration...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  // Test output invert toggle
+  if (!g_driver->SetOutputInvert(true)) {
+    ESP_LOGE(TAG, "SetOutputInvert(true) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(5));
+
+  if (!g_driver->SetOutputInvert(false)) {
+    ESP_LOGE(TAG, "SetOutputInvert(false) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(5));
+
+  // Test output driver mode
+  if (!g_driver->SetOutputDriverMode(true)) { // totem-pole
+    ESP_LOGE(TAG, "SetOutputDriverMode(totem-pole) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(5));
+
+  if (!g_driver->SetOutputDriverMode(false)) { // open-drain
+    ESP_LOGE(TAG, "SetOutputDriverMode(open-drain) failed");
+    return false;
+  }
+  vTaskDelay(pdMS_TO_TICKS(5));
+
+  // Restore default (totem-pole)
+  if (!g_driver->SetOutputDriverMode(true)) {
+    ESP_LOGE(TAG, "Failed to restore totem-pole mode");
+    return false;
+  }
+
+  ESP_LOGI(TAG, "✅ Output configuration tests passed");
+  return true;
+}
+
+/**
+ * @brief Test error flag management
+ */
+static bool test_error_handling() noexcept {
+  ESP_LOGI(TAG, "Testing error flag management...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  // After successful operations, no errors should be set
+  g_driver->ClearErrorFlags();
+  if (g_driver->HasAnyError()) {
+    ESP_LOGE(TAG, "Error flags not cleared");
+    return false;
+  }
+
+  // Trigger an out-of-range error: channel 255 is invalid
+  bool result = g_driver->SetPwm(255, 0, 2048);
+  if (result) {
+    ESP_LOGE(TAG, "SetPwm(255,...) should have failed");
+    return false;
+  }
+  if (!g_driver->HasError(PCA9685Driver::Error::OutOfRange)) {
+    ESP_LOGE(TAG, "Expected OutOfRange error flag after invalid channel");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Invalid channel correctly rejected with OutOfRange error");
+
+  // Clear and verify
+  g_driver->ClearError(PCA9685Driver::Error::OutOfRange);
+  if (g_driver->HasError(PCA9685Driver::Error::OutOfRange)) {
+    ESP_LOGE(TAG, "OutOfRange flag not cleared");
+    return false;
+  }
+
+  // Trigger out-of-range PWM value
+  result = g_driver->SetPwm(0, 5000, 0);
+  if (result) {
+    ESP_LOGE(TAG, "SetPwm(0, 5000, 0) should have failed (on > 4095)");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Invalid PWM value correctly rejected");
+  g_driver->ClearErrorFlags();
+
+  // Trigger out-of-range frequency
+  result = g_driver->SetPwmFreq(5.0f);
+  if (result) {
+    ESP_LOGE(TAG, "SetPwmFreq(5.0) should have failed (below 24 Hz)");
+    return false;
+  }
+  ESP_LOGI(TAG, "  Invalid frequency correctly rejected");
+  g_driver->ClearErrorFlags();
+
+  // Verify GetLastError returns something meaningful
+  g_driver->SetPwm(255, 0, 0); // Force an error
+  auto last_err = g_driver->GetLastError();
+  if (last_err == PCA9685Driver::Error::None) {
+    ESP_LOGE(TAG, "GetLastError() returned None after forced error");
+    return false;
+  }
+  g_driver->ClearErrorFlags();
+
+  // After clearing, verify clean state
+  g_driver->SetDuty(0, 0.5f); // Should succeed
+  if (g_driver->HasAnyError()) {
+    ESP_LOGE(TAG, "Error flags set after valid operation");
+    return false;
+  }
+
+  ESP_LOGI(TAG, "✅ Error handling tests passed");
+  return true;
+}
+
+/**
+ * @brief Test retry policy backoff, frame budget and offline fast-fail
+ *
+ * Uses a second driver instance pointed at an unused address so every
+ * transfer NACKs, then checks that the policy limits retries as configured.
+ */
+static bool test_retry_policy() noexcept {
+  ESP_LOGI(TAG, "Testing retry policy (backoff, frame budget, offline fast-fail)...");
+
+  if (!g_i2c_bus) {
+    ESP_LOGE(TAG, "I2C bus not initialized");
+    return false;
+  }
+
+  static constexpr uint8_t ABSENT_ADDRESS = 0x7E;
+  PCA9685Driver ghost(g_i2c_bus.get(), ABSENT_ADDRESS);
+
+  pca9685::RetryPolicy::Config cfg;
+  cfg.max_retries = 3;
+  cfg.base_delay_us = 100; // 100, 200, 400 us
+  cfg.jitter_percent = 25;
+  cfg.frame_retry_budget = 4;
+  cfg.offline_threshold = 2;
+  ghost.SetRetryPolicy(cfg);
+  ghost.SetRetryDelayUs(Esp32Pca9685I2cBus::RetryDelayUs);
+  ghost.GetRetryPolicy().Seed(ABSENT_ADDRESS);
+
+  // First transfer: 3 retries consume 3 of the 4-retry frame budget
+  ghost.BeginFrame();
+  if (ghost.Reset()) {
+    ESP_LOGE(TAG, "Reset() at absent address 0x%02X unexpectedly succeeded", ABSENT_ADDRESS);
+    return false;
+  }
+  // Second transfer: only 1 retry left in the frame budget
+  (void)ghost.Reset();
+  const auto& stats = ghost.GetRetryPolicy().GetStats();
+  if (stats.retries != 4 || stats.budget_exhausted != 1) {
+    ESP_LOGE(TAG, "Frame budget not enforced: retries=%lu exhausted=%lu",
+             (unsigned long)stats.retries, (unsigned long)stats.budget_exhausted);
+    return false;
+  }
+
+  // Two consecutive failures -> offline: next transfer gets a single attempt
+  ghost.BeginFrame();
+  if (!ghost.GetRetryPolicy().IsOffline()) {
+    ESP_LOGE(TAG, "Device not marked offline after %d failures", cfg.offline_threshold);
+    return false;
+  }
+  (void)ghost.Reset();
+  if (stats.fast_fails != 1 || stats.retries != 4) {
+    ESP_LOGE(TAG, "Offline fast-fail not applied: fast_fails=%lu retries=%lu",
+             (unsigned long)stats.fast_fails, (unsigned long)stats.retries);
+    return false;
+  }
+  ESP_LOGI(TAG, "  retries=%lu budget_exhausted=%lu fast_fails=%lu failed_transfers=%lu",
+           (unsigned long)stats.retries, (unsigned long)stats.budget_exhausted,
+           (unsigned long)stats.fast_fails, (unsigned long)stats.failed_transfers);
+
+  ESP_LOGI(TAG, "✅ Retry policy tests passed");
+  return true;
+}
+
+/**
+ * @brief Test device health tracking and the circuit breaker
+ *
+ * A driver pointed at an unused address trips the breaker, after which
+ * operations are skipped without bus traffic until the cool-down expires.
+ */
+static bool test_circuit_breaker() noexcept {
+  ESP_LOGI(TAG, "Testing device health tracking and circuit breaker...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  static constexpr uint8_t ABSENT_ADDRESS = 0x7E;
+  static constexpr uint32_t COOLDOWN_US = 50000;
+  PCA9685Driver ghost(g_i2c_bus.get(), ABSENT_ADDRESS);
+  ghost.SetClock(Esp32Pca9685I2cBus::NowUs);
+  ghost.SetRetries(1);
+  ghost.SetCircuitBreaker({2, COOLDOWN_US});
+
+  (void)ghost.Reset();
+  (void)ghost.Reset();
+  const auto& health = ghost.GetHealth();
+  if (health.GetState() != pca9685::DeviceHealth::State::Open || health.GetTripCount() != 1) {
+    ESP_LOGE(TAG, "Breaker did not open after 2 consecutive failures");
+    return false;
+  }
+
+  // While open, operations fail immediately with DeviceNotFound and no bus traffic
+  const uint32_t start_us = Esp32Pca9685I2cBus::NowUs();
+  for (int i = 0; i < 10; ++i) {
+    (void)ghost.Reset();
+  }
+  const uint32_t skipped_us = Esp32Pca9685I2cBus::NowUs() - start_us;
+  if (health.GetSkippedCount() != 10 || !ghost.HasError(PCA9685Driver::Error::DeviceNotFound)) {
+    ESP_LOGE(TAG, "Open breaker did not skip operations (skipped=%lu)",
+             (unsigned long)health.GetSkippedCount());
+    return false;
+  }
+  ESP_LOGI(TAG, "  10 skipped operations took %lu us", (unsigned long)skipped_us);
+
+  // After the cool-down the next operation probes the device (and fails again)
+  vTaskDelay(pdMS_TO_TICKS(COOLDOWN_US / 1000 + 10));
+  (void)ghost.Reset();
+  if (health.GetProbeCount() != 1 || health.GetState() != pca9685::DeviceHealth::State::Open) {
+    ESP_LOGE(TAG, "Expected one failed probe after cool-down (probes=%lu)",
+             (unsigned long)health.GetProbeCount());
+    return false;
+  }
+
+  // The real device answers a probe
+  if (!g_driver->ProbeDevice()) {
+    ESP_LOGE(TAG, "ProbeDevice() failed on the real PCA9685");
+    return false;
+  }
+
+  ESP_LOGI(TAG, "✅ Circuit breaker tests passed");
+  return true;
+}
+
+/**
+ * @brief Test retries against injected bus faults on the real bus
+ *
+ * Wraps the bus in a FaultInjectingBus with a 5 % NACK rate and bursts of two, then
+ * checks that the default retries hide every fault and reports the latency cost.
+ */
+static bool test_fault_injection() noexcept {
+  ESP_LOGI(TAG, "Testing retries under injected bus faults...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  using FaultyBus = pca9685::FaultInjectingBus<Esp32Pca9685I2cBus>;
+  FaultyBus faulty(*g_i2c_bus);
+  FaultyBus::Config cfg;
+  cfg.nack_ppm = 50000; // 5 %
+  cfg.burst_length = 2;
+  cfg.timeout_ppm = 2000;
+  cfg.timeout_us = 500;
+  faulty.Configure(cfg);
+  faulty.Seed(0x9685);
+  faulty.SetDelayUs(Esp32Pca9685I2cBus::RetryDelayUs); // Timeouts cost real time
+
+  pca9685::PCA9685<FaultyBus> pwm(&faulty, PCA9685_I2C_ADDRESS);
+  pwm.SetClock(Esp32Pca9685I2cBus::NowUs);
+  if (!pwm.EnsureInitialized()) {
+    ESP_LOGE(TAG, "Initialisation through the fault injector failed");
+    return false;
+  }
+  pwm.ResetLatencyHistograms();
+
+  static constexpr uint16_t CALLS = 500;
+  uint16_t ok = 0;
+  for (uint16_t i = 0; i < CALLS; ++i) {
+    ok += pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, static_cast<uint16_t>(i * 8)) ? 1 : 0;
+  }
+  const auto& stats = faulty.GetStats();
+  const auto& latency = pwm.GetLatencyHistogram(pca9685::PCA9685<FaultyBus>::Operation::SetPwm);
+  ESP_LOGI(TAG, "  %u/%u calls ok, %lu transfers, %lu NACKs, %lu timeouts, p50 %lu us, p99 %lu us",
+           ok, CALLS, (unsigned long)stats.transfers, (unsigned long)stats.nacks,
+           (unsigned long)stats.timeouts, (unsigned long)latency.GetPercentileUs(50),
+           (unsigned long)latency.GetPercentileUs(99));
+  if (ok != CALLS || faulty.GetInjectedCount() == 0) {
+    ESP_LOGE(TAG, "Retries did not absorb the injected faults");
+    return false;
+  }
+
+  // The device must hold exactly what the driver believes it wrote
+  faulty.Configure(FaultyBus::Config{});
+  uint16_t mismatch = 0;
+  if (!pwm.Verify(mismatch) || mismatch != 0) {
+    ESP_LOGE(TAG, "Device differs from the shadow image (mask 0x%04X)", mismatch);
+    return false;
+  }
+  (void)g_driver->SetAllPwm(0, 0); // Rewrite through the shared driver's shadow image
+
+  ESP_LOGI(TAG, "✅ Fault injection tests passed");
+  return true;
+}
+
+/**
+ * @brief Sink that accumulates a trace dump in memory (test_trace_recorder()).
+ */
+struct TraceBufferSink {
+  std::array<uint8_t, 2048> bytes{};
+  size_t size = 0;
+  bool Write(const uint8_t* data, size_t len) noexcept {
+    if (len > bytes.size() - size) {
+      return false;
+    }
+    std::memcpy(bytes.data() + size, data, len);
+    size += len;
+    return true;
+  }
+};
+
+/**
+ * @brief Test recording bus traffic and replaying the dump onto the device
+ */
+static bool test_trace_recorder() noexcept {
+  ESP_LOGI(TAG, "Testing bus trace recorder...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  using Recorder = pca9685::TraceRecorder<Esp32Pca9685I2cBus, 1024>;
+  static Recorder recorder(*g_i2c_bus); // 1 KiB ring: keep it off the task stack
+  recorder.Clear();
+  recorder.SetClock(Esp32Pca9685I2cBus::NowUs);
+  pca9685::PCA9685<Recorder> pwm(&recorder, PCA9685_I2C_ADDRESS);
+  bool ok = pwm.EnsureInitialized();
+  for (uint16_t i = 0; i < 100 && ok; ++i) {
+    ok = pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, static_cast<uint16_t>(i * 40));
+  }
+  if (!ok) {
+    ESP_LOGE(TAG, "Workload through the recorder failed");
+    return false;
+  }
+  recorder.SetEnabled(false);
+  ESP_LOGI(TAG, "  %lu records held, %lu dropped, dump %u bytes",
+           (unsigned long)recorder.GetRecordCount(), (unsigned long)recorder.GetDroppedCount(),
+           (unsigned)recorder.GetDumpSize());
+  // 100 writes of 12-byte records overflow the 1 KiB ring
+  if (recorder.GetDroppedCount() == 0 || recorder.GetRecordCount() == 0) {
+    ESP_LOGE(TAG, "Ring did not wrap as expected");
+    return false;
+  }
+
+  static TraceBufferSink sink;
+  sink.size = 0;
+  if (!recorder.Dump(sink)) {
+    ESP_LOGE(TAG, "Dump did not fit the buffer");
+    return false;
+  }
+  pca9685::TraceReader reader(sink.bytes.data(), sink.size);
+  pca9685::ReplayOptions options;
+  options.compare_reads = false; // The live device may have moved on since recording
+  pca9685::ReplayStats stats;
+  if (!pca9685::ReplayTrace(reader, *g_i2c_bus, options, stats) ||
+      stats.writes != recorder.GetRecordCount()) {
+    ESP_LOGE(TAG, "Replay failed: %lu writes, %lu failed", (unsigned long)stats.writes,
+             (unsigned long)stats.failed);
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0); // Rewrite through the shared driver's shadow image
+  ESP_LOGI(TAG, "✅ Trace recorder tests passed");
+  return true;
+}
+
+/**
+ * @brief Test bus utilisation accounting with a paced channel-write workload
+ */
+static bool test_bus_monitor() noexcept {
+  ESP_LOGI(TAG, "Testing bus occupancy monitor...");
+
+  if (!g_i2c_bus || !g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  using Monitor = pca9685::BusMonitor<Esp32Pca9685I2cBus>;
+  Monitor monitor(*g_i2c_bus);
+  Monitor::Config cfg;
+  cfg.bus_hz = g_i2c_bus->GetConfig().frequency;
+  cfg.window_us = 100000; // 100 ms windows keep the test short
+  monitor.Configure(cfg);
+  monitor.SetClock(Esp32Pca9685I2cBus::NowUs);
+  pca9685::PCA9685<Monitor> pwm(&monitor, PCA9685_I2C_ADDRESS);
+  if (!pwm.EnsureInitialized()) {
+    ESP_LOGE(TAG, "Init through the monitor failed");
+    return false;
+  }
+
+  // ~350 ms of single-channel writes, one per millisecond
+  for (uint16_t i = 0; i < 350; ++i) {
+    if (!pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, static_cast<uint16_t>(i * 10))) {
+      ESP_LOGE(TAG, "SetPwm through the monitor failed");
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  monitor.Update();
+  const auto* device = monitor.FindDevice(PCA9685_I2C_ADDRESS);
+  ESP_LOGI(TAG, "  %lu windows, last %.1f %%, peak %.1f %%, %lu transfers to 0x%02X",
+           (unsigned long)monitor.GetWindowCount(), monitor.GetUtilisationPercent(),
+           monitor.GetPeakUtilisationPercent(),
+           (unsigned long)(device != nullptr ? device->transfers : 0), PCA9685_I2C_ADDRESS);
+  if (monitor.GetWindowCount() < 2 || device == nullptr ||
+      monitor.GetPeakUtilisationPercent() <= 0.0F ||
+      monitor.GetPeakUtilisationPercent() >= 100.0F) {
+    ESP_LOGE(TAG, "Unexpected utilisation figures");
+    return false;
+  }
+
+  pca9685::FrameDemand demand;
+  demand.devices = 16;
+  demand.frame_hz = 1000.0F;
+  ESP_LOGI(TAG, "  16 boards x 1 kHz would need %.0f %% of the bus (max %.0f Hz)",
+           monitor.ProjectUtilisationPercent(demand), monitor.MaxFrameRateHz(16, 16));
+  if (monitor.CheckDemand(demand)) {
+    ESP_LOGE(TAG, "Over-capacity demand not reported");
+    return false;
+  }
+
+  (void)g_driver->SetAllPwm(0, 0); // Rewrite through the shared driver's shadow image
+  ESP_LOGI(TAG, "✅ Bus monitor tests passed");
+  return true;
+}
+
+/**
+ * @brief Stress test: rapid consecutive I2C operations
+ */
+static bool test_stress_rapid_writes() noexcept {
   ESP_LOGI(TAG, "Stress testing: rapid consecutive writes...");
 
   if (!g_driver) {
@@ -816,6 +2147,59 @@ static bool test_stress_boundary_values() noexcept {
   return true;
 }
 
+/**
+ * @brief Test per-operation latency histograms with the esp_timer clock
+ */
+static bool test_latency_histograms() noexcept {
+  ESP_LOGI(TAG, "Testing per-operation latency histograms...");
+
+  if (!g_driver) {
+    ESP_LOGE(TAG, "Driver not initialized");
+    return false;
+  }
+
+  g_driver->SetClock(Esp32Pca9685I2cBus::NowUs);
+  g_driver->ResetLatencyHistograms();
+
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    if (!g_driver->SetPwm(ch, 0, 1024)) {
+      ESP_LOGE(TAG, "SetPwm(%d) failed during latency test", ch);
+      return false;
+    }
+  }
+  if (!g_driver->SetAllPwm(0, 0) || !g_driver->SetPwmFreq(200.0f) || !g_driver->Wake()) {
+    ESP_LOGE(TAG, "Burst/frequency/wake operation failed during latency test");
+    return false;
+  }
+
+  struct OpCheck {
+    PCA9685Driver::Operation op;
+    const char* name;
+    uint32_t expected_count;
+  };
+  const OpCheck checks[] = {
+      {PCA9685Driver::Operation::SetPwm, "SetPwm", 16},
+      {PCA9685Driver::Operation::Burst, "Burst", 1},
+      {PCA9685Driver::Operation::SetPwmFreq, "SetPwmFreq", 1},
+      {PCA9685Driver::Operation::Wake, "Wake", 1},
+  };
+  for (const auto& check : checks) {
+    const auto& histogram = g_driver->GetLatencyHistogram(check.op);
+    if (histogram.GetCount() != check.expected_count) {
+      ESP_LOGE(TAG, "%s histogram count %lu, expected %lu", check.name,
+               (unsigned long)histogram.GetCount(), (unsigned long)check.expected_count);
+      return false;
+    }
+    ESP_LOGI(TAG, "  %-10s n=%lu p50<=%lu us p99<=%lu us max=%lu us", check.name,
+             (unsigned long)histogram.GetCount(), (unsigned long)histogram.GetPercentileUs(50),
+             (unsigned long)histogram.GetPercentileUs(99), (unsigned long)histogram.GetMaxUs());
+  }
+
+  g_driver->SetClock(nullptr);
+  ESP_LOGI(TAG, "✅ Latency histogram tests passed");
+  return true;
+}
+
 //=============================================================================
 // MAIN TEST RUNNER
 //=============================================================================
@@ -859,21 +2243,44 @@ extern "C" void app_main() {
   RUN_TEST_SECTION_IF_ENABLED_WITH_PATTERN(
       ENABLE_DUTY_CYCLE_TESTS, "PCA9685 DUTY CYCLE TESTS", 5,
       RUN_TEST_IN_TASK("duty_cycle", test_duty_cycle, 8192, 1);
+      RUN_TEST_IN_TASK("ready_handle", test_ready_handle, 8192, 1);
+      RUN_TEST_IN_TASK("phase_stagger", test_phase_stagger, 8192, 1);
+      RUN_TEST_IN_TASK("gamma_brightness", test_gamma_brightness, 8192, 1);
+      RUN_TEST_IN_TASK("dither", test_dither, 8192, 1);
+      RUN_TEST_IN_TASK("trajectory", test_trajectory, 8192, 1);
+      RUN_TEST_IN_TASK("animation_player", test_animation_player, 8192, 1);
+      RUN_TEST_IN_TASK("frame_stream", test_frame_stream, 8192, 1);
+      RUN_TEST_IN_TASK("frame_scheduler", test_frame_scheduler, 8192, 1);
+      RUN_TEST_IN_TASK("bus_arbiter", test_bus_arbiter, 8192, 1);
+      RUN_TEST_IN_TASK("frame_mailbox", test_frame_mailbox, 8192, 1);
+      RUN_TEST_IN_TASK("async_driver", test_async_driver, 8192, 1);
       RUN_TEST_IN_TASK("all_channel_control", test_all_channel_control, 8192, 1);
       RUN_TEST_IN_TASK("prescale_readback", test_prescale_readback, 8192, 1);
+      RUN_TEST_IN_TASK("clock_source", test_clock_source, 8192, 1);
+      RUN_TEST_IN_TASK("fast_frequency_switch", test_fast_frequency_switch, 8192, 1);
       RUN_TEST_IN_TASK("sleep_wake", test_sleep_wake, 8192, 1);
+      RUN_TEST_IN_TASK("wake_async", test_wake_async, 8192, 1);
+      RUN_TEST_IN_TASK("idle_power_policy", test_idle_power_policy, 8192, 1);
+      RUN_TEST_IN_TASK("state_restore", test_state_restore, 8192, 1);
+      RUN_TEST_IN_TASK("channel_verify", test_channel_verify, 8192, 1);
       RUN_TEST_IN_TASK("output_config", test_output_config, 8192, 1);
       flip_test_progress_indicator(););
 
   RUN_TEST_SECTION_IF_ENABLED_WITH_PATTERN(
       ENABLE_ERROR_HANDLING_TESTS, "PCA9685 ERROR HANDLING TESTS", 5,
       RUN_TEST_IN_TASK("error_handling", test_error_handling, 8192, 1);
+      RUN_TEST_IN_TASK("retry_policy", test_retry_policy, 8192, 1);
+      RUN_TEST_IN_TASK("circuit_breaker", test_circuit_breaker, 8192, 1);
+      RUN_TEST_IN_TASK("fault_injection", test_fault_injection, 8192, 1);
+      RUN_TEST_IN_TASK("trace_recorder", test_trace_recorder, 8192, 1);
+      RUN_TEST_IN_TASK("bus_monitor", test_bus_monitor, 8192, 1);
       flip_test_progress_indicator(););
 
   RUN_TEST_SECTION_IF_ENABLED_WITH_PATTERN(
       ENABLE_STRESS_TESTS, "PCA9685 STRESS TESTS", 5,
       RUN_TEST_IN_TASK("stress_rapid_writes", test_stress_rapid_writes, 16384, 1);
       RUN_TEST_IN_TASK("stress_boundary_values", test_stress_boundary_values, 16384, 1);
+      RUN_TEST_IN_TASK("latency_histograms", test_latency_histograms, 8192, 1);
       flip_test_progress_indicator(););
 
   // Cleanup
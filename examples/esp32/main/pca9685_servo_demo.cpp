@@ -2,7 +2,7 @@
  * @file pca9685_servo_demo.cpp
  * @brief Hobby servo demonstration using PCA9685 16-channel PWM controller
  *
- * Demonstrates smooth, velocity-limited control of up to 16 hobby servos
+ * Demonstrates smooth, acceleration-limited control of up to 16 hobby servos
  * with synchronized animations.  Uses standard servo PWM timing (50 Hz,
  * 1000-2000 µs pulse width).
  *
@@ -19,6 +19,7 @@
  * │                                                                     │
  * │  Typical servo speed: 0.15 s / 60° (no load) → ~400°/s            │
  * │  Conservative limit here: ~260°/s → 6 ticks / 20 ms update        │
+ * │  Acceleration: 1 tick / update², S-curve over 4 updates           │
  * └─────────────────────────────────────────────────────────────────────┘
  *
  * Animations run in sequence:
@@ -31,12 +32,17 @@
  *   7. Converge    – outer servos sweep inward, inner sweep outward
  *   8. Knight Rider – single highlight sweeps back and forth
  *
+ * Animation curves are tables generated at compile time and played back by
+ * pca9685::AnimationPlayer, so the 20 ms update loop does no floating-point
+ * or trigonometric math.
+ *
  * @author HardFOC Development Team
  * @date 2025
  * @copyright HardFOC
  */
 
 // System headers
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
@@ -58,6 +64,9 @@ extern "C" {
 // Project headers (bus before driver so template sees full Esp32Pca9685I2cBus)
 #include "esp32_pca9685_bus.hpp"
 #include "pca9685.hpp"
+#include "pca9685_animation.hpp"
+#include "pca9685_scheduler.hpp"
+#include "pca9685_trajectory.hpp"
 
 // ============================================================================
 // Constants
@@ -94,20 +103,27 @@ static constexpr uint16_t SERVO_RANGE_TICKS = SERVO_MAX_TICKS - SERVO_MIN_TICKS;
 static constexpr uint32_t UPDATE_PERIOD_MS = 20;
 
 /**
- * Maximum ticks to move per 20 ms update.
+ * Velocity limit in Q8 ticks per 20 ms update (6 ticks/update = 300 ticks/s).
+ *
+ * Full range (205 ticks) in ~0.75 s including acceleration.  Corresponds to
+ * roughly 260°/s — well within typical servo capability (400°/s no-load).
+ */
+static constexpr uint16_t SERVO_MAX_VELOCITY_Q8 = 6 << 8;
+
+/**
+ * Acceleration limit in Q8 ticks per update² (1 tick/update²).
  *
- * 6 ticks / 20 ms = 300 ticks/s.  Full range (205 ticks) in ~0.68 s.
- * Corresponds to roughly 260°/s — well within typical servo capability
- * (400°/s no-load) and smooth enough to avoid jerk or mechanical stress.
+ * Cruise speed is reached after 6 updates (120 ms), and braking starts early
+ * enough to stop on the target without overshoot or mechanical shock.
  */
-static constexpr int16_t MAX_TICKS_PER_UPDATE = 6;
+static constexpr uint16_t SERVO_MAX_ACCEL_Q8 = 1 << 8;
+
+/// S-curve smoothing: moving average over 2^2 = 4 updates (80 ms), limits jerk
+static constexpr uint8_t SERVO_SCURVE_SHIFT = 2;
 
 /// PCA9685 default I2C address
 static constexpr uint8_t PCA9685_I2C_ADDRESS = 0x40;
 
-/// Math constant
-static constexpr float PI = 3.14159265358979323846f;
-
 // I2C pin overrides (same mechanism as comprehensive test)
 #if defined(PCA9685_EXAMPLE_I2C_SDA_GPIO) && defined(PCA9685_EXAMPLE_I2C_SCL_GPIO)
 static constexpr gpio_num_t EXAMPLE_SDA_PIN = (gpio_num_t)PCA9685_EXAMPLE_I2C_SDA_GPIO;
@@ -123,30 +139,36 @@ static constexpr gpio_num_t EXAMPLE_SCL_PIN = GPIO_NUM_5;
 
 /**
  * @class ServoController
- * @brief Velocity-limited multi-channel servo manager.
+ * @brief Acceleration-limited multi-channel servo manager.
  *
- * Tracks the current position of each servo in PCA9685 ticks and moves
- * toward a target at a bounded rate every update cycle.  This prevents
- * commanding instantaneous jumps that could stall, strip gears, or
- * draw excessive current.
+ * Wraps a pca9685::Trajectory: every update each servo moves toward its target
+ * along an S-curve profile (bounded velocity, acceleration and jerk), and all
+ * 16 new positions go to the PCA9685 as a single frame commit.  This prevents
+ * commanding instantaneous jumps or velocity steps that could stall, strip
+ * gears, or draw excessive current.
  */
 class ServoController {
 public:
+  using Motion = pca9685::Trajectory<NUM_SERVOS>;
+
   ServoController(PCA9685Driver* driver) : driver_(driver) {
+    Motion::Limits limits;
+    limits.max_velocity = SERVO_MAX_VELOCITY_Q8;
+    limits.max_accel = SERVO_MAX_ACCEL_Q8;
+    limits.profile = Motion::Profile::SCurve;
+    limits.scurve_shift = SERVO_SCURVE_SHIFT;
+    limits.min_ticks = SERVO_MIN_TICKS;
+    limits.max_ticks = SERVO_MAX_TICKS;
+    motion_.SetAllLimits(limits);
     // Start with all positions at minimum (will be synchronized at boot)
-    for (uint8_t i = 0; i < NUM_SERVOS; ++i) {
-      current_ticks_[i] = SERVO_MIN_TICKS;
-      target_ticks_[i] = SERVO_MIN_TICKS;
-    }
+    motion_.JumpAll(SERVO_MIN_TICKS);
   }
 
   // ---- Target setters ----
 
   /// Set target for a single channel in PCA9685 ticks (clamped to valid range)
   void SetTargetTicks(uint8_t ch, uint16_t ticks) {
-    if (ch >= NUM_SERVOS)
-      return;
-    target_ticks_[ch] = clampTicks(ticks);
+    motion_.SetTarget(ch, ticks);
   }
 
   /// Set target for a single channel in microseconds
@@ -156,10 +178,7 @@ public:
 
   /// Set all channels to the same target (ticks)
   void SetAllTargetTicks(uint16_t ticks) {
-    uint16_t clamped = clampTicks(ticks);
-    for (uint8_t i = 0; i < NUM_SERVOS; ++i) {
-      target_ticks_[i] = clamped;
-    }
+    motion_.SetAllTargets(ticks);
   }
 
   /// Set all channels to the same target (microseconds)
@@ -172,7 +191,7 @@ public:
     if (ch >= NUM_SERVOS)
       return;
     norm = fmaxf(0.0f, fminf(1.0f, norm));
-    target_ticks_[ch] = static_cast<uint16_t>(SERVO_MIN_TICKS + norm * SERVO_RANGE_TICKS + 0.5f);
+    motion_.SetTarget(ch, static_cast<uint16_t>(SERVO_MIN_TICKS + norm * SERVO_RANGE_TICKS + 0.5f));
   }
 
   /// Set all channels to a normalized position
@@ -186,16 +205,12 @@ public:
 
   /// Check if all channels have reached their target
   bool AllAtTarget() const {
-    for (uint8_t i = 0; i < NUM_SERVOS; ++i) {
-      if (current_ticks_[i] != target_ticks_[i])
-        return false;
-    }
-    return true;
+    return motion_.AllAtTarget();
   }
 
   /// Get current position in ticks
   uint16_t GetCurrentTicks(uint8_t ch) const {
-    return (ch < NUM_SERVOS) ? current_ticks_[ch] : 0;
+    return (ch < NUM_SERVOS) ? motion_.GetPosition(ch) : 0;
   }
 
   /// Get current position in microseconds
@@ -208,38 +223,19 @@ public:
   /**
    * @brief Advance all channels one step toward their targets.
    *
-   * Call this once per UPDATE_PERIOD_MS.  Each channel moves at most
-   * MAX_TICKS_PER_UPDATE ticks toward its target, then the new position
-   * is written to the PCA9685.
+   * Call this once per UPDATE_PERIOD_MS.  The trajectory generator advances
+   * every channel by one frame, then the changed channels are written to the
+   * PCA9685 in one burst (nothing is written when no servo moved).
    *
-   * @return true if all I2C writes succeeded; false on any failure.
+   * @return true if the I2C write succeeded; false on failure.
    */
   bool Update() {
-    bool all_ok = true;
-    for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-      int16_t delta =
-          static_cast<int16_t>(target_ticks_[ch]) - static_cast<int16_t>(current_ticks_[ch]);
-      if (delta == 0)
-        continue;
-
-      // Clamp velocity
-      if (delta > MAX_TICKS_PER_UPDATE) {
-        delta = MAX_TICKS_PER_UPDATE;
-      } else if (delta < -MAX_TICKS_PER_UPDATE) {
-        delta = -MAX_TICKS_PER_UPDATE;
-      }
-
-      current_ticks_[ch] = static_cast<uint16_t>(static_cast<int16_t>(current_ticks_[ch]) + delta);
-
-      if (!driver_->SetPwm(ch, 0, current_ticks_[ch])) {
-        all_ok = false;
-      }
-    }
-    return all_ok;
+    motion_.Step();
+    return motion_.Stage(*driver_) && driver_->CommitFrame();
   }
 
   /**
-   * @brief Immediately write current_ticks_ to hardware (no ramping).
+   * @brief Immediately write the current positions to hardware (no ramping).
    *
    * Used once at boot to synchronize the physical servo positions
    * with the software state before any animation starts.
@@ -247,7 +243,7 @@ public:
   bool ForceWriteAll() {
     bool all_ok = true;
     for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-      if (!driver_->SetPwm(ch, 0, current_ticks_[ch])) {
+      if (!driver_->SetPwm(ch, 0, motion_.GetPosition(ch))) {
         all_ok = false;
       }
     }
@@ -266,16 +262,7 @@ public:
 
 private:
   PCA9685Driver* driver_;
-  uint16_t current_ticks_[NUM_SERVOS];
-  uint16_t target_ticks_[NUM_SERVOS];
-
-  static uint16_t clampTicks(uint16_t t) {
-    if (t < SERVO_MIN_TICKS)
-      return SERVO_MIN_TICKS;
-    if (t > SERVO_MAX_TICKS)
-      return SERVO_MAX_TICKS;
-    return t;
-  }
+  Motion motion_;
 };
 
 // ============================================================================
@@ -303,51 +290,128 @@ static bool ramp_to_target(ServoController& ctrl, const char* label, uint32_t ma
   return true;
 }
 
+/// Player for the demo animations: up to three layered tracks per servo
+using AnimationPlayer = pca9685::AnimationPlayer<NUM_SERVOS, 3 * NUM_SERVOS>;
+
+static AnimationPlayer g_player;
+
+/**
+ * @brief Frame producer for run_animation(): advance the player and commit a frame.
+ *
+ * Frames missed under overload are merged (tick.frames > 1), so the animation
+ * stays on the wall-clock timeline instead of slowing down.
+ */
+static bool animation_frame(void* context, const pca9685::FrameTick& tick) {
+  auto& ctrl = *static_cast<ServoController*>(context);
+  for (uint32_t i = 0; i < tick.frames; ++i) {
+    g_player.Step();
+  }
+  for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
+    ctrl.SetTargetTicks(ch, g_player.GetOutput(ch));
+  }
+  return ctrl.Update();
+}
+
 /**
- * @brief Run a time-based animation loop.
+ * @brief Run a table-driven animation loop.
  *
- * Calls `compute_targets` every update cycle, which should set new targets
- * on the controller.  The controller then ramps toward them respecting the
- * velocity limit.
+ * `setup` adds tracks to the (cleared) player.  Every update period the
+ * player samples its tables and the outputs become the new servo targets;
+ * the controller then ramps toward them respecting the velocity and
+ * acceleration limits, and commits all 16 channels as one frame.  Frames are
+ * scheduled on absolute deadlines, so timing does not drift with the time
+ * spent on I2C.
  *
- * @param ctrl            Servo controller
- * @param duration_ms     Total animation duration
- * @param compute_targets Callback: (controller, elapsed_ms, total_ms)
+ * @param ctrl        Servo controller
+ * @param duration_ms Total animation duration
+ * @param setup       Callback that adds the animation's tracks to the player
  */
 static void run_animation(ServoController& ctrl, uint32_t duration_ms,
-                          void (*compute_targets)(ServoController& ctrl, uint32_t elapsed_ms,
-                                                  uint32_t total_ms)) {
-  uint32_t elapsed = 0;
-  while (elapsed < duration_ms) {
-    compute_targets(ctrl, elapsed, duration_ms);
-    ctrl.Update();
-    vTaskDelay(pdMS_TO_TICKS(UPDATE_PERIOD_MS));
-    elapsed += UPDATE_PERIOD_MS;
-  }
+                          void (*setup)(AnimationPlayer& player)) {
+  g_player.Clear();
+  setup(g_player);
+
+  pca9685::FrameScheduler<1> scheduler(Esp32Pca9685I2cBus::NowUs,
+                                       Esp32Pca9685I2cBus::SleepUs,
+                                       UPDATE_PERIOD_MS * 1000U);
+  scheduler.AddTask(animation_frame, &ctrl, pca9685::OverloadPolicy::Merge);
+  scheduler.Run(duration_ms / UPDATE_PERIOD_MS);
+
+  const pca9685::SchedulerStats& stats = scheduler.GetStats();
+  ESP_LOGI(TAG, "  │   %lu frames, %lu missed, jitter max %lu µs (p99 < %lu µs)",
+           (unsigned long)stats.frames_run, (unsigned long)stats.frames_missed,
+           (unsigned long)stats.max_jitter_us,
+           (unsigned long)scheduler.GetJitterHistogram().GetPercentileUs(99));
+}
+
+// ============================================================================
+// Animation tables (generated at compile time, stored in flash)
+// ============================================================================
+
+/// Convert a duration to animation frames (one frame per update)
+static constexpr uint32_t ms_to_frames(uint32_t ms) {
+  return (ms + UPDATE_PERIOD_MS / 2) / UPDATE_PERIOD_MS;
+}
+
+/// Phase lag of `index` steps of `1 / steps` period (65536 = one period)
+static constexpr uint16_t phase_lag(uint32_t index, uint32_t steps) {
+  return static_cast<uint16_t>(0U - (index * 65536U / steps));
 }
 
+/// One sine period, 0..65535, starting at the midpoint and rising
+static constexpr auto SINE_TABLE = pca9685::SineTable<256>();
+
+/// Cascade sweep: ease up to full range and back down (0..65535)
+static constexpr std::array<pca9685::Keyframe, 3> SWEEP_KEYS{{
+    {0, 0, pca9685::Ease::Linear},
+    {50, 65535, pca9685::Ease::Linear},
+    {100, 0, pca9685::Ease::Hold},
+}};
+static constexpr auto SWEEP_TABLE = pca9685::CompileKeyframes<64>(SWEEP_KEYS);
+
+/// Knight Rider: samples per bounce (out and back)
+static constexpr size_t KNIGHT_SAMPLES = 64;
+
+/**
+ * Knight Rider intensity of every channel over one bounce (0..65535): a
+ * Gaussian spotlight (sigma 1.5 channels) whose centre moves 0 → 15 → 0.
+ */
+static constexpr auto KNIGHT_TABLES = [] {
+  std::array<std::array<uint16_t, KNIGHT_SAMPLES>, NUM_SERVOS> tables{};
+  constexpr double SIGMA = 1.5;
+  for (size_t i = 0; i < KNIGHT_SAMPLES; ++i) {
+    const double phase = static_cast<double>(i) / KNIGHT_SAMPLES;
+    const double pos = (phase < 0.5 ? phase : 1.0 - phase) * 2.0 * (NUM_SERVOS - 1);
+    for (size_t ch = 0; ch < NUM_SERVOS; ++ch) {
+      const double dist = static_cast<double>(ch) - pos;
+      const double intensity = pca9685::cmath::Exp(-(dist * dist) / (2.0 * SIGMA * SIGMA));
+      tables[ch][i] = static_cast<uint16_t>(pca9685::cmath::Round(intensity * 65535.0));
+    }
+  }
+  return tables;
+}();
+
 // ============================================================================
 // Animation definitions
 // ============================================================================
 
+/// Add a sine track on `ch` spanning the full servo range
+static int add_sine(AnimationPlayer& player, uint8_t ch, uint32_t period_ms, uint16_t phase) {
+  const int track = player.AddTrack(ch, SINE_TABLE, ms_to_frames(period_ms), phase);
+  player.SetTrackRange(track, SERVO_MIN_TICKS, SERVO_MAX_TICKS);
+  return track;
+}
+
 /**
  * @brief Animation 1: Travelling sine wave
  *
- * Each channel's target is a sine function offset by its channel index,
- * creating a wave that appears to move across all 16 channels.
- *
- * Two full waves travel the length of the servo array.
+ * Each channel plays the same sine table, lagging its neighbour by 1/16 of a
+ * period, creating a wave that appears to move across all 16 channels.
  * The wave moves at 0.5 Hz (one complete cycle every 2 seconds).
  */
-static void anim_wave_targets(ServoController& ctrl, uint32_t elapsed_ms, uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
+static void anim_wave_setup(AnimationPlayer& player) {
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    // Phase offset: each channel is 2π/16 apart (one full wave across 16 channels)
-    float phase = 2.0f * PI * (static_cast<float>(ch) / NUM_SERVOS);
-    // Temporal frequency: 0.5 Hz → one cycle every 2 seconds
-    float angle = 2.0f * PI * 0.5f * time_s - phase;
-    float norm = 0.5f + 0.5f * sinf(angle); // 0.0 .. 1.0
-    ctrl.SetTargetNormalized(ch, norm);
+    add_sine(player, ch, 2000, phase_lag(ch, NUM_SERVOS));
   }
 }
 
@@ -357,11 +421,10 @@ static void anim_wave_targets(ServoController& ctrl, uint32_t elapsed_ms, uint32
  * All 16 channels pulsate in perfect unison from 0° to 180° and back.
  * Frequency: 0.33 Hz (3 seconds per breath cycle).
  */
-static void anim_breathe_targets(ServoController& ctrl, uint32_t elapsed_ms,
-                                 uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
-  float norm = 0.5f + 0.5f * sinf(2.0f * PI * 0.33f * time_s);
-  ctrl.SetAllTargetNormalized(norm);
+static void anim_breathe_setup(AnimationPlayer& player) {
+  for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
+    add_sine(player, ch, 3000, 0);
+  }
 }
 
 /**
@@ -370,29 +433,14 @@ static void anim_breathe_targets(ServoController& ctrl, uint32_t elapsed_ms,
  * Each channel sweeps from 0° to 180° and back, but each starts 200 ms
  * after the previous one — creating a waterfall/domino effect.
  */
-static void anim_cascade_targets(ServoController& ctrl, uint32_t elapsed_ms,
-                                 uint32_t /*total_ms*/) {
+static void anim_cascade_setup(AnimationPlayer& player) {
   static constexpr uint32_t STAGGER_MS = 200; ///< Delay between each channel's start
   static constexpr uint32_t SWEEP_MS = 2000;  ///< Time for one full sweep (up + down)
 
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    uint32_t ch_start = ch * STAGGER_MS;
-    if (elapsed_ms < ch_start) {
-      // Not started yet — hold at min
-      ctrl.SetTargetNormalized(ch, 0.0f);
-    } else {
-      uint32_t ch_elapsed = elapsed_ms - ch_start;
-      // Triangle wave: ramp up for half the sweep, ramp down for the other half
-      uint32_t phase = ch_elapsed % SWEEP_MS;
-      float half = static_cast<float>(SWEEP_MS) / 2.0f;
-      float norm;
-      if (phase < static_cast<uint32_t>(half)) {
-        norm = static_cast<float>(phase) / half;
-      } else {
-        norm = 2.0f - static_cast<float>(phase) / half;
-      }
-      ctrl.SetTargetNormalized(ch, norm);
-    }
+    const int track = player.AddTrack(ch, SWEEP_TABLE, ms_to_frames(SWEEP_MS), 0,
+                                      static_cast<uint16_t>(ms_to_frames(ch * STAGGER_MS)));
+    player.SetTrackRange(track, SERVO_MIN_TICKS, SERVO_MAX_TICKS);
   }
 }
 
@@ -403,15 +451,12 @@ static void anim_cascade_targets(ServoController& ctrl, uint32_t elapsed_ms,
  * The left half (0-7) runs a sine wave; the right half mirrors it.
  * Creates a symmetric butterfly-wing motion.
  */
-static void anim_mirror_targets(ServoController& ctrl, uint32_t elapsed_ms, uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
-
+static void anim_mirror_setup(AnimationPlayer& player) {
   for (uint8_t i = 0; i < NUM_SERVOS / 2; ++i) {
-    float phase = 2.0f * PI * (static_cast<float>(i) / (NUM_SERVOS / 2));
-    float norm = 0.5f + 0.5f * sinf(2.0f * PI * 0.4f * time_s - phase);
-    ctrl.SetTargetNormalized(i, norm);
+    const uint16_t phase = phase_lag(i, NUM_SERVOS / 2);
+    add_sine(player, i, 2500, phase);
     // Mirror partner
-    ctrl.SetTargetNormalized(NUM_SERVOS - 1 - i, norm);
+    add_sine(player, NUM_SERVOS - 1 - i, 2500, phase);
   }
 }
 
@@ -421,18 +466,14 @@ static void anim_mirror_targets(ServoController& ctrl, uint32_t elapsed_ms, uint
  * Outer servos sweep inward while inner servos sweep outward,
  * then reverse — creating a pulsing converge/diverge pattern.
  */
-static void anim_converge_targets(ServoController& ctrl, uint32_t elapsed_ms,
-                                  uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
-  float global_phase = sinf(2.0f * PI * 0.3f * time_s); // -1 .. +1
-
+static void anim_converge_setup(AnimationPlayer& player) {
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    // Distance from center (0 at center, 1 at edges)
-    float dist = fabsf(static_cast<float>(ch) - 7.5f) / 7.5f;
-    // Outer channels move opposite to inner ones
-    float norm = 0.5f + 0.5f * global_phase * (2.0f * dist - 1.0f);
-    norm = fmaxf(0.0f, fminf(1.0f, norm));
-    ctrl.SetTargetNormalized(ch, norm);
+    // Amplitude scales with distance from the centre (-1 inner .. +1 outer),
+    // so outer channels move opposite to inner ones
+    const int32_t dist2 = 2 * ch - (NUM_SERVOS - 1); // -15 .. +15
+    const int32_t half_swing = (SERVO_RANGE_TICKS * (2 * (dist2 < 0 ? -dist2 : dist2) - 15)) / 30;
+    const int track = player.AddTrack(ch, SINE_TABLE, ms_to_frames(3333));
+    player.SetTrackRange(track, SERVO_CENTER_TICKS - half_swing, SERVO_CENTER_TICKS + half_swing);
   }
 }
 
@@ -441,27 +482,12 @@ static void anim_converge_targets(ServoController& ctrl, uint32_t elapsed_ms,
  *
  * A single "spotlight" servo sweeps to 180° while its neighbors stay
  * near 0°.  The spotlight bounces back and forth across all 16 channels
- * with a smooth Gaussian-like falloff to adjacent channels.
+ * (2.5 s per bounce) with a Gaussian falloff precomputed per channel.
  */
-static void anim_knight_targets(ServoController& ctrl, uint32_t elapsed_ms, uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
-
-  // Bounce position: triangle wave 0..15..0 at 0.4 Hz
-  float cycle_period = 2.5f; // seconds for one full bounce (out and back)
-  float phase = fmodf(time_s, cycle_period) / cycle_period; // 0..1
-  float pos;
-  if (phase < 0.5f) {
-    pos = phase * 2.0f * (NUM_SERVOS - 1); // 0 → 15
-  } else {
-    pos = (1.0f - phase) * 2.0f * (NUM_SERVOS - 1); // 15 → 0
-  }
-
-  // Gaussian-like brightness falloff
-  static constexpr float SIGMA = 1.5f;
+static void anim_knight_setup(AnimationPlayer& player) {
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    float dist = static_cast<float>(ch) - pos;
-    float intensity = expf(-(dist * dist) / (2.0f * SIGMA * SIGMA));
-    ctrl.SetTargetNormalized(ch, intensity);
+    const int track = player.AddTrack(ch, KNIGHT_TABLES[ch], ms_to_frames(2500));
+    player.SetTrackRange(track, SERVO_MIN_TICKS, SERVO_MAX_TICKS);
   }
 }
 
@@ -471,35 +497,39 @@ static void anim_knight_targets(ServoController& ctrl, uint32_t elapsed_ms, uint
  * Even channels (0,2,4,...) move in anti-phase to odd channels (1,3,5,...).
  * Mimics a coordinated walking gait across all 16 channels.
  */
-static void anim_walk_targets(ServoController& ctrl, uint32_t elapsed_ms, uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
-  float norm_even = 0.5f + 0.5f * sinf(2.0f * PI * 0.5f * time_s);
-  float norm_odd = 1.0f - norm_even; // Anti-phase
-
+static void anim_walk_setup(AnimationPlayer& player) {
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    ctrl.SetTargetNormalized(ch, (ch % 2 == 0) ? norm_even : norm_odd);
+    add_sine(player, ch, 2000, (ch % 2 == 0) ? 0 : 32768); // Odd: anti-phase
   }
 }
 
 /**
  * @brief Animation 8: Multi-speed wave
  *
- * Three sine waves with different frequencies and amplitudes are
- * superimposed, creating an organic, non-repeating motion pattern.
+ * Three sine tracks with different frequencies and amplitudes are layered
+ * on every channel, creating an organic, non-repeating motion pattern.
  */
-static void anim_organic_targets(ServoController& ctrl, uint32_t elapsed_ms,
-                                 uint32_t /*total_ms*/) {
-  float time_s = static_cast<float>(elapsed_ms) / 1000.0f;
+static void anim_organic_setup(AnimationPlayer& player) {
+  struct Layer {
+    uint32_t period_ms;
+    int32_t amplitude;    ///< Ticks either side of the centre
+    int32_t phase_per_ch; ///< Phase shift per channel (65536 = one period)
+  };
+  static constexpr Layer LAYERS[] = {
+      {3333, SERVO_RANGE_TICKS * 2 / 5, -4172}, // 0.3 Hz,  0.4 range, -0.4 rad/ch
+      {1408, SERVO_RANGE_TICKS * 3 / 10, 2608}, // 0.71 Hz, 0.3 range, +0.25 rad/ch
+      {885, SERVO_RANGE_TICKS / 5, -6258},      // 1.13 Hz, 0.2 range, -0.6 rad/ch
+  };
 
   for (uint8_t ch = 0; ch < NUM_SERVOS; ++ch) {
-    float ch_f = static_cast<float>(ch);
-    // Three waves of different frequency/amplitude/direction
-    float w1 = 0.4f * sinf(2.0f * PI * 0.3f * time_s - ch_f * 0.4f);
-    float w2 = 0.3f * sinf(2.0f * PI * 0.71f * time_s + ch_f * 0.25f);
-    float w3 = 0.2f * sinf(2.0f * PI * 1.13f * time_s - ch_f * 0.6f);
-    float norm = 0.5f + w1 + w2 + w3;
-    norm = fmaxf(0.0f, fminf(1.0f, norm));
-    ctrl.SetTargetNormalized(ch, norm);
+    for (size_t i = 0; i < sizeof(LAYERS) / sizeof(LAYERS[0]); ++i) {
+      const Layer& layer = LAYERS[i];
+      const auto phase = static_cast<uint16_t>(layer.phase_per_ch * ch);
+      const int track = player.AddTrack(ch, SINE_TABLE, ms_to_frames(layer.period_ms), phase);
+      // The first layer carries the centre position; the others add around zero
+      const int32_t base = (i == 0) ? SERVO_CENTER_TICKS : 0;
+      player.SetTrackRange(track, base - layer.amplitude, base + layer.amplitude);
+    }
   }
 }
 
@@ -509,20 +539,20 @@ static void anim_organic_targets(ServoController& ctrl, uint32_t elapsed_ms,
 
 struct AnimationEntry {
   const char* name;
-  void (*compute_targets)(ServoController&, uint32_t, uint32_t);
+  void (*setup)(AnimationPlayer&);
   uint32_t duration_ms;
   const char* description;
 };
 
 static const AnimationEntry ANIMATIONS[] = {
-    {"Wave", anim_wave_targets, 10000, "Travelling sine wave across 16 channels"},
-    {"Breathe", anim_breathe_targets, 9000, "All channels pulsate in unison"},
-    {"Cascade", anim_cascade_targets, 10000, "Staggered waterfall sweep"},
-    {"Mirror", anim_mirror_targets, 10000, "Butterfly: left half mirrors right"},
-    {"Converge", anim_converge_targets, 10000, "Outer vs inner: converge/diverge"},
-    {"KnightRider", anim_knight_targets, 10000, "Bouncing spotlight with falloff"},
-    {"Walk", anim_walk_targets, 8000, "Alternating even/odd pairs (gait)"},
-    {"Organic", anim_organic_targets, 12000, "Multi-frequency superimposed waves"},
+    {"Wave", anim_wave_setup, 10000, "Travelling sine wave across 16 channels"},
+    {"Breathe", anim_breathe_setup, 9000, "All channels pulsate in unison"},
+    {"Cascade", anim_cascade_setup, 10000, "Staggered waterfall sweep"},
+    {"Mirror", anim_mirror_setup, 10000, "Butterfly: left half mirrors right"},
+    {"Converge", anim_converge_setup, 10000, "Outer vs inner: converge/diverge"},
+    {"KnightRider", anim_knight_setup, 10000, "Bouncing spotlight with falloff"},
+    {"Walk", anim_walk_setup, 8000, "Alternating even/odd pairs (gait)"},
+    {"Organic", anim_organic_setup, 12000, "Multi-frequency superimposed waves"},
 };
 
 static constexpr size_t NUM_ANIMATIONS = sizeof(ANIMATIONS) / sizeof(ANIMATIONS[0]);
@@ -693,7 +723,7 @@ extern "C" void app_main() {
       ESP_LOGI(TAG, "  │   %s", anim.description);
 
       // Run the animation
-      run_animation(ctrl, anim.duration_ms, anim.compute_targets);
+      run_animation(ctrl, anim.duration_ms, anim.setup);
 
       ESP_LOGI(TAG, "  └── %s complete", anim.name);
 
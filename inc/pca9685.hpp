@@ -10,7 +10,12 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "pca9685_device_health.hpp"
+#include "pca9685_gamma.hpp"
 #include "pca9685_i2c_interface.hpp"
+#include "pca9685_latency_histogram.hpp"
+#include "pca9685_power_policy.hpp"
+#include "pca9685_retry_policy.hpp"
 #include "pca9685_version.h"
 
 namespace pca9685 {
@@ -46,7 +51,7 @@ public:
     I2cWrite = 1 << 0,       ///< An I2C write operation failed
     I2cRead = 1 << 1,        ///< An I2C read operation failed
     InvalidParam = 1 << 2,   ///< Invalid parameter (channel, value, etc.)
-    DeviceNotFound = 1 << 3, ///< Device did not respond
+    DeviceNotFound = 1 << 3, ///< Device did not respond (or was skipped by the circuit breaker)
     NotInitialized = 1 << 4, ///< Driver not initialized
     OutOfRange = 1 << 5      ///< Value out of hardware range
   };
@@ -75,9 +80,228 @@ public:
     TESTMODE = 0xFF       ///< Test mode register
   };
 
+  /**
+   * @brief Operation classes tracked by the per-operation latency histograms.
+   *
+   * @see SetClock(), GetLatencyHistogram()
+   */
+  enum class Operation : uint8_t {
+    SetPwm = 0,     ///< Single-channel writes (SetPwm, SetDuty, SetChannelFullOn/Off)
+    Burst = 1,      ///< Multi-register bursts (SetAllPwm, CommitFrame)
+    SetPwmFreq = 2, ///< Prescaler update sequence
+    Wake = 3,       ///< Wake from sleep
+    Count = 4       ///< Number of tracked operations (not an operation)
+  };
+
+  /**
+   * @brief Oscillator and output state as tracked by the driver.
+   *
+   * @see GetPowerState(), WakeAsync()
+   */
+  enum class PowerState : uint8_t {
+    Awake = 0,   ///< Oscillator running, outputs active
+    Asleep = 1,  ///< SLEEP set: oscillator off, outputs off
+    Settling = 2 ///< Woken (or re-clocked), waiting for ServiceRestart() to issue RESTART
+  };
+
+  /**
+   * @brief How duty-cycle writes place each channel's ON edge within the PWM period.
+   *
+   * @see SetPhaseMode()
+   */
+  enum class PhaseMode : uint8_t {
+    None = 0,        ///< Every channel turns on at tick 0 (legacy behaviour)
+    Even = 1,        ///< Channel n turns on at n * 256 ticks (16 evenly spaced edges)
+    LoadBalanced = 2 ///< Each channel turns on where the previous channel's ON period ends
+  };
+
+  /**
+   * @brief LEDn register contents of one channel, as read back by ReadAllChannels().
+   */
+  struct ChannelValue {
+    uint16_t on_time;  ///< Bits 0-11 ON tick, bit 12 full-on
+    uint16_t off_time; ///< Bits 0-11 OFF tick, bit 12 full-off
+  };
+
+  static constexpr uint16_t FULL_BIT_ = 0x1000;   ///< LEDn_ON/OFF bit 12: full-on / full-off
+  static constexpr uint8_t MODE1_RESTART_ = 0x80; ///< MODE1: restart PWM after sleep
+  static constexpr uint8_t MODE1_EXTCLK_ = 0x40;  ///< MODE1: clock from EXTCLK pin (sticky)
+  static constexpr uint8_t MODE1_AI_ = 0x20;      ///< MODE1: register auto-increment
+  static constexpr uint8_t MODE1_SLEEP_ = 0x10;   ///< MODE1: low-power mode, oscillator off
   static constexpr uint8_t MAX_CHANNELS_ = 16;    ///< Number of PWM channels (0-15)
+  static constexpr uint8_t CHANNEL_IMAGE_SIZE_ = 4 * MAX_CHANNELS_; ///< LEDn register bytes
   static constexpr uint16_t MAX_PWM_ = 4095;      ///< Maximum tick value (12-bit)
+  static constexpr uint16_t DUTY_FULL_SCALE_ = 4096; ///< Staged duty ticks meaning "fully on"
   static constexpr uint32_t OSC_FREQ_ = 25000000; ///< Internal oscillator frequency (Hz)
+  static constexpr uint32_t MAX_EXT_CLOCK_HZ_ = 50000000; ///< EXTCLK input limit (Hz)
+  static constexpr uint32_t OSC_SETTLE_US_ = 500; ///< Oscillator start-up before RESTART (µs)
+
+  /** @brief LEDn register bytes of every channel (ON_L, ON_H, OFF_L, OFF_H per channel). */
+  using ChannelImage = ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_>;
+
+  // ---- Register Encoding ----
+  //
+  // Pure helpers behind the driver's writes, also used by AsyncPCA9685 so that both
+  // front-ends put the same bytes on the bus.
+
+  /**
+   * @brief Encode ON/OFF values as the four LEDn register bytes.
+   * @param on_time ON value (bits 0-11 ticks, bit 12 full-on).
+   * @param off_time OFF value (bits 0-11 ticks, bit 12 full-off).
+   * @return ON_L, ON_H, OFF_L, OFF_H.
+   */
+  [[nodiscard]] static constexpr ::std::array<uint8_t, 4> PackChannel(uint16_t on_time,
+                                                                      uint16_t off_time) noexcept {
+    return {static_cast<uint8_t>(on_time & 0xFF), static_cast<uint8_t>((on_time >> 8) & 0x1F),
+            static_cast<uint8_t>(off_time & 0xFF), static_cast<uint8_t>((off_time >> 8) & 0x1F)};
+  }
+
+  /**
+   * @brief Encode a duty as the four LEDn register bytes.
+   * @param ticks Duty in ticks: 0 = full-off, DUTY_FULL_SCALE_ (or more) = full-on.
+   * @param phase_offset ON tick of a partial duty (0-4095); the OFF edge wraps around.
+   * @return ON_L, ON_H, OFF_L, OFF_H.
+   */
+  [[nodiscard]] static constexpr ::std::array<uint8_t, 4> PackDutyTicks(
+      uint16_t ticks, uint16_t phase_offset) noexcept {
+    if (ticks == 0) {
+      return PackChannel(0, FULL_BIT_);
+    }
+    if (ticks >= DUTY_FULL_SCALE_) {
+      return PackChannel(FULL_BIT_, 0);
+    }
+    return PackChannel(phase_offset, (phase_offset + ticks) & MAX_PWM_);
+  }
+
+  /**
+   * @brief Convert a duty cycle (clamped to 0.0-1.0) to an OFF-edge distance in ticks (0-4095).
+   */
+  [[nodiscard]] static uint16_t DutyToTicks(float duty) noexcept {
+    duty = ::std::max(duty, 0.0F);
+    duty = ::std::min(duty, 1.0F);
+    return static_cast<uint16_t>(lroundf((duty * MAX_PWM_)));
+  }
+
+  /** @brief Check whether a clock frequency (Hz) is usable for prescaler math (1 Hz-50 MHz). */
+  [[nodiscard]] static constexpr bool IsValidClockHz(uint32_t clock_hz) noexcept {
+    return clock_hz != 0 && clock_hz <= MAX_EXT_CLOCK_HZ_;
+  }
+
+  /** @brief Lowest PWM frequency (Hz) the prescaler reaches with a clock of @p clock_hz. */
+  [[nodiscard]] static constexpr float MinPwmFreq(uint32_t clock_hz) noexcept {
+    return static_cast<float>(24.0 * clock_hz / OSC_FREQ_);
+  }
+
+  /** @brief Highest PWM frequency (Hz) the prescaler reaches with a clock of @p clock_hz. */
+  [[nodiscard]] static constexpr float MaxPwmFreq(uint32_t clock_hz) noexcept {
+    return static_cast<float>(1526.0 * clock_hz / OSC_FREQ_);
+  }
+
+  /**
+   * @brief Compute the PRE_SCALE value for a PWM frequency.
+   * @param freq_hz Frequency in Hz.
+   * @param clock_hz Prescaler clock in Hz (internal oscillator or EXTCLK).
+   * @return Prescale value, clamped to the device's 3-255.
+   */
+  [[nodiscard]] static uint8_t CalcPrescale(float freq_hz, uint32_t clock_hz) noexcept {
+    float prescale_val = (static_cast<float>(clock_hz) / (4096.0F * freq_hz)) - 1.0F;
+    prescale_val = ::std::max(prescale_val, 3.0F);
+    prescale_val = ::std::min(prescale_val, 255.0F);
+    return static_cast<uint8_t>(lroundf(prescale_val));
+  }
+
+  /** @brief Power-on content of the LEDn registers (LEDn_OFF_H full-off bit set). */
+  [[nodiscard]] static constexpr ChannelImage DefaultChannelImage() noexcept {
+    ChannelImage image{};
+    for (size_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      image[(4 * ch) + 3] = 0x10;
+    }
+    return image;
+  }
+
+  /**
+   * @brief Compute each channel's ON tick for a phase mode.
+   * @param mode Phase mode.
+   * @param phase_base Offset of the first edge in ticks (0-4095).
+   * @param ticks Channel duties; LoadBalanced lays out the partial ones in @p mask.
+   * @param mask Channels whose entry in @p ticks is a duty.
+   * @param[out] offsets ON tick of each channel's duty.
+   */
+  static constexpr void LayoutPhases(PhaseMode mode, uint16_t phase_base,
+                                     const ::std::array<uint16_t, MAX_CHANNELS_>& ticks,
+                                     uint16_t mask,
+                                     ::std::array<uint16_t, MAX_CHANNELS_>& offsets) noexcept {
+    uint16_t cursor = phase_base;
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      switch (mode) {
+      case PhaseMode::None:
+        offsets[ch] = 0;
+        break;
+      case PhaseMode::Even:
+        offsets[ch] = (phase_base + (ch * (DUTY_FULL_SCALE_ / MAX_CHANNELS_))) & MAX_PWM_;
+        break;
+      case PhaseMode::LoadBalanced:
+        // Lay partial duties end to end; full-on/full-off channels have no edges to place
+        offsets[ch] = cursor;
+        if ((mask & (1U << ch)) != 0 && ticks[ch] != 0 && ticks[ch] < DUTY_FULL_SCALE_) {
+          cursor = (cursor + ticks[ch]) & MAX_PWM_;
+        }
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Pack the duties of the channels in @p mask into a register image.
+   * @param[in,out] image Image to update; channels outside @p mask are left as they are.
+   * @param ticks Channel duties (see PackDutyTicks()).
+   * @param mask Channels to pack.
+   * @param offsets ON tick of each channel's duty (see LayoutPhases()).
+   */
+  static constexpr void PackDuties(ChannelImage& image,
+                                   const ::std::array<uint16_t, MAX_CHANNELS_>& ticks,
+                                   uint16_t mask,
+                                   const ::std::array<uint16_t, MAX_CHANNELS_>& offsets) noexcept {
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      if ((mask & (1U << ch)) != 0) {
+        const ::std::array<uint8_t, 4> regs = PackDutyTicks(ticks[ch], offsets[ch]);
+        ::std::copy(regs.begin(), regs.end(), image.begin() + (4 * ch));
+      }
+    }
+  }
+
+  /**
+   * @brief Find the span of channels in which two register images differ.
+   *
+   * Commits write one span covering every changed channel: unchanged channels inside it
+   * cost four bytes each, far less than the address and register overhead of a separate
+   * transaction.
+   *
+   * @param frame Image to be written.
+   * @param shadow Image on the device.
+   * @param[out] first First changed channel.
+   * @param[out] count Channels from @p first to the last changed one.
+   * @return true if any channel differs; false (outputs untouched) if the images match.
+   */
+  static constexpr bool FindChangedSpan(const ChannelImage& frame, const ChannelImage& shadow,
+                                        uint8_t& first, uint8_t& count) noexcept {
+    uint8_t lo = MAX_CHANNELS_;
+    uint8_t hi = 0;
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      const size_t offset = 4U * ch;
+      if (!::std::equal(frame.begin() + offset, frame.begin() + offset + 4,
+                        shadow.begin() + offset)) {
+        lo = ::std::min(lo, ch);
+        hi = ch;
+      }
+    }
+    if (lo == MAX_CHANNELS_) {
+      return false;
+    }
+    first = lo;
+    count = static_cast<uint8_t>(hi - lo + 1);
+    return true;
+  }
 
   /**
    * @brief Construct a new PCA9685 driver instance.
@@ -102,6 +326,29 @@ public:
    */
   bool EnsureInitialized() noexcept;
 
+  class ReadyHandle;
+
+  /**
+   * @brief Initialize the driver (if needed) and return a handle for hot-path writes.
+   *
+   * Runs EnsureInitialized() once. The returned ReadyHandle skips the per-call
+   * initialization check, so its setters never trigger a Reset() and cost only range
+   * validation (or nothing, for the compile-time channel overloads).
+   *
+   * @return A valid handle on success; an invalid handle (`!handle`) if initialization failed.
+   *
+   * @code
+   *   auto pwm = driver.GetReadyHandle();
+   *   if (!pwm) { return; }
+   *   while (running) {
+   *     pwm.SetPwm<3>(0, servo_ticks);  // channel checked at compile time
+   *   }
+   * @endcode
+   */
+  [[nodiscard]] ReadyHandle GetReadyHandle() noexcept {
+    return EnsureInitialized() ? ReadyHandle(this) : ReadyHandle();
+  }
+
   /**
    * @brief Check if the driver has been initialized.
    * @return true if EnsureInitialized() or Reset() has completed successfully.
@@ -113,7 +360,12 @@ public:
   /**
    * @brief Reset the device to its power-on default state.
    *
-   * Ensures the I2C bus is initialized, then writes MODE1 register to 0x00.
+   * Ensures the I2C bus is initialized, then writes MODE1 with only the AI
+   * (register auto-increment) bit set, so multi-byte channel writes and reads
+   * address consecutive registers.
+   *
+   * Closes the circuit breaker and refills the frame retry budget first, so a reset always
+   * reaches the bus and recovers a driver whose breaker is open (even without SetClock()).
    *
    * @return true on success; false on I2C failure.
    */
@@ -121,11 +373,116 @@ public:
 
   /**
    * @brief Set the PWM frequency for all channels.
-   * @param freq_hz Desired frequency in Hz (24-1526 typical).
+   *
+   * The prescaler is computed from the clock source set with EnableExternalClock() or
+   * SetOscillatorHz() (25 MHz internal oscillator by default).
+   *
+   * @param freq_hz Desired frequency in Hz, GetMinPwmFreq() to GetMaxPwmFreq() (24-1526 Hz
+   * with the internal oscillator).
    * @return true on success; false on I2C failure or invalid parameter.
    */
   bool SetPwmFreq(float freq_hz) noexcept;
 
+  /**
+   * @brief Change the PWM frequency with the fewest transfers, without blocking.
+   *
+   * Works from the cached MODE1 instead of reading it: writes MODE1 with SLEEP, PRE_SCALE
+   * and MODE1 again (three writes; only PRE_SCALE while the device sleeps, none if the
+   * prescale is unchanged). The outputs stay off until RESTART is written, which the
+   * datasheet allows only 500 µs after waking; ServiceRestart() does that write once
+   * GetRestartDueUs() has passed, and the channels resume with their previous values.
+   * Channel writes in between are queued until then, as after WakeAsync().
+   *
+   * @code
+   *   pwm.SetClock(MyBus::NowUs);
+   *   pwm.SetPwmFreqFast(1000.0F);   // servo -> LED mode
+   *   while (pwm.IsRestartPending()) {
+   *     do_other_work();
+   *     pwm.ServiceRestart();
+   *   }
+   * @endcode
+   *
+   * @param freq_hz Desired frequency in Hz, as for SetPwmFreq().
+   * @return true on success; false on I2C failure or invalid parameter.
+   */
+  bool SetPwmFreqFast(float freq_hz) noexcept;
+
+  /**
+   * @brief Issue the RESTART pending after SetPwmFreqFast() once the oscillator has settled.
+   *
+   * Does nothing while GetRestartDueUs() lies in the future. Without a clock (SetClock())
+   * the driver cannot tell, so the RESTART is written on the first call: wait
+   * OSC_SETTLE_US_ before calling. If the device was put to sleep in between, the pending
+   * RESTART is dropped (Wake() handles it). Channel writes queued meanwhile are written
+   * right after the RESTART.
+   *
+   * @return false on I2C failure (the RESTART or the queued writes stay pending); true
+   * otherwise.
+   */
+  bool ServiceRestart() noexcept;
+
+  /** @brief Check whether a RESTART is waiting for ServiceRestart(). */
+  [[nodiscard]] bool IsRestartPending() const noexcept {
+    return restart_pending_;
+  }
+
+  /** @brief Clock value (µs, see SetClock()) from which ServiceRestart() may restart. */
+  [[nodiscard]] uint32_t GetRestartDueUs() const noexcept {
+    return restart_due_us_;
+  }
+
+  /**
+   * @brief Switch the prescaler to the clock on the EXTCLK pin.
+   *
+   * Runs the datasheet sequence: set SLEEP, then write SLEEP and EXTCLK together, then return
+   * MODE1 to its previous sleep state. EXTCLK is sticky on the device: only a power cycle or
+   * a software reset returns it to the internal oscillator. Call SetPwmFreq() afterwards;
+   * later frequency math uses @p clock_hz.
+   *
+   * If a write fails before the SLEEP|EXTCLK write is acknowledged, the driver keeps its
+   * previous clock. If only the final MODE1 write fails, EXTCLK is already latched: the
+   * driver uses @p clock_hz, IsExternalClock() is true and the cached MODE1 keeps SLEEP set,
+   * so GetPowerState() reports Asleep; call Wake() to resume outputs that were running.
+   *
+   * @param clock_hz Frequency of the external clock in Hz (1-50 MHz).
+   * @return true on success; false on I2C failure or @p clock_hz out of range.
+   */
+  bool EnableExternalClock(uint32_t clock_hz) noexcept;
+
+  /**
+   * @brief Set the clock frequency used for prescaler math without touching the device.
+   *
+   * For a measured internal oscillator (it is only accurate to a few percent) or a device
+   * already running on EXTCLK, so boards can be matched to the same PWM period.
+   *
+   * @param clock_hz Clock frequency in Hz (1-50 MHz); other values are ignored.
+   */
+  void SetOscillatorHz(uint32_t clock_hz) noexcept {
+    if (IsValidClockHz(clock_hz)) {
+      osc_freq_ = clock_hz;
+    }
+  }
+
+  /** @brief Clock frequency used for prescaler math (Hz). */
+  [[nodiscard]] uint32_t GetOscillatorHz() const noexcept {
+    return osc_freq_;
+  }
+
+  /** @brief Check whether EnableExternalClock() has switched the device to EXTCLK. */
+  [[nodiscard]] bool IsExternalClock() const noexcept {
+    return ext_clock_;
+  }
+
+  /** @brief Lowest frequency SetPwmFreq() accepts with the current clock (Hz). */
+  [[nodiscard]] float GetMinPwmFreq() const noexcept {
+    return MinPwmFreq(osc_freq_);
+  }
+
+  /** @brief Highest frequency SetPwmFreq() accepts with the current clock (Hz). */
+  [[nodiscard]] float GetMaxPwmFreq() const noexcept {
+    return MaxPwmFreq(osc_freq_);
+  }
+
   /**
    * @brief Set the PWM on/off time for a channel.
    * @param channel Channel number (0-15).
@@ -137,6 +494,11 @@ public:
 
   /**
    * @brief Set the duty cycle for a channel (0.0-1.0).
+   *
+   * The ON edge is placed at the channel's phase offset (tick 0 unless a PhaseMode is
+   * set, see SetPhaseMode()); the OFF edge follows it by the duty, wrapping around the
+   * end of the period.
+   *
    * @param channel Channel number (0-15).
    * @param duty Duty cycle (0.0 = always off, 1.0 = always on).
    * @return true on success; false on I2C failure or invalid parameter.
@@ -145,12 +507,173 @@ public:
 
   /**
    * @brief Set all channels to the same PWM value.
+   *
+   * Uses the single ALL_LED register write. With a PhaseMode other than None, the
+   * value is instead treated as a duty of `(off_time - on_time) mod 4096` ticks and
+   * written to every channel with its own phase offset (one LEDn burst).
+   *
    * @param on_time Tick count when signal turns ON (0-4095).
    * @param off_time Tick count when signal turns OFF (0-4095).
    * @return true on success; false on I2C failure.
    */
   bool SetAllPwm(uint16_t on_time, uint16_t off_time) noexcept;
 
+  // ---- Frame Staging ----
+
+  /**
+   * @brief Stage raw on/off times for a channel in the pending frame (no bus traffic).
+   * @param channel Channel number (0-15).
+   * @param on_time Tick count when signal turns ON (0-4095).
+   * @param off_time Tick count when signal turns OFF (0-4095).
+   * @return true if staged; false on invalid parameter.
+   */
+  bool StagePwm(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept;
+
+  /**
+   * @brief Stage a duty cycle in ticks for a channel in the pending frame (no bus traffic).
+   *
+   * The ON/OFF registers are computed by CommitFrame() using the channel's phase
+   * offset. 0 stages full-off and DUTY_FULL_SCALE_ (4096) stages full-on.
+   *
+   * @param channel Channel number (0-15).
+   * @param ticks ON duration in ticks (0-4096).
+   * @return true if staged; false on invalid parameter.
+   */
+  bool StageDutyTicks(uint8_t channel, uint16_t ticks) noexcept;
+
+  /**
+   * @brief Stage a duty cycle for a channel in the pending frame (no bus traffic).
+   * @param channel Channel number (0-15).
+   * @param duty Duty cycle, clamped to 0.0-1.0 (0.0 = full-off, 1.0 = full-on).
+   * @return true if staged; false on invalid channel.
+   */
+  bool StageDuty(uint8_t channel, float duty) noexcept;
+
+  /**
+   * @brief Write the pending frame to the device.
+   *
+   * Packs every staged duty with the current phase offsets, then writes the span from
+   * the first to the last channel that differs from the shadow image in as few bursts
+   * as SetMaxBurstLength() allows (one by default). Nothing is written if the frame
+   * matches the device. Timed as Operation::Burst.
+   *
+   * Direct writes (SetPwm(), SetDuty(), ...) replace anything staged for their channel.
+   *
+   * @return true on success (or nothing to write); false on I2C failure.
+   */
+  bool CommitFrame() noexcept;
+
+  /**
+   * @brief Drop all staged changes; the pending frame reverts to the shadow image.
+   */
+  void DiscardFrame() noexcept {
+    frame_image_ = channel_image_;
+    duty_ticks_ = written_ticks_;
+    duty_mask_ = written_mask_;
+  }
+
+  // ---- Phase Staggering ----
+
+  /**
+   * @brief Select how duty-cycle writes stagger the channels' ON edges.
+   *
+   * With every channel turning on at tick 0, all outputs switch simultaneously and the
+   * supply sees the summed current step once per period. Staggering the ON edges
+   * spreads the load; the duty cycle of each channel is unchanged.
+   *
+   * - PhaseMode::Even: channel n turns on at `phase_base + n * 256`.
+   * - PhaseMode::LoadBalanced: channels with a duty (staged, or written with SetDuty())
+   *   are laid end to end, so the number of simultaneously active outputs stays near the
+   *   average load. A SetDuty() write places its channel after the current duties of the
+   *   channels before it; a duty change may move the channels after it, which are rewritten
+   *   at their next write or the next CommitFrame().
+   *
+   * Offsets apply to SetDuty(), StageDuty()/StageDutyTicks() and, when not None,
+   * SetAllPwm(). Channels set with raw on/off times are never moved. The new mode takes
+   * effect on the next write; staged duties are re-packed at the next CommitFrame().
+   *
+   * @param mode Phase mode.
+   * @param phase_base Offset of the first edge in ticks (0-4095), e.g.
+   *        `board_index * 4096 / board_count` to also stagger boards sharing a supply.
+   */
+  void SetPhaseMode(PhaseMode mode, uint16_t phase_base = 0) noexcept {
+    phase_mode_ = mode;
+    phase_base_ = phase_base & MAX_PWM_;
+    layoutPhases();
+  }
+
+  /**
+   * @brief Get the active phase mode.
+   */
+  [[nodiscard]] PhaseMode GetPhaseMode() const noexcept {
+    return phase_mode_;
+  }
+
+  /**
+   * @brief Get the ON tick currently assigned to a channel's duty writes.
+   * @param channel Channel number (0-15).
+   * @return Offset in ticks (0-4095), or 0 for an invalid channel.
+   */
+  [[nodiscard]] uint16_t GetPhaseOffset(uint8_t channel) const noexcept {
+    return channel < MAX_CHANNELS_ ? phase_offset_[channel] : 0;
+  }
+
+  // ---- Brightness (LED channels) ----
+
+  /**
+   * @brief Select the lookup table applied by the brightness setters.
+   *
+   * Brightness levels are perceptual: the table (see MakeGammaTable(), GAMMA_2_2_TABLE,
+   * GAMMA_CIE1931_TABLE) maps them to duty ticks with an interpolated lookup, so no
+   * per-channel `powf` is needed. The table must outlive its use by the driver.
+   *
+   * @param table Table, or nullptr for a linear response (the default).
+   */
+  void SetGammaTable(const GammaTable* table) noexcept {
+    gamma_table_ = table;
+  }
+
+  /**
+   * @brief Get the active brightness table (nullptr when linear).
+   */
+  [[nodiscard]] const GammaTable* GetGammaTable() const noexcept {
+    return gamma_table_;
+  }
+
+  /**
+   * @brief Set a channel's brightness immediately (one transaction).
+   * @param channel Channel number (0-15).
+   * @param level Brightness, 0 (full-off) to 65535 (full-on).
+   * @return true on success; false on invalid channel or I2C failure.
+   */
+  bool SetBrightness(uint8_t channel, uint16_t level) noexcept;
+
+  /**
+   * @brief Stage a channel's brightness in the pending frame (no bus traffic).
+   * @param channel Channel number (0-15).
+   * @param level Brightness, 0 (full-off) to 65535 (full-on).
+   * @return true if staged; false on invalid channel.
+   */
+  bool StageBrightness(uint8_t channel, uint16_t level) noexcept;
+
+  /**
+   * @brief Stage the brightness of consecutive channels from 16-bit levels.
+   * @param first_channel First channel (0-15).
+   * @param levels Brightness levels, 0-65535.
+   * @param count Number of channels (first_channel + count <= 16).
+   * @return true if staged; false on invalid range (nothing is staged).
+   */
+  bool StageBrightness(uint8_t first_channel, const uint16_t* levels, uint8_t count) noexcept;
+
+  /**
+   * @brief Stage the brightness of consecutive channels from 8-bit levels.
+   * @param first_channel First channel (0-15).
+   * @param levels Brightness levels, 0-255.
+   * @param count Number of channels (first_channel + count <= 16).
+   * @return true if staged; false on invalid range (nothing is staged).
+   */
+  bool StageBrightness(uint8_t first_channel, const uint8_t* levels, uint8_t count) noexcept;
+
   /**
    * @brief Get the accumulated error flags (bitmask).
    * @return Bitmask of Error values; 0 (Error::None) means no errors.
@@ -214,10 +737,13 @@ public:
 
   /**
    * @brief Set the I2C retry count for register read/write operations.
-   * @param retries Number of retries (0 = no retries, just one attempt).
+   *
+   * Shorthand for changing RetryPolicy::Config::max_retries; other policy settings are kept.
+   *
+   * @param retries Number of retries (0 = no retries, just one attempt; clamped to 0-255).
    */
   void SetRetries(int retries) noexcept {
-    retries_ = retries;
+    retry_policy_.SetMaxRetries(static_cast<uint8_t>(::std::clamp(retries, 0, 255)));
   }
 
   /**
@@ -234,13 +760,423 @@ public:
    *
    * Set to a function that performs a short delay (e.g. 1–5 ms) to allow bus recovery,
    * or leave default (nullptr) for no delay. The driver calls this only when a Read/Write
-   * failed and retries remain.
+   * failed and retries remain, and only if the retry policy produced no backoff delay
+   * (see SetRetryPolicy() and SetRetryDelayUs()).
    * @param fn Callback function, or nullptr to use no delay.
    */
   void SetRetryDelay(RetryDelayFn fn) noexcept {
     retry_delay_ = fn;
   }
 
+  /**
+   * @brief Type of optional callback that blocks for a given number of microseconds.
+   *
+   * Set via SetRetryDelayUs(). Used to apply the backoff delays computed by the RetryPolicy.
+   */
+  using RetryDelayUsFn = void (*)(uint32_t delay_us);
+
+  /**
+   * @brief Set the callback used to wait for retry-policy backoff delays.
+   *
+   * Required for RetryPolicy::Config::base_delay_us to take effect; without it the driver
+   * falls back to the fixed SetRetryDelay() callback (if any).
+   *
+   * @param fn Callback function, or nullptr.
+   */
+  void SetRetryDelayUs(RetryDelayUsFn fn) noexcept {
+    retry_delay_us_ = fn;
+  }
+
+  /**
+   * @brief Configure the retry policy (backoff, jitter, frame budget, offline fast-fail).
+   *
+   * @param config Policy configuration; see RetryPolicy::Config.
+   *
+   * @code
+   *   pca9685::RetryPolicy::Config cfg;
+   *   cfg.max_retries = 4;
+   *   cfg.base_delay_us = 200;      // 200, 400, 800, 1600 µs
+   *   cfg.jitter_percent = 25;
+   *   cfg.frame_retry_budget = 8;   // per BeginFrame()
+   *   cfg.offline_threshold = 3;    // single attempt after 3 failed transfers
+   *   driver.SetRetryPolicy(cfg);
+   *   driver.SetRetryDelayUs(MyBus::DelayUs);
+   * @endcode
+   */
+  void SetRetryPolicy(const RetryPolicy::Config& config) noexcept {
+    retry_policy_.Configure(config);
+  }
+
+  /**
+   * @brief Access the retry policy (statistics, offline state, jitter seed).
+   */
+  [[nodiscard]] RetryPolicy& GetRetryPolicy() noexcept {
+    return retry_policy_;
+  }
+
+  /**
+   * @brief Access the retry policy (read-only).
+   */
+  [[nodiscard]] const RetryPolicy& GetRetryPolicy() const noexcept {
+    return retry_policy_;
+  }
+
+  /**
+   * @brief Mark the start of an update frame: refills the per-frame retry budget.
+   *
+   * Call once per control-loop iteration before issuing that iteration's writes.
+   * Has no effect unless RetryPolicy::Config::frame_retry_budget is non-zero.
+   */
+  void BeginFrame() noexcept {
+    retry_policy_.BeginFrame();
+  }
+
+  // ---- Device Health ----
+
+  /**
+   * @brief Configure the per-device circuit breaker.
+   *
+   * After `failure_threshold` consecutive failed transfers the breaker opens: every
+   * operation then fails immediately with Error::DeviceNotFound, without bus traffic,
+   * so a dead board cannot stall updates to healthy boards on the same bus. Once
+   * `cooldown_us` has elapsed, the next operation first probes the device (one MODE1
+   * read); on success the cached MODE1/MODE2/PRE_SCALE configuration is re-applied and
+   * the breaker closes, on failure it stays open for another cool-down.
+   *
+   * Automatic probing needs a clock (SetClock()); without one, call ProbeDevice()
+   * periodically, or Reset(), to recover an open breaker.
+   *
+   * @param config Breaker configuration (failure_threshold = 0 disables the breaker).
+   */
+  void SetCircuitBreaker(const DeviceHealth::Config& config) noexcept {
+    health_.Configure(config);
+  }
+
+  /**
+   * @brief Get the device health state (breaker state, failure streak, last success time).
+   */
+  [[nodiscard]] const DeviceHealth& GetHealth() const noexcept {
+    return health_;
+  }
+
+  /**
+   * @brief Probe the device now, regardless of the breaker cool-down.
+   *
+   * Issues a single MODE1 read. If the device answers and the breaker was open, the
+   * cached configuration is re-applied and the breaker closes.
+   *
+   * @return true if the device responded (and any restore succeeded).
+   */
+  bool ProbeDevice() noexcept;
+
+  // ---- Idle Power Policy ----
+
+  /**
+   * @brief Configure automatic sleep of an idle device.
+   *
+   * Once every channel has been off for `idle_timeout_us`, ServicePowerPolicy() puts the
+   * device to sleep. The first write that turns a channel on (SetPwm, SetDuty, SetAllPwm,
+   * CommitFrame, ...) clears SLEEP before it goes out; no RESTART is needed because no
+   * channel was running. Application code needs no other change.
+   *
+   * Needs a clock (SetClock()) to time the idle period.
+   *
+   * @param config Policy configuration (idle_timeout_us = 0 disables automatic sleep).
+   */
+  void SetPowerPolicy(const PowerPolicy::Config& config) noexcept {
+    power_policy_.Configure(config);
+    notePowerActivity();
+  }
+
+  /**
+   * @brief Get the policy state and its metrics (sleeps, wakes, time asleep).
+   */
+  [[nodiscard]] const PowerPolicy& GetPowerPolicy() const noexcept {
+    return power_policy_;
+  }
+
+  /**
+   * @brief Put the device to sleep if the power policy says it has been idle long enough.
+   *
+   * Call periodically from a housekeeping task; costs no transfer until the device sleeps
+   * (one MODE1 read and write). Does nothing while the device is asleep, settling or
+   * not initialised.
+   *
+   * @return true unless the sleep transfer failed.
+   */
+  bool ServicePowerPolicy() noexcept;
+
+  // ---- State Verification / Restore ----
+
+  /**
+   * @brief Detect a device power loss (brown-out) and restore the cached state.
+   *
+   * Reads MODE1 (and PRE_SCALE, if the driver has written it) and compares them with
+   * the driver's cache. After a power cycle the chip comes back with power-on defaults
+   * (MODE1 = SLEEP | ALLCALL, PRE_SCALE = 0x1E, all channels full-off), which no
+   * longer matches; in that case RestoreState() is called.
+   *
+   * Costs one or two single-byte reads when the device is consistent; call it
+   * periodically from a housekeeping task, or enable SetVerifyAfterError().
+   *
+   * @return true if the device state was consistent or was restored successfully.
+   */
+  bool VerifyAndRestore() noexcept;
+
+  /**
+   * @brief Replay the cached configuration and full channel image to the device.
+   *
+   * Writes MODE1 (with SLEEP), PRE_SCALE, MODE2, the 64 LEDn registers in as few
+   * bursts as SetMaxBurstLength() allows (one by default), then the final MODE1 —
+   * five transactions instead of an application-level reinit.
+   *
+   * @return true on success; false on I2C failure.
+   */
+  bool RestoreState() noexcept;
+
+  /**
+   * @brief Read the LEDn registers of all 16 channels.
+   *
+   * One 64-byte auto-increment read (split per SetMaxBurstLength()).
+   *
+   * @param[out] values ON/OFF register values per channel.
+   * @return true on success; false on I2C failure.
+   */
+  bool ReadAllChannels(::std::array<ChannelValue, MAX_CHANNELS_>& values) noexcept;
+
+  /**
+   * @brief Compare the device's LEDn registers with the last written values.
+   *
+   * Reads all channels as ReadAllChannels() does and diffs them against the shadow
+   * image; staged, uncommitted changes are not considered. Repair a mismatch with
+   * RestoreState() or by rewriting the channels.
+   *
+   * @param[out] mismatch_mask Bit n set if channel n differs from what was written.
+   * @return true if the readback succeeded (check @p mismatch_mask); false on I2C failure.
+   */
+  bool Verify(uint16_t& mismatch_mask) noexcept;
+
+  /**
+   * @brief Verify device state automatically after a failed transfer.
+   *
+   * When enabled, any failed transfer marks the state as suspect and the next public
+   * call runs VerifyAndRestore() before doing its own work.
+   *
+   * @param enable true to enable (default false).
+   */
+  void SetVerifyAfterError(bool enable) noexcept {
+    verify_after_error_ = enable;
+  }
+
+  /**
+   * @brief Number of times RestoreState() has re-written the device.
+   */
+  [[nodiscard]] uint32_t GetRestoreCount() const noexcept {
+    return restore_count_;
+  }
+
+  /**
+   * @brief Set the largest payload the bus accepts in one Write() or Read() call.
+   *
+   * Multi-channel transfers (state restore, channel readback) are split into chunks of
+   * at most this many bytes, rounded down to whole channels (4 bytes). Default: 64 (all
+   * 16 channels).
+   *
+   * @param bytes Maximum payload bytes per transfer (minimum 4).
+   */
+  void SetMaxBurstLength(size_t bytes) noexcept {
+    bytes = ::std::clamp<size_t>(bytes, 4, CHANNEL_IMAGE_SIZE_);
+    max_burst_bytes_ = static_cast<uint8_t>(bytes - (bytes % 4));
+  }
+
+  // ---- Latency Instrumentation ----
+
+  /**
+   * @brief Type of optional monotonic clock used for latency measurement.
+   *
+   * Set via SetClock(). Must return a free-running microsecond counter; wrap-around
+   * at 2^32 is handled, so a truncated 64-bit timer (e.g. `esp_timer_get_time()`) is fine.
+   */
+  using ClockFn = uint32_t (*)();
+
+  /**
+   * @brief Set the monotonic clock used to time driver operations.
+   *
+   * When set, every SetPwm / burst / SetPwmFreq / Wake call is timed from entry to
+   * return (including I2C retries) and recorded in the matching latency histogram.
+   * Leave default (nullptr) to disable timing entirely.
+   *
+   * @param fn Clock function returning microseconds, or nullptr to disable.
+   */
+  void SetClock(ClockFn fn) noexcept {
+    clock_ = fn;
+  }
+
+  /**
+   * @brief Get the latency histogram for an operation class.
+   *
+   * The histogram is lock-free and may be read from another task while the
+   * driver is in use.
+   *
+   * @param op Operation class (must not be Operation::Count).
+   * @return Reference to the histogram for @p op.
+   */
+  [[nodiscard]] const LatencyHistogram& GetLatencyHistogram(Operation op) const noexcept {
+    return latency_[static_cast<size_t>(op) % static_cast<size_t>(Operation::Count)];
+  }
+
+  /**
+   * @brief Reset all latency histograms.
+   */
+  void ResetLatencyHistograms() noexcept {
+    for (auto& histogram : latency_) {
+      histogram.Reset();
+    }
+  }
+
+  /**
+   * @class ReadyHandle
+   * @brief Lightweight, copyable view of an initialized driver with check-free setters.
+   *
+   * Obtained from GetReadyHandle(). Setters go straight to the register writers: no
+   * EnsureInitialized() branch, no lazy Reset(), and no SetVerifyAfterError() check
+   * (call VerifyAndRestore() explicitly when using handles). Retries, the circuit
+   * breaker, the shadow image and latency histograms apply as usual.
+   *
+   * Only use a handle for which `IsValid()` is true, and do not let it outlive the
+   * driver.
+   */
+  class ReadyHandle {
+  public:
+    /** @brief Construct an invalid handle. */
+    ReadyHandle() noexcept = default;
+
+    /** @brief true if the handle refers to an initialized driver. */
+    [[nodiscard]] bool IsValid() const noexcept {
+      return driver_ != nullptr;
+    }
+
+    /** @brief Same as IsValid(). */
+    explicit operator bool() const noexcept {
+      return driver_ != nullptr;
+    }
+
+    /**
+     * @brief Set the PWM on/off time for a channel (range-checked, no init check).
+     * @param channel Channel number (0-15).
+     * @param on_time Tick count when signal turns ON (0-4095).
+     * @param off_time Tick count when signal turns OFF (0-4095).
+     * @return true on success; false on I2C failure or invalid parameter.
+     */
+    bool SetPwm(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept {
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+        driver_->setError(Error::OutOfRange);
+        return false;
+      }
+      return driver_->writeChannel(channel, on_time, off_time);
+    }
+
+    /**
+     * @brief Set the PWM on/off time for a compile-time channel (no runtime checks).
+     *
+     * Tick values are masked to 12 bits instead of being validated.
+     *
+     * @tparam Channel Channel number (0-15), checked at compile time.
+     * @param on_time Tick count when signal turns ON.
+     * @param off_time Tick count when signal turns OFF.
+     * @return true on success; false on I2C failure.
+     */
+    template <uint8_t Channel>
+    bool SetPwm(uint16_t on_time, uint16_t off_time) noexcept {
+      static_assert(Channel < MAX_CHANNELS_, "PCA9685 channel index must be 0-15");
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      return driver_->writeChannel(Channel, on_time & MAX_PWM_, off_time & MAX_PWM_);
+    }
+
+    /**
+     * @brief Set the duty cycle for a channel (0.0-1.0, clamped).
+     * @param channel Channel number (0-15).
+     * @param duty Duty cycle.
+     * @return true on success; false on I2C failure or invalid channel.
+     */
+    bool SetDuty(uint8_t channel, float duty) noexcept {
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      if (channel >= MAX_CHANNELS_) {
+        driver_->setError(Error::OutOfRange);
+        return false;
+      }
+      return driver_->writeDuty(channel, DutyToTicks(duty));
+    }
+
+    /**
+     * @brief Set the duty cycle for a compile-time channel (0.0-1.0, clamped).
+     * @tparam Channel Channel number (0-15), checked at compile time.
+     * @param duty Duty cycle.
+     * @return true on success; false on I2C failure.
+     */
+    template <uint8_t Channel>
+    bool SetDuty(float duty) noexcept {
+      static_assert(Channel < MAX_CHANNELS_, "PCA9685 channel index must be 0-15");
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      return driver_->writeDuty(Channel, DutyToTicks(duty));
+    }
+
+    /**
+     * @brief Set all channels to the same PWM value (range-checked).
+     * @return true on success; false on I2C failure or invalid parameter.
+     */
+    bool SetAllPwm(uint16_t on_time, uint16_t off_time) noexcept {
+      LatencyScope latency(*driver_, Operation::Burst);
+      if (on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+        driver_->setError(Error::OutOfRange);
+        return false;
+      }
+      return driver_->writeAllChannels(on_time, off_time);
+    }
+
+    /**
+     * @brief Set a compile-time channel fully ON.
+     * @tparam Channel Channel number (0-15), checked at compile time.
+     */
+    template <uint8_t Channel>
+    bool SetChannelFullOn() noexcept {
+      static_assert(Channel < MAX_CHANNELS_, "PCA9685 channel index must be 0-15");
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      return driver_->writeChannel(Channel, FULL_BIT_, 0);
+    }
+
+    /**
+     * @brief Set a compile-time channel fully OFF.
+     * @tparam Channel Channel number (0-15), checked at compile time.
+     */
+    template <uint8_t Channel>
+    bool SetChannelFullOff() noexcept {
+      static_assert(Channel < MAX_CHANNELS_, "PCA9685 channel index must be 0-15");
+      LatencyScope latency(*driver_, Operation::SetPwm);
+      return driver_->writeChannel(Channel, 0, FULL_BIT_);
+    }
+
+    /**
+     * @brief Read the prescale register (no init check).
+     * @param[out] prescale The prescale register value.
+     * @return true on success; false on I2C failure.
+     */
+    [[nodiscard]] bool GetPrescale(uint8_t& prescale) noexcept {
+      return driver_->readPrescale(prescale);
+    }
+
+    /** @brief Access the underlying driver (configuration, errors, statistics). */
+    [[nodiscard]] PCA9685& GetDriver() const noexcept {
+      return *driver_;
+    }
+
+  private:
+    friend class PCA9685;
+    explicit ReadyHandle(PCA9685* driver) noexcept : driver_(driver) {}
+    PCA9685* driver_{nullptr};
+  };
+
   // ---- Power Management ----
 
   /**
@@ -259,10 +1195,48 @@ public:
    * Clears the SLEEP bit in MODE1 and sets the RESTART bit if it was set
    * prior to sleep. PWM outputs resume from their previous values.
    *
+   * @note RESTART is written at once, before the 500 µs oscillator start-up the datasheet
+   * requires; use WakeAsync() to wake without blocking and restart on time.
+   *
+   * While settling (PowerState::Settling), Wake() finishes that wake instead: it waits for
+   * GetRestartDueUs() through the SetRetryDelayUs() hook (if a clock and the hook are set),
+   * then writes RESTART and the queued channel writes as ServiceRestart() does.
+   *
    * @return true on success; false on I2C failure.
    */
   bool Wake() noexcept;
 
+  /**
+   * @brief Start waking the PCA9685 and return without waiting for the oscillator.
+   *
+   * Clears SLEEP with one MODE1 write from the cached value (no read) and enters
+   * PowerState::Settling. GetRestartDueUs() is the ready-at time; ServiceRestart() issues
+   * RESTART from then on, so the outputs resume with their previous values. Until then
+   * channel writes (SetPwm, SetDuty, SetAllPwm, CommitFrame, ReadyHandle setters, ...) are
+   * queued in the pending frame and return true without a transfer, because a PWM register
+   * write would cancel the RESTART; ServiceRestart() writes them in one burst right after
+   * the RESTART.
+   *
+   * @code
+   *   pwm.SetClock(MyBus::NowUs);
+   *   pwm.WakeAsync();
+   *   pwm.SetDuty(3, 0.5F);            // queued
+   *   // ... other work; from a periodic task:
+   *   pwm.ServiceRestart();            // RESTART + queued writes once due
+   * @endcode
+   *
+   * @return true if waking started (or the device was already awake); false on I2C failure.
+   */
+  bool WakeAsync() noexcept;
+
+  /** @brief Power state from the driver's cache; see PowerState. */
+  [[nodiscard]] PowerState GetPowerState() const noexcept {
+    if ((mode1_cache_ & MODE1_SLEEP_) != 0) {
+      return PowerState::Asleep;
+    }
+    return restart_pending_ ? PowerState::Settling : PowerState::Awake;
+  }
+
   // ---- Output Configuration ----
 
   /**
@@ -358,9 +1332,72 @@ private:
   uint8_t addr_;
   Error last_error_{Error::None};
   uint16_t error_flags_{0};
-  int retries_{3};
+  RetryPolicy retry_policy_{};
   RetryDelayFn retry_delay_{nullptr};
+  RetryDelayUsFn retry_delay_us_{nullptr};
+  ClockFn clock_{nullptr};
   bool initialized_{false};
+  DeviceHealth health_{};
+  PowerPolicy power_policy_{};
+
+  uint32_t osc_freq_{OSC_FREQ_}; ///< Prescaler clock: internal oscillator or EXTCLK (Hz)
+  bool ext_clock_{false};        ///< EXTCLK set on the device (sticky until power cycle)
+  uint32_t restart_due_us_{0};   ///< Earliest RESTART after SetPwmFreqFast()
+  bool restart_pending_{false};  ///< Outputs wait for RESTART (SetPwmFreqFast(), WakeAsync())
+  bool frame_queued_{false};     ///< Channel writes queued in frame_image_ until RESTART
+
+  /** @brief Cached configuration registers, replayed by RestoreState(). */
+  uint8_t mode1_cache_{0x00};
+  uint8_t mode2_cache_{0x00};
+  uint8_t prescale_cache_{0x00};
+  bool mode2_known_{false};
+  bool prescale_known_{false};
+
+  /**
+   * @brief Shadow of the LED0_ON_L..LED15_OFF_H registers as last written.
+   *
+   * Initialised to the power-on default (every channel full-off), which is also what
+   * a browned-out device contains, so the whole image can always be replayed.
+   */
+  ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_> channel_image_ = DefaultChannelImage();
+  /** @brief Pending frame: the shadow image plus staged, not yet committed changes. */
+  ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_> frame_image_ = DefaultChannelImage();
+  ::std::array<uint16_t, MAX_CHANNELS_> duty_ticks_{}; ///< Channel duties (valid in duty_mask_)
+  uint16_t duty_mask_{0}; ///< Channels whose frame content is a duty re-packed on commit
+  ::std::array<uint16_t, MAX_CHANNELS_> written_ticks_{}; ///< Duties last written to the device
+  uint16_t written_mask_{0}; ///< Channels whose shadow image content is a duty
+  PhaseMode phase_mode_{PhaseMode::None};
+  uint16_t phase_base_{0};
+  ::std::array<uint16_t, MAX_CHANNELS_> phase_offset_{}; ///< ON tick of each channel's duty
+  const GammaTable* gamma_table_{nullptr}; ///< Brightness curve (nullptr = linear)
+  uint8_t max_burst_bytes_{CHANNEL_IMAGE_SIZE_};
+  bool verify_after_error_{false};
+  bool verify_pending_{false};
+  uint32_t restore_count_{0};
+  LatencyHistogram latency_[static_cast<size_t>(Operation::Count)];
+
+  /**
+   * @brief RAII helper that records the lifetime of a public call into a histogram.
+   *
+   * Does nothing when no clock is installed.
+   */
+  class LatencyScope {
+  public:
+    LatencyScope(PCA9685& driver, Operation op) noexcept
+        : driver_(driver), op_(op), start_us_(driver.clock_ ? driver.clock_() : 0) {}
+    ~LatencyScope() {
+      if (driver_.clock_) {
+        driver_.latency_[static_cast<size_t>(op_)].Record(driver_.clock_() - start_us_);
+      }
+    }
+    LatencyScope(const LatencyScope&) = delete;
+    LatencyScope& operator=(const LatencyScope&) = delete;
+
+  private:
+    PCA9685& driver_;
+    Operation op_;
+    uint32_t start_us_;
+  };
 
   /** @brief Set last error and add to error flags. */
   void setError(Error e) noexcept {
@@ -380,9 +1417,125 @@ private:
   /** @brief Read a block of bytes from a register. @param reg Start register. @param data Buffer.
    * @param len Length. @return true on success. */
   bool readRegBlock(uint8_t reg, uint8_t* data, size_t len) noexcept;
-  /** @brief Compute prescale value for given frequency. @param freq_hz Frequency in Hz. @return
-   * Prescale value (0–255). */
-  [[nodiscard]] uint8_t calcPrescale(float freq_hz) const noexcept;
+  /**
+   * @brief Run one I2C transfer under the retry policy.
+   * @param attempt Callable performing a single bus transaction; returns true on success.
+   * @param error Error flag to set if every permitted attempt fails.
+   * @return true on success.
+   */
+  template <typename Attempt>
+  bool transfer(Attempt&& attempt, Error error) noexcept;
+  /** @brief Current clock reading, or 0 without a clock. */
+  [[nodiscard]] uint32_t nowUs() const noexcept {
+    return clock_ ? clock_() : 0;
+  }
+  /** @brief Record a successful register write in the configuration cache. */
+  void cacheConfig(uint8_t reg, uint8_t value) noexcept;
+  /**
+   * @brief Write one channel's LEDn registers and update the shadow image (no checks).
+   * @param channel Channel number (0-15).
+   * @param on_time ON register value (bits 0-11 ticks, bit 12 full-on).
+   * @param off_time OFF register value (bits 0-11 ticks, bit 12 full-off).
+   * @return true on success.
+   */
+  bool writeChannel(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept;
+  /** @brief Write a duty (0-4095 ticks) starting at the channel's phase offset (no checks).
+   * @return true on success. */
+  bool writeDuty(uint8_t channel, uint16_t ticks) noexcept {
+    if (phase_mode_ == PhaseMode::LoadBalanced) {
+      layoutPhases(); // Place the channel after the current duties of the channels before it
+    }
+    const uint16_t on_time = phase_offset_[channel];
+    if (!writeChannel(channel, on_time, (on_time + ticks) & MAX_PWM_)) {
+      return false;
+    }
+    if (ticks != 0) {
+      stageDuty(channel, ticks); // Laid out and re-packed like a committed staged duty
+      written_ticks_[channel] = ticks;
+      written_mask_ |= static_cast<uint16_t>(1U << channel);
+    }
+    return true;
+  }
+  /** @brief Write the same value to every channel and update the shadow image (no checks);
+   * staggered per channel unless the phase mode is None. @return true on success. */
+  bool writeAllChannels(uint16_t on_time, uint16_t off_time) noexcept;
+  /** @brief Map a brightness level (0-65535) to duty ticks (0-4096) through the gamma table. */
+  [[nodiscard]] uint16_t levelToTicks(uint16_t level) const noexcept {
+    if (gamma_table_ != nullptr) {
+      return GammaLookup(*gamma_table_, level);
+    }
+    return static_cast<uint16_t>((level + (static_cast<uint32_t>(level) >> 15U)) >> 4U);
+  }
+  /** @brief Record a duty for a channel in the pending frame (no checks). */
+  void stageDuty(uint8_t channel, uint16_t ticks) noexcept {
+    duty_ticks_[channel] = ticks;
+    duty_mask_ |= static_cast<uint16_t>(1U << channel);
+  }
+  /** @brief Recompute phase_offset_ for the current mode and channel duties. */
+  void layoutPhases() noexcept {
+    LayoutPhases(phase_mode_, phase_base_, duty_ticks_, duty_mask_, phase_offset_);
+  }
+  /** @brief Pack staged duties into the frame and write the changed span (no checks).
+   * @return true on success. */
+  bool commitFrame() noexcept;
+  /** @brief Read PRE_SCALE (no checks). @param[out] prescale Value read.
+   * @return true on success. */
+  bool readPrescale(uint8_t& prescale) noexcept;
+  /** @brief Store four written LEDn register bytes for a channel in the shadow image and the
+   * pending frame (a direct write supersedes anything staged for the channel). */
+  void storeChannel(uint8_t channel, const uint8_t* data) noexcept {
+    ::std::copy(data, data + 4, channel_image_.begin() + (4 * channel));
+    ::std::copy(data, data + 4, frame_image_.begin() + (4 * channel));
+    duty_mask_ &= static_cast<uint16_t>(~(1U << channel));
+    written_mask_ &= static_cast<uint16_t>(~(1U << channel));
+  }
+  /** @brief Queue four LEDn register bytes for a channel in the pending frame, to be written
+   * by ServiceRestart() (a later direct write or restage supersedes them). */
+  void queueChannel(uint8_t channel, const uint8_t* data) noexcept {
+    ::std::copy(data, data + 4, frame_image_.begin() + (4 * channel));
+    duty_mask_ &= static_cast<uint16_t>(~(1U << channel));
+    frame_queued_ = true;
+    last_error_ = Error::None;
+  }
+  /** @brief Tell the power policy whether the shadow image is idle (every channel off). */
+  void notePowerActivity() noexcept {
+    if (power_policy_.Enabled()) {
+      power_policy_.NoteActivity(PowerPolicy::IsImageIdle(channel_image_.data(), MAX_CHANNELS_),
+                                 nowUs());
+    }
+  }
+  /** @brief Wake a device the power policy put to sleep before a write that turns a channel
+   * on. @param idle true if the write keeps every channel off. @return true on success. */
+  bool wakeForWrite(bool idle) noexcept {
+    if (idle || !power_policy_.IsAsleep()) {
+      return true;
+    }
+    return writeReg(static_cast<uint8_t>(Register::MODE1),
+                    static_cast<uint8_t>(mode1_cache_ & ~MODE1_SLEEP_)); // Records the wake
+  }
+  /** @brief Commit the pending frame if channel writes were queued during RESTART settling.
+   * @return true on success (or nothing queued). */
+  bool flushQueuedFrame() noexcept;
+  /**
+   * @brief Write channels [first, first + count) of an image in bursts.
+   *
+   * Each successfully written burst is copied into the shadow image.
+   *
+   * @param image Source image (channel_image_ or frame_image_).
+   * @param first First channel.
+   * @param count Number of consecutive channels.
+   * @return true on success.
+   */
+  bool writeChannelRange(const ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_>& image, uint8_t first,
+                         uint8_t count) noexcept;
+  /** @brief Read all LEDn registers in bursts of at most max_burst_bytes_ (no checks).
+   * @return true on success. */
+  bool readChannelImage(::std::array<uint8_t, CHANNEL_IMAGE_SIZE_>& image) noexcept;
+  /** @brief Compute the prescale value for a frequency with the current clock.
+   * @param freq_hz Frequency in Hz. @return Prescale value (3-255). */
+  [[nodiscard]] uint8_t calcPrescale(float freq_hz) const noexcept {
+    return CalcPrescale(freq_hz, osc_freq_);
+  }
 
   /**
    * @brief Read-modify-write a single register.
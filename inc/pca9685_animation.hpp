@@ -0,0 +1,361 @@
+/**
+ * @file pca9685_animation.hpp
+ * @brief Keyframe compiler, constexpr tick tables and table-driven animation player for PCA9685
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_constexpr_math.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Interpolation applied between a keyframe and the next one.
+ */
+enum class Ease : uint8_t {
+  Hold = 0,   ///< Keep this keyframe's value until the next keyframe
+  Linear = 1, ///< Straight line
+  Smooth = 2, ///< Smoothstep (zero slope at both ends)
+  Sine = 3    ///< Half-cosine ease-in/ease-out
+};
+
+/**
+ * @brief One point of a keyframe curve.
+ */
+struct Keyframe {
+  uint16_t frame; ///< Time of the keyframe in frames (strictly increasing within a curve)
+  uint16_t value; ///< Value at this keyframe (ticks, or 0-65535 for unit tables)
+  Ease ease;      ///< Interpolation towards the next keyframe
+};
+
+/**
+ * @brief Compile a keyframe curve into a table of @p N evenly spaced samples.
+ *
+ * Sample `i` is the curve value at `keys[0].frame + i * span / N`, where span is the time
+ * from the first to the last keyframe, so the table covers one period without repeating
+ * its start: a looping curve should end on the value it starts with.
+ *
+ * Usable in constant expressions, so the table can live in flash:
+ * @code
+ *   using pca9685::Ease;
+ *   constexpr std::array<pca9685::Keyframe, 3> SWEEP{
+ *       {{0, 0, Ease::Sine}, {50, 65535, Ease::Sine}, {100, 0, Ease::Hold}}};
+ *   constexpr auto SWEEP_TABLE = pca9685::CompileKeyframes<64>(SWEEP);
+ * @endcode
+ *
+ * @tparam N Number of samples.
+ * @tparam K Number of keyframes (>= 2).
+ * @param keys Keyframes with strictly increasing frames.
+ * @return The sampled table.
+ */
+template <size_t N, size_t K>
+constexpr ::std::array<uint16_t, N>
+CompileKeyframes(const ::std::array<Keyframe, K>& keys) noexcept {
+  static_assert(N > 0 && K >= 2, "A curve needs at least two keyframes and one sample");
+  ::std::array<uint16_t, N> table{};
+  const double start = keys[0].frame;
+  const double span = static_cast<double>(keys[K - 1].frame) - start;
+  size_t seg = 0;
+  for (size_t i = 0; i < N; ++i) {
+    const double t = start + ((span * static_cast<double>(i)) / static_cast<double>(N));
+    while (seg + 2 < K && t >= keys[seg + 1].frame) {
+      ++seg;
+    }
+    const Keyframe& a = keys[seg];
+    const Keyframe& b = keys[seg + 1];
+    const double len = static_cast<double>(b.frame) - a.frame;
+    const double u = len > 0.0 ? (t - a.frame) / len : 1.0;
+    double e = u;
+    switch (a.ease) {
+    case Ease::Hold:
+      e = 0.0;
+      break;
+    case Ease::Linear:
+      break;
+    case Ease::Smooth:
+      e = u * u * (3.0 - (2.0 * u));
+      break;
+    case Ease::Sine:
+      e = (1.0 - cmath::Cos(cmath::PI * u)) / 2.0;
+      break;
+    }
+    const double v = a.value + ((static_cast<double>(b.value) - a.value) * e);
+    table[i] = static_cast<uint16_t>(cmath::Round(v < 0.0 ? 0.0 : (v > 65535.0 ? 65535.0 : v)));
+  }
+  return table;
+}
+
+/**
+ * @brief Table of one sine period scaled to [lo, hi], starting at the midpoint and rising.
+ * @tparam N Number of samples.
+ */
+template <size_t N>
+constexpr ::std::array<uint16_t, N> SineTable(uint16_t lo = 0, uint16_t hi = 65535) noexcept {
+  ::std::array<uint16_t, N> table{};
+  for (size_t i = 0; i < N; ++i) {
+    const double angle = (2.0 * cmath::PI * static_cast<double>(i)) / static_cast<double>(N);
+    const double s = cmath::Sin(angle);
+    table[i] = static_cast<uint16_t>(cmath::Round(lo + ((hi - lo) * (1.0 + s) / 2.0)));
+  }
+  return table;
+}
+
+/**
+ * @brief Table of one triangle period scaled to [lo, hi], starting at @p lo.
+ * @tparam N Number of samples.
+ */
+template <size_t N>
+constexpr ::std::array<uint16_t, N> TriangleTable(uint16_t lo = 0, uint16_t hi = 65535) noexcept {
+  ::std::array<uint16_t, N> table{};
+  for (size_t i = 0; i < N; ++i) {
+    const double u = (2.0 * static_cast<double>(i)) / static_cast<double>(N);
+    const double tri = u <= 1.0 ? u : 2.0 - u;
+    table[i] = static_cast<uint16_t>(cmath::Round(lo + ((hi - lo) * tri)));
+  }
+  return table;
+}
+
+/**
+ * @brief Sample a table at a Q16.16 index with linear interpolation.
+ * @param table Table data.
+ * @param length Number of entries (1-32768).
+ * @param index_q16 Position in entries, 16 fractional bits (< length << 16).
+ * @param wrap true to interpolate the last entry towards the first (looping table).
+ * @return Interpolated value.
+ */
+constexpr uint16_t SampleTable(const uint16_t* table, uint16_t length, uint32_t index_q16,
+                               bool wrap = true) noexcept {
+  const uint32_t i = index_q16 >> 16;
+  const int64_t frac = static_cast<int64_t>(index_q16 & 0xFFFFU);
+  const uint32_t next = i + 1 < length ? i + 1 : (wrap ? 0 : i);
+  const int32_t a = table[i];
+  const int32_t b = table[next];
+  // |b - a| and frac both reach 65535 (e.g. a sawtooth wrapping): the product needs 64 bits
+  return static_cast<uint16_t>(a + ((static_cast<int64_t>(b - a) * frac) >> 16));
+}
+
+/**
+ * @class AnimationPlayer
+ * @brief Plays precomputed tables on output channels, one Step() per frame.
+ *
+ * Each track plays one table on one channel at a given period, phase and start delay;
+ * the values of all tracks on a channel are summed, so richer motion is built by layering
+ * tables instead of evaluating functions. Per frame and track the cost is an index
+ * increment, one interpolated lookup and one multiply (for the value mapping); no floating
+ * point or transcendental calls.
+ *
+ * Outputs are 16-bit. Tables may hold ticks directly, or unit values (0-65535) mapped to a
+ * tick range per track with SetTrackRange().
+ *
+ * @tparam NumChannels Number of output channels (16 per PCA9685).
+ * @tparam MaxTracks Maximum number of tracks.
+ */
+template <size_t NumChannels, size_t MaxTracks = NumChannels>
+class AnimationPlayer {
+public:
+  static constexpr uint16_t MAX_TABLE_LENGTH_ = 32768; ///< Longest table a track can play
+
+  /**
+   * @brief Remove all tracks and zero the outputs.
+   */
+  void Clear() noexcept {
+    track_count_ = 0;
+    outputs_.fill(0);
+  }
+
+  /**
+   * @brief Add a track.
+   * @param channel Output channel.
+   * @param table Table data (must outlive the track).
+   * @param length Number of entries (1-32768).
+   * @param period_frames Frames to play the whole table once (>= 1).
+   * @param phase Start position as a fraction of the table, 0-65535 (65536 = one period).
+   * @param delay_frames Frames to hold the start value before playing.
+   * @param loop true to repeat, false to stop on the last entry.
+   * @return Track index, or -1 if the player is full or a parameter is invalid.
+   */
+  int AddTrack(size_t channel, const uint16_t* table, uint16_t length, uint32_t period_frames,
+               uint16_t phase = 0, uint16_t delay_frames = 0, bool loop = true) noexcept {
+    if (track_count_ >= MaxTracks || channel >= NumChannels || table == nullptr || length == 0 ||
+        length > MAX_TABLE_LENGTH_ || period_frames == 0) {
+      return -1;
+    }
+    Track& t = tracks_[track_count_];
+    t.table = table;
+    t.length = length;
+    t.channel = static_cast<uint16_t>(channel);
+    t.loop = loop;
+    t.end = static_cast<uint32_t>(length) << 16;
+    t.step = static_cast<uint32_t>((static_cast<uint64_t>(t.end) + (period_frames / 2)) /
+                                   period_frames);
+    t.start = static_cast<uint32_t>(length) * phase; // phase / 65536 of the table, in Q16.16
+    t.delay = delay_frames;
+    t.offset = 0;
+    t.scale = 65536;
+    restartTrack(t);
+    return static_cast<int>(track_count_++);
+  }
+
+  /**
+   * @brief Add a track playing a std::array table.
+   * @see AddTrack(size_t, const uint16_t*, uint16_t, uint32_t, uint16_t, uint16_t, bool)
+   */
+  template <size_t N>
+  int AddTrack(size_t channel, const ::std::array<uint16_t, N>& table, uint32_t period_frames,
+               uint16_t phase = 0, uint16_t delay_frames = 0, bool loop = true) noexcept {
+    static_assert(N > 0 && N <= MAX_TABLE_LENGTH_, "Table length must be 1-32768");
+    return AddTrack(channel, table.data(), static_cast<uint16_t>(N), period_frames, phase,
+                    delay_frames, loop);
+  }
+
+  /**
+   * @brief Map a track's table values linearly: 0 -> @p from, 65536 -> @p to.
+   *
+   * Use with unit tables (0-65535) to place one table at different tick ranges, amplitudes
+   * or polarities (`from > to` inverts). The default is the identity mapping.
+   *
+   * @param track Track index returned by AddTrack().
+   * @param from Output for table value 0 (may be negative when layering tracks).
+   * @param to Output for table value 65536.
+   * @return true on success; false for an invalid track.
+   */
+  bool SetTrackRange(int track, int32_t from, int32_t to) noexcept {
+    if (track < 0 || static_cast<size_t>(track) >= track_count_) {
+      return false;
+    }
+    tracks_[track].offset = from;
+    tracks_[track].scale = to - from;
+    return true;
+  }
+
+  /**
+   * @brief Rewind every track to its start phase and delay.
+   */
+  void Restart() noexcept {
+    for (size_t i = 0; i < track_count_; ++i) {
+      restartTrack(tracks_[i]);
+    }
+  }
+
+  /**
+   * @brief Compute this frame's outputs, then advance every track by one frame.
+   * @return true if at least one output changed.
+   */
+  bool Step() noexcept {
+    ::std::array<int32_t, NumChannels> sum{};
+    ::std::array<bool, NumChannels> used{};
+    for (size_t i = 0; i < track_count_; ++i) {
+      Track& t = tracks_[i];
+      const int32_t v = SampleTable(t.table, t.length, t.position, t.loop);
+      sum[t.channel] += t.offset + static_cast<int32_t>((static_cast<int64_t>(v) * t.scale) >> 16);
+      used[t.channel] = true;
+      if (t.wait > 0) {
+        --t.wait;
+      } else if (!t.done) {
+        t.position += t.step;
+        if (t.position >= t.end) {
+          if (t.loop) {
+            t.position %= t.end;
+          } else {
+            t.position = t.end - 65536U;
+            t.done = true;
+          }
+        }
+      }
+    }
+    bool changed = false;
+    for (size_t ch = 0; ch < NumChannels; ++ch) {
+      if (!used[ch]) {
+        continue;
+      }
+      const auto value = static_cast<uint16_t>(::std::clamp<int32_t>(sum[ch], 0, 65535));
+      changed |= value != outputs_[ch];
+      outputs_[ch] = value;
+    }
+    return changed;
+  }
+
+  /**
+   * @brief Check whether every non-looping track has reached its last entry.
+   */
+  [[nodiscard]] bool Finished() const noexcept {
+    for (size_t i = 0; i < track_count_; ++i) {
+      if (!tracks_[i].loop && !tracks_[i].done) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Output of a channel computed by the last Step().
+   * @param channel Channel index.
+   */
+  [[nodiscard]] uint16_t GetOutput(size_t channel) const noexcept {
+    return channel < NumChannels ? outputs_[channel] : 0;
+  }
+
+  /** @brief Number of tracks in use. */
+  [[nodiscard]] size_t GetTrackCount() const noexcept {
+    return track_count_;
+  }
+
+  /**
+   * @brief Stage up to 16 consecutive outputs into a driver's pending frame as duty ticks.
+   *
+   * Outputs above DUTY_FULL_SCALE_ (4096) are clamped. Call CommitFrame() on the driver
+   * afterwards.
+   *
+   * @tparam Driver A PCA9685 driver type.
+   * @param driver Driver to stage into.
+   * @param first_channel First output mapped to driver channel 0.
+   * @return true if every channel was staged.
+   */
+  template <typename Driver>
+  bool Stage(Driver& driver, size_t first_channel = 0) const noexcept {
+    if (first_channel >= NumChannels) {
+      return false;
+    }
+    const size_t count = ::std::min<size_t>(16, NumChannels - first_channel);
+    bool ok = true;
+    for (size_t ch = 0; ch < count; ++ch) {
+      const uint16_t v = outputs_[first_channel + ch];
+      ok &= driver.StageDutyTicks(static_cast<uint8_t>(ch),
+                                  v > Driver::DUTY_FULL_SCALE_ ? Driver::DUTY_FULL_SCALE_ : v);
+    }
+    return ok;
+  }
+
+private:
+  struct Track {
+    const uint16_t* table{nullptr};
+    uint32_t position{0}; ///< Q16.16 index into the table
+    uint32_t step{0};     ///< Q16.16 entries per frame
+    uint32_t start{0};    ///< Q16.16 start index (phase)
+    uint32_t end{0};      ///< length << 16
+    int32_t offset{0};    ///< Value mapping: out = offset + (value * scale) >> 16
+    int32_t scale{65536};
+    uint16_t length{0};
+    uint16_t channel{0};
+    uint16_t delay{0};
+    uint16_t wait{0}; ///< Remaining delay frames
+    bool loop{true};
+    bool done{false};
+  };
+
+  ::std::array<Track, MaxTracks> tracks_{};
+  ::std::array<uint16_t, NumChannels> outputs_{};
+  size_t track_count_{0};
+
+  static void restartTrack(Track& t) noexcept {
+    t.position = t.start;
+    t.wait = t.delay;
+    t.done = false;
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,690 @@
+/**
+ * @file pca9685_async.hpp
+ * @brief C++20 coroutine front-end: awaitable PCA9685 operations over a completion-based bus
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Only available when the compiler supports coroutines (`__cpp_impl_coroutine`).
+ */
+#pragma once
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#include "pca9685.hpp"
+
+namespace pca9685 {
+
+// ============================================================================
+// Task
+// ============================================================================
+
+/**
+ * @class Task
+ * @brief Lazily started coroutine returning a T, awaitable from another coroutine.
+ *
+ * `co_await task` starts the task and resumes the awaiting coroutine when it finishes
+ * (symmetric transfer, so long chains do not grow the stack). A top-level task is started
+ * with Start() and then driven by whatever completes its I2C operations; poll IsDone().
+ * Coroutine frames are allocated with operator new.
+ *
+ * @tparam T Default-constructible result type.
+ */
+template <typename T = bool>
+class [[nodiscard]] Task {
+public:
+  struct promise_type {
+    T value{};
+    ::std::coroutine_handle<> continuation{};
+
+    Task get_return_object() noexcept {
+      return Task(::std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    ::std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+    struct FinalAwaiter {
+      bool await_ready() noexcept {
+        return false;
+      }
+      ::std::coroutine_handle<> await_suspend(
+          ::std::coroutine_handle<promise_type> handle) noexcept {
+        const ::std::coroutine_handle<> next = handle.promise().continuation;
+        return next ? next : ::std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept {
+      return {};
+    }
+    void return_value(T result) noexcept {
+      value = ::std::move(result);
+    }
+    void unhandled_exception() noexcept {
+      ::std::terminate();
+    }
+  };
+
+  Task(Task&& other) noexcept : handle_(::std::exchange(other.handle_, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = ::std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  ~Task() {
+    destroy();
+  }
+
+  /**
+   * @brief Run a top-level task up to its first suspension (do not also co_await it).
+   */
+  void Start() noexcept {
+    if (handle_ && !started_) {
+      started_ = true;
+      handle_.resume();
+    }
+  }
+
+  /** @brief Check whether the task has finished. */
+  [[nodiscard]] bool IsDone() const noexcept {
+    return handle_ && handle_.done();
+  }
+
+  /** @brief Result of a finished task. */
+  [[nodiscard]] const T& GetResult() const noexcept {
+    return handle_.promise().value;
+  }
+
+  bool await_ready() const noexcept {
+    return !handle_ || handle_.done();
+  }
+  ::std::coroutine_handle<> await_suspend(::std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().continuation = awaiting;
+    return handle_;
+  }
+  T await_resume() noexcept {
+    return handle_ ? ::std::move(handle_.promise().value) : T{};
+  }
+
+private:
+  explicit Task(::std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  void destroy() noexcept {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = {};
+    }
+  }
+
+  ::std::coroutine_handle<promise_type> handle_;
+  bool started_{false};
+};
+
+// ============================================================================
+// Async bus
+// ============================================================================
+
+/**
+ * @class I2cOperation
+ * @brief One I2C register transfer submitted to an async bus.
+ *
+ * Lives in the awaiting coroutine's frame until completed, so buses can queue it without
+ * allocating (the `next` field is free for that).
+ */
+class I2cOperation {
+public:
+  enum class Kind : uint8_t { Write, Read };
+
+  Kind kind{Kind::Write};
+  uint8_t addr{0};
+  uint8_t reg{0};
+  const uint8_t* src{nullptr}; ///< Write payload
+  uint8_t* dst{nullptr};       ///< Read buffer
+  size_t len{0};
+  I2cOperation* next{nullptr}; ///< Free for the bus's own queue
+
+  /**
+   * @brief Report the result and resume the waiting coroutine.
+   *
+   * Call exactly once per submitted operation, from any thread, possibly from inside
+   * Submit(). The operation must not be touched afterwards.
+   */
+  void Complete(bool ok) noexcept {
+    result_ = ok;
+    if (state_.exchange(DONE, ::std::memory_order_acq_rel) == SUSPENDED) {
+      handle_.resume();
+    }
+  }
+
+protected:
+  enum : uint8_t { PENDING = 0, SUSPENDED = 1, DONE = 2 };
+
+  ::std::coroutine_handle<> handle_{};
+  ::std::atomic<uint8_t> state_{PENDING};
+  bool result_{false};
+};
+
+/**
+ * @class I2cAwaitable
+ * @brief Awaitable returned by AsyncI2cInterface::Write()/Read(); yields true on success.
+ */
+template <typename Bus>
+class I2cAwaitable : public I2cOperation {
+public:
+  I2cAwaitable(Bus& bus, Kind op_kind, uint8_t op_addr, uint8_t op_reg, const uint8_t* op_src,
+               uint8_t* op_dst, size_t op_len) noexcept
+      : bus_(bus) {
+    kind = op_kind;
+    addr = op_addr;
+    reg = op_reg;
+    src = op_src;
+    dst = op_dst;
+    len = op_len;
+  }
+  I2cAwaitable(const I2cAwaitable&) = delete;
+  I2cAwaitable& operator=(const I2cAwaitable&) = delete;
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(::std::coroutine_handle<> awaiting) noexcept {
+    handle_ = awaiting;
+    bus_.Submit(*this);
+    // Stay running if the bus already completed the operation inside Submit()
+    return state_.exchange(SUSPENDED, ::std::memory_order_acq_rel) != DONE;
+  }
+  bool await_resume() const noexcept {
+    return result_;
+  }
+
+private:
+  Bus& bus_;
+};
+
+/**
+ * @brief CRTP interface for completion-based (non-blocking) I2C buses.
+ *
+ * The derived class queues each operation and completes it later from its own event
+ * loop, interrupt or worker thread, which is what lets one thread keep transfers on many
+ * buses in flight:
+ * @code
+ * class MyAsyncI2c : public pca9685::AsyncI2cInterface<MyAsyncI2c> {
+ * public:
+ *   // Start the transfer; call op.Complete(ok) exactly once when it finishes.
+ *   void Submit(pca9685::I2cOperation& op) noexcept { ... }
+ * };
+ * @endcode
+ *
+ * Buffers passed to Write()/Read() must stay valid until the awaitable completes.
+ *
+ * @tparam Derived The derived class type (CRTP pattern)
+ */
+template <typename Derived>
+class AsyncI2cInterface {
+public:
+  /** @brief Awaitable register write. */
+  I2cAwaitable<Derived> Write(uint8_t addr, uint8_t reg, const uint8_t* data,
+                              size_t len) noexcept {
+    return I2cAwaitable<Derived>(static_cast<Derived&>(*this), I2cOperation::Kind::Write, addr,
+                                 reg, data, nullptr, len);
+  }
+
+  /** @brief Awaitable register read. */
+  I2cAwaitable<Derived> Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    return I2cAwaitable<Derived>(static_cast<Derived&>(*this), I2cOperation::Kind::Read, addr,
+                                 reg, nullptr, data, len);
+  }
+
+  AsyncI2cInterface(const AsyncI2cInterface&) = delete;
+  AsyncI2cInterface& operator=(const AsyncI2cInterface&) = delete;
+
+protected:
+  AsyncI2cInterface() = default;
+  ~AsyncI2cInterface() = default;
+};
+
+/**
+ * @class QueuedBusAdapter
+ * @brief Async bus over a blocking I2cInterface: operations queue until Poll() runs them.
+ *
+ * Lets coroutines on several buses and devices interleave on one thread with the existing
+ * blocking bus implementations: submitted operations are executed in FIFO order by Poll(),
+ * called from the application's loop, and each completion resumes its coroutine, which
+ * may submit the next operation before Poll() moves on. Not thread-safe.
+ *
+ * @tparam Bus Blocking I2cInterface implementation.
+ */
+template <typename Bus>
+class QueuedBusAdapter : public AsyncI2cInterface<QueuedBusAdapter<Bus>> {
+public:
+  explicit QueuedBusAdapter(Bus& bus) noexcept : bus_(bus) {}
+
+  void Submit(I2cOperation& op) noexcept {
+    op.next = nullptr;
+    if (tail_ != nullptr) {
+      tail_->next = &op;
+    } else {
+      head_ = &op;
+    }
+    tail_ = &op;
+  }
+
+  /**
+   * @brief Execute queued operations on the blocking bus.
+   * @param max_ops Maximum number of operations to execute (including ones queued by the
+   *                coroutines resumed meanwhile).
+   * @return Number of operations executed.
+   */
+  size_t Poll(size_t max_ops = SIZE_MAX) noexcept {
+    size_t executed = 0;
+    while (head_ != nullptr && executed < max_ops) {
+      I2cOperation& op = *head_;
+      head_ = op.next;
+      if (head_ == nullptr) {
+        tail_ = nullptr;
+      }
+      bool ok = bus_.EnsureInitialized();
+      if (ok) {
+        ok = op.kind == I2cOperation::Kind::Write ? bus_.Write(op.addr, op.reg, op.src, op.len)
+                                                  : bus_.Read(op.addr, op.reg, op.dst, op.len);
+      }
+      ++executed;
+      op.Complete(ok);
+    }
+    return executed;
+  }
+
+  /** @brief Check whether no operation is queued. */
+  [[nodiscard]] bool IsIdle() const noexcept {
+    return head_ == nullptr;
+  }
+
+private:
+  Bus& bus_;
+  I2cOperation* head_{nullptr};
+  I2cOperation* tail_{nullptr};
+};
+
+// ============================================================================
+// AsyncPCA9685
+// ============================================================================
+
+/**
+ * @class AsyncPCA9685
+ * @brief Coroutine front-end for one PCA9685: every bus operation is `co_await`-able.
+ *
+ * Covers initialisation, frequency, single/all-channel writes and frame staging with
+ * changed-span commits. Register encoding, prescaler math, phase layout and the changed-span
+ * search are PCA9685's own static helpers, and the error flags are PCA9685::Error, so both
+ * front-ends put the same bytes on the bus. Gamma, retries, health tracking, EXTCLK
+ * switching and the power policy stay with the blocking driver (compose them in the
+ * application). One operation may be in flight per device; operations on different devices,
+ * on the same or different buses, run concurrently.
+ *
+ * @code
+ *   pca9685::QueuedBusAdapter<LinuxI2cBus> bus(linux_bus);
+ *   pca9685::AsyncPCA9685<decltype(bus)> board(&bus, 0x40);
+ *
+ *   pca9685::Task<bool> show(pca9685::AsyncPCA9685<decltype(bus)>& dev) {
+ *     if (!co_await dev.EnsureInitializedAsync() || !co_await dev.SetPwmFreqAsync(200.0F)) {
+ *       co_return false;
+ *     }
+ *     dev.StageDutyTicks(0, 1024);
+ *     dev.StageDutyTicks(1, 2048);
+ *     co_return co_await dev.CommitFrameAsync();
+ *   }
+ *
+ *   auto task = show(board);
+ *   task.Start();
+ *   while (!task.IsDone()) {
+ *     bus.Poll();
+ *   }
+ * @endcode
+ *
+ * @tparam AsyncBus AsyncI2cInterface implementation.
+ */
+template <typename AsyncBus>
+class AsyncPCA9685 {
+  /** @brief Blocking driver whose encoding helpers and types this front-end shares. */
+  using Driver = PCA9685<AsyncBus>;
+
+public:
+  using Error = typename Driver::Error;
+  using PhaseMode = typename Driver::PhaseMode;
+  using ChannelImage = typename Driver::ChannelImage;
+
+  static constexpr uint16_t FULL_BIT_ = Driver::FULL_BIT_;
+  static constexpr uint8_t MAX_CHANNELS_ = Driver::MAX_CHANNELS_;
+  static constexpr uint16_t MAX_PWM_ = Driver::MAX_PWM_;
+  static constexpr uint16_t DUTY_FULL_SCALE_ = Driver::DUTY_FULL_SCALE_;
+  static constexpr uint32_t OSC_FREQ_ = Driver::OSC_FREQ_;
+
+  AsyncPCA9685(AsyncBus* bus, uint8_t address) noexcept : bus_(bus), addr_(address) {}
+
+  AsyncPCA9685(const AsyncPCA9685&) = delete;
+  AsyncPCA9685& operator=(const AsyncPCA9685&) = delete;
+
+  /**
+   * @brief Initialise the device (MODE1 reset value with auto-increment) if not done yet.
+   */
+  Task<bool> EnsureInitializedAsync() noexcept {
+    if (initialized_) {
+      co_return true;
+    }
+    const uint8_t mode1 = Driver::MODE1_AI_;
+    if (!co_await bus_->Write(addr_, REG_MODE1_, &mode1, 1)) {
+      setError(Error::I2cWrite);
+      co_return false;
+    }
+    initialized_ = true;
+    last_error_ = Error::None;
+    co_return true;
+  }
+
+  /**
+   * @brief Set the clock frequency used for prescaler math, as PCA9685::SetOscillatorHz().
+   * @param clock_hz Clock frequency in Hz (1-50 MHz); other values are ignored.
+   */
+  void SetOscillatorHz(uint32_t clock_hz) noexcept {
+    if (Driver::IsValidClockHz(clock_hz)) {
+      osc_freq_ = clock_hz;
+    }
+  }
+
+  /** @brief Clock frequency used for prescaler math (Hz). */
+  [[nodiscard]] uint32_t GetOscillatorHz() const noexcept {
+    return osc_freq_;
+  }
+
+  /** @brief Lowest frequency SetPwmFreqAsync() accepts with the current clock (Hz). */
+  [[nodiscard]] float GetMinPwmFreq() const noexcept {
+    return Driver::MinPwmFreq(osc_freq_);
+  }
+
+  /** @brief Highest frequency SetPwmFreqAsync() accepts with the current clock (Hz). */
+  [[nodiscard]] float GetMaxPwmFreq() const noexcept {
+    return Driver::MaxPwmFreq(osc_freq_);
+  }
+
+  /**
+   * @brief Set the PWM frequency (GetMinPwmFreq() to GetMaxPwmFreq()), as
+   * PCA9685::SetPwmFreq().
+   */
+  Task<bool> SetPwmFreqAsync(float freq_hz) noexcept {
+    if (!initialized_) {
+      setError(Error::NotInitialized);
+      co_return false;
+    }
+    if (freq_hz < GetMinPwmFreq() || freq_hz > GetMaxPwmFreq()) {
+      setError(Error::OutOfRange);
+      co_return false;
+    }
+    const uint8_t prescale = Driver::CalcPrescale(freq_hz, osc_freq_);
+    uint8_t old_mode = 0;
+    if (!co_await bus_->Read(addr_, REG_MODE1_, &old_mode, 1)) {
+      setError(Error::I2cRead);
+      co_return false;
+    }
+    const auto sleep = static_cast<uint8_t>((old_mode & 0x7F) | Driver::MODE1_SLEEP_);
+    if (!co_await bus_->Write(addr_, REG_MODE1_, &sleep, 1) ||
+        !co_await bus_->Write(addr_, REG_PRE_SCALE_, &prescale, 1) ||
+        !co_await bus_->Write(addr_, REG_MODE1_, &old_mode, 1)) {
+      setError(Error::I2cWrite);
+      co_return false;
+    }
+    last_error_ = Error::None;
+    co_return true;
+  }
+
+  /**
+   * @brief Select how duty writes stagger the channels' ON edges, as PCA9685::SetPhaseMode().
+   * @param mode Phase mode.
+   * @param phase_base Offset of the first edge in ticks (0-4095).
+   */
+  void SetPhaseMode(PhaseMode mode, uint16_t phase_base = 0) noexcept {
+    phase_mode_ = mode;
+    phase_base_ = phase_base & MAX_PWM_;
+    layoutPhases();
+  }
+
+  /** @brief Get the active phase mode. */
+  [[nodiscard]] PhaseMode GetPhaseMode() const noexcept {
+    return phase_mode_;
+  }
+
+  /**
+   * @brief Get the ON tick currently assigned to a channel's duty writes.
+   * @return Offset in ticks (0-4095), or 0 for an invalid channel.
+   */
+  [[nodiscard]] uint16_t GetPhaseOffset(uint8_t channel) const noexcept {
+    return channel < MAX_CHANNELS_ ? phase_offset_[channel] : 0;
+  }
+
+  /**
+   * @brief Write one channel's ON/OFF ticks (0-4095), as PCA9685::SetPwm().
+   */
+  Task<bool> SetPwmAsync(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept {
+    if (!initialized_) {
+      setError(Error::NotInitialized);
+      co_return false;
+    }
+    if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+      setError(Error::OutOfRange);
+      co_return false;
+    }
+    co_return co_await writeChannel(channel, on_time, off_time);
+  }
+
+  /**
+   * @brief Write one channel's duty cycle (0.0-1.0, clamped) at its phase offset, as
+   * PCA9685::SetDuty().
+   */
+  Task<bool> SetDutyAsync(uint8_t channel, float duty) noexcept {
+    if (!initialized_) {
+      setError(Error::NotInitialized);
+      co_return false;
+    }
+    if (channel >= MAX_CHANNELS_) {
+      setError(Error::OutOfRange);
+      co_return false;
+    }
+    const uint16_t ticks = Driver::DutyToTicks(duty);
+    if (phase_mode_ == PhaseMode::LoadBalanced) {
+      layoutPhases(); // Place the channel after the current duties of the channels before it
+    }
+    const uint16_t on_time = phase_offset_[channel];
+    if (!co_await writeChannel(channel, on_time, (on_time + ticks) & MAX_PWM_)) {
+      co_return false;
+    }
+    if (ticks != 0) {
+      stageDuty(channel, ticks); // Laid out and re-packed like a committed staged duty
+      written_ticks_[channel] = ticks;
+      written_mask_ |= static_cast<uint16_t>(1U << channel);
+    }
+    co_return true;
+  }
+
+  /**
+   * @brief Write every channel at once through ALL_LED, as PCA9685::SetAllPwm().
+   *
+   * With a PhaseMode other than None, the value is written as a duty of
+   * `(off_time - on_time) mod 4096` ticks at each channel's phase offset instead.
+   */
+  Task<bool> SetAllPwmAsync(uint16_t on_time, uint16_t off_time) noexcept {
+    if (!initialized_) {
+      setError(Error::NotInitialized);
+      co_return false;
+    }
+    if (on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+      setError(Error::OutOfRange);
+      co_return false;
+    }
+    if (phase_mode_ != PhaseMode::None) {
+      const uint16_t ticks = (off_time - on_time) & MAX_PWM_;
+      for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+        stageDuty(ch, ticks);
+      }
+      co_return co_await CommitFrameAsync();
+    }
+    const ::std::array<uint8_t, 4> data = Driver::PackChannel(on_time, off_time);
+    if (!co_await bus_->Write(addr_, REG_ALL_LED_ON_L_, data.data(), data.size())) {
+      setError(Error::I2cWrite);
+      co_return false;
+    }
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      store(ch, data.data());
+    }
+    last_error_ = Error::None;
+    co_return true;
+  }
+
+  /**
+   * @brief Stage ON/OFF ticks for a channel in the pending frame (no bus access).
+   * @return true on success; false (OutOfRange) for an invalid channel or value.
+   */
+  bool StagePwm(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept {
+    if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+      setError(Error::OutOfRange);
+      return false;
+    }
+    const ::std::array<uint8_t, 4> data = Driver::PackChannel(on_time, off_time);
+    ::std::copy(data.begin(), data.end(), frame_image_.begin() + (4 * channel));
+    duty_mask_ &= static_cast<uint16_t>(~(1U << channel));
+    return true;
+  }
+
+  /**
+   * @brief Stage a duty in ticks (0 = full off, 4096 = full on) in the pending frame; it is
+   * packed at the channel's phase offset by CommitFrameAsync().
+   * @return true on success; false (OutOfRange) for an invalid channel or value.
+   */
+  bool StageDutyTicks(uint8_t channel, uint16_t ticks) noexcept {
+    if (channel >= MAX_CHANNELS_ || ticks > DUTY_FULL_SCALE_) {
+      setError(Error::OutOfRange);
+      return false;
+    }
+    stageDuty(channel, ticks);
+    return true;
+  }
+
+  /**
+   * @brief Write the pending frame: one burst spanning the channels that changed.
+   * @return true on success (or nothing to write); on failure the frame stays staged.
+   */
+  Task<bool> CommitFrameAsync() noexcept {
+    if (!initialized_) {
+      setError(Error::NotInitialized);
+      co_return false;
+    }
+    layoutPhases();
+    Driver::PackDuties(frame_image_, duty_ticks_, duty_mask_, phase_offset_);
+    uint8_t first = 0;
+    uint8_t count = 0;
+    if (Driver::FindChangedSpan(frame_image_, channel_image_, first, count)) {
+      const size_t offset = 4U * first;
+      const size_t len = 4U * count;
+      if (!co_await bus_->Write(addr_, static_cast<uint8_t>(REG_LED0_ON_L_ + offset),
+                                frame_image_.data() + offset, len)) {
+        setError(Error::I2cWrite);
+        co_return false;
+      }
+      ::std::copy(frame_image_.begin() + offset, frame_image_.begin() + offset + len,
+                  channel_image_.begin() + offset);
+    }
+    written_ticks_ = duty_ticks_;
+    written_mask_ = duty_mask_;
+    last_error_ = Error::None;
+    co_return true;
+  }
+
+  /** @brief Drop staged changes: the pending frame reverts to what was last written. */
+  void DiscardFrame() noexcept {
+    frame_image_ = channel_image_;
+    duty_ticks_ = written_ticks_;
+    duty_mask_ = written_mask_;
+  }
+
+  [[nodiscard]] bool IsInitialized() const noexcept {
+    return initialized_;
+  }
+  [[nodiscard]] uint16_t GetErrorFlags() const noexcept {
+    return error_flags_;
+  }
+  [[nodiscard]] Error GetLastError() const noexcept {
+    return last_error_;
+  }
+  void ClearErrorFlags(uint16_t mask = 0xFFFF) noexcept {
+    error_flags_ &= static_cast<uint16_t>(~mask);
+  }
+
+private:
+  static constexpr auto REG_MODE1_ = static_cast<uint8_t>(Driver::Register::MODE1);
+  static constexpr auto REG_LED0_ON_L_ = static_cast<uint8_t>(Driver::Register::LED0_ON_L);
+  static constexpr auto REG_ALL_LED_ON_L_ = static_cast<uint8_t>(Driver::Register::ALL_LED_ON_L);
+  static constexpr auto REG_PRE_SCALE_ = static_cast<uint8_t>(Driver::Register::PRE_SCALE);
+
+  AsyncBus* bus_;
+  uint8_t addr_;
+  bool initialized_{false};
+  Error last_error_{Error::None};
+  uint16_t error_flags_{0};
+  uint32_t osc_freq_{OSC_FREQ_};
+  /** @brief LEDn registers as last written, and the pending frame. */
+  ChannelImage channel_image_ = Driver::DefaultChannelImage();
+  ChannelImage frame_image_ = Driver::DefaultChannelImage();
+  ::std::array<uint16_t, MAX_CHANNELS_> duty_ticks_{}; ///< Channel duties (valid in duty_mask_)
+  uint16_t duty_mask_{0}; ///< Channels whose frame content is a duty re-packed on commit
+  ::std::array<uint16_t, MAX_CHANNELS_> written_ticks_{}; ///< Duties last written to the device
+  uint16_t written_mask_{0}; ///< Channels whose shadow image content is a duty
+  PhaseMode phase_mode_{PhaseMode::None};
+  uint16_t phase_base_{0};
+  ::std::array<uint16_t, MAX_CHANNELS_> phase_offset_{}; ///< ON tick of each channel's duty
+
+  void setError(Error e) noexcept {
+    last_error_ = e;
+    error_flags_ |= static_cast<uint16_t>(e);
+  }
+
+  void stageDuty(uint8_t channel, uint16_t ticks) noexcept {
+    duty_ticks_[channel] = ticks;
+    duty_mask_ |= static_cast<uint16_t>(1U << channel);
+  }
+
+  void layoutPhases() noexcept {
+    Driver::LayoutPhases(phase_mode_, phase_base_, duty_ticks_, duty_mask_, phase_offset_);
+  }
+
+  /** @brief Record written LEDn bytes in the shadow and the pending frame (a direct write
+   * supersedes anything staged for the channel). */
+  void store(uint8_t channel, const uint8_t* data) noexcept {
+    ::std::copy(data, data + 4, channel_image_.begin() + (4 * channel));
+    ::std::copy(data, data + 4, frame_image_.begin() + (4 * channel));
+    duty_mask_ &= static_cast<uint16_t>(~(1U << channel));
+    written_mask_ &= static_cast<uint16_t>(~(1U << channel));
+  }
+
+  Task<bool> writeChannel(uint8_t channel, uint16_t on_time, uint16_t off_time) noexcept {
+    const ::std::array<uint8_t, 4> data = Driver::PackChannel(on_time, off_time);
+    if (!co_await bus_->Write(addr_, static_cast<uint8_t>(REG_LED0_ON_L_ + (4 * channel)),
+                              data.data(), data.size())) {
+      setError(Error::I2cWrite);
+      co_return false;
+    }
+    store(channel, data.data());
+    last_error_ = Error::None;
+    co_return true;
+  }
+};
+
+} // namespace pca9685
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,245 @@
+/**
+ * @file pca9685_bus_arbiter.hpp
+ * @brief Shared-bus arbitration for several PCA9685 drivers on one I2C bus
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if __has_include(<mutex>)
+#include <mutex>
+#endif
+
+#include "pca9685_i2c_interface.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Lock policy that does nothing (single task, or the bus is already thread-safe).
+ *
+ * A lock policy is any default-constructible type with `void lock() noexcept` and
+ * `void unlock() noexcept`. Platform layers provide RTOS versions (see
+ * `Esp32Pca9685I2cBus::FreeRtosMutexLock` in the ESP32 example).
+ */
+struct NoLock {
+  void lock() noexcept {}
+  void unlock() noexcept {}
+};
+
+/**
+ * @brief Test-and-test-and-set spinlock.
+ *
+ * For tasks on different cores holding the lock only for short transactions. Never use
+ * it between tasks of different priority on one core: a preempted holder blocks the
+ * spinning task forever.
+ */
+class SpinLock {
+public:
+  void lock() noexcept {
+    while (flag_.test_and_set(::std::memory_order_acquire)) {
+      while (flag_.test(::std::memory_order_relaxed)) {
+      }
+    }
+  }
+  void unlock() noexcept {
+    flag_.clear(::std::memory_order_release);
+  }
+
+private:
+  ::std::atomic_flag flag_{};
+};
+
+#if __has_include(<mutex>)
+/**
+ * @brief Lock policy wrapping std::mutex (hosted platforms, ESP-IDF pthreads).
+ */
+class MutexLock {
+public:
+  void lock() noexcept {
+    mutex_.lock();
+  }
+  void unlock() noexcept {
+    mutex_.unlock();
+  }
+
+private:
+  ::std::mutex mutex_;
+};
+#endif
+
+/**
+ * @class BusArbiter
+ * @brief Serialises transactions of several drivers sharing one bus.
+ *
+ * Each driver gets its own Port, which is an I2cInterface and is passed to the driver in
+ * place of the bus. The lock is taken only around each wire transaction, so CPU work in
+ * the drivers (value packing, frame staging, retry back-off) runs concurrently.
+ *
+ * Requests waiting for the lock are merged (flat combining): a port publishes its
+ * request in its slot before taking the lock, and whichever port holds the lock executes
+ * every published request back to back. A waiting task then finds its transaction
+ * already done when it gets the lock, saving a lock hand-off and a context switch per
+ * merged request.
+ *
+ * @code
+ *   using Arbiter =
+ *       pca9685::BusArbiter<Esp32Pca9685I2cBus, Esp32Pca9685I2cBus::FreeRtosMutexLock>;
+ *   Arbiter arbiter(*bus);
+ *   Arbiter::Port port_a(arbiter), port_b(arbiter);
+ *   pca9685::PCA9685<Arbiter::Port> board_a(&port_a, 0x40); // used by task A
+ *   pca9685::PCA9685<Arbiter::Port> board_b(&port_b, 0x41); // used by task B
+ * @endcode
+ *
+ * @tparam Bus Underlying I2cInterface implementation.
+ * @tparam LockPolicy Lock type (NoLock, SpinLock, MutexLock or a platform lock).
+ * @tparam MaxPorts Ports that can merge requests; further ports still work, unmerged.
+ */
+template <typename Bus, typename LockPolicy = NoLock, size_t MaxPorts = 4>
+class BusArbiter {
+  struct Slot;
+
+public:
+  /**
+   * @class Port
+   * @brief Per-driver handle onto the arbitrated bus (one outstanding request at a time,
+   *        so use one Port per driver, each driven by one task).
+   */
+  class Port : public I2cInterface<Port> {
+  public:
+    explicit Port(BusArbiter& arbiter) noexcept : arbiter_(arbiter), slot_(arbiter.claimSlot()) {}
+
+    bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+      return arbiter_.submit(slot_, Op::Write, addr, reg, data, nullptr, len);
+    }
+
+    bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+      return arbiter_.submit(slot_, Op::Read, addr, reg, nullptr, data, len);
+    }
+
+    bool EnsureInitialized() noexcept {
+      return arbiter_.submit(slot_, Op::Init, 0, 0, nullptr, nullptr, 0);
+    }
+
+    void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+      arbiter_.lock_.lock();
+      arbiter_.bus_.GpioSet(pin, signal);
+      arbiter_.lock_.unlock();
+    }
+
+    /** @brief Check whether this port takes part in request merging. */
+    [[nodiscard]] bool IsMerging() const noexcept {
+      return slot_ != nullptr;
+    }
+
+  private:
+    BusArbiter& arbiter_;
+    Slot* slot_;
+  };
+
+  explicit BusArbiter(Bus& bus) noexcept : bus_(bus) {}
+
+  BusArbiter(const BusArbiter&) = delete;
+  BusArbiter& operator=(const BusArbiter&) = delete;
+
+  /** @brief Number of wire transactions executed. */
+  [[nodiscard]] uint32_t GetTransactionCount() const noexcept {
+    return transactions_.load(::std::memory_order_relaxed);
+  }
+
+  /** @brief Number of transactions executed by another port's lock holder (merged). */
+  [[nodiscard]] uint32_t GetMergedCount() const noexcept {
+    return merged_.load(::std::memory_order_relaxed);
+  }
+
+  /** @brief The lock, e.g. to hold the bus across a sequence of operations. */
+  LockPolicy& GetLock() noexcept {
+    return lock_;
+  }
+
+private:
+  enum class Op : uint8_t { Write, Read, Init };
+  enum : uint8_t { IDLE = 0, PENDING = 1, DONE = 2 };
+
+  struct Slot {
+    ::std::atomic<uint8_t> state{IDLE};
+    Op op{Op::Write};
+    uint8_t addr{0};
+    uint8_t reg{0};
+    const uint8_t* src{nullptr}; ///< Write payload
+    uint8_t* dst{nullptr};       ///< Read buffer
+    size_t len{0};
+    bool result{false};
+  };
+
+  Bus& bus_;
+  LockPolicy lock_;
+  ::std::array<Slot, MaxPorts> slots_{};
+  ::std::atomic<size_t> port_count_{0};
+  ::std::atomic<uint32_t> transactions_{0};
+  ::std::atomic<uint32_t> merged_{0};
+
+  Slot* claimSlot() noexcept {
+    const size_t index = port_count_.fetch_add(1, ::std::memory_order_relaxed);
+    return index < MaxPorts ? &slots_[index] : nullptr;
+  }
+
+  bool execute(const Slot& r) noexcept {
+    transactions_.fetch_add(1, ::std::memory_order_relaxed);
+    switch (r.op) {
+    case Op::Write:
+      return bus_.Write(r.addr, r.reg, r.src, r.len);
+    case Op::Read:
+      return bus_.Read(r.addr, r.reg, r.dst, r.len);
+    case Op::Init:
+      return bus_.EnsureInitialized();
+    }
+    return false;
+  }
+
+  bool submit(Slot* own, Op op, uint8_t addr, uint8_t reg, const uint8_t* src, uint8_t* dst,
+              size_t len) noexcept {
+    Slot local;
+    Slot& request = own != nullptr ? *own : local;
+    request.op = op;
+    request.addr = addr;
+    request.reg = reg;
+    request.src = src;
+    request.dst = dst;
+    request.len = len;
+    if (own == nullptr) {
+      lock_.lock();
+      const bool result = execute(request);
+      lock_.unlock();
+      return result;
+    }
+    own->state.store(PENDING, ::std::memory_order_release);
+
+    lock_.lock();
+    // Run every published request, ours included unless a previous holder already did
+    const size_t ports = ::std::min(port_count_.load(::std::memory_order_relaxed), MaxPorts);
+    for (size_t i = 0; i < ports; ++i) {
+      Slot& slot = slots_[i];
+      if (slot.state.load(::std::memory_order_acquire) != PENDING) {
+        continue;
+      }
+      slot.result = execute(slot);
+      if (&slot != own) {
+        merged_.fetch_add(1, ::std::memory_order_relaxed);
+      }
+      slot.state.store(DONE, ::std::memory_order_release);
+    }
+    lock_.unlock();
+
+    // Only the lock holder completes requests, and ours was pending while we held it
+    (void)own->state.load(::std::memory_order_acquire);
+    const bool result = own->result;
+    own->state.store(IDLE, ::std::memory_order_relaxed);
+    return result;
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,422 @@
+/**
+ * @file pca9685_bus_monitor.hpp
+ * @brief I2C bus decorator that accounts wire time per device and bus utilisation
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_i2c_interface.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Reason passed to the BusMonitor warning callback.
+ */
+enum class BusWarning : uint8_t {
+  WindowOverThreshold = 1, ///< A completed window was busier than the warning threshold
+  DemandOverCapacity = 2   ///< CheckDemand(): the projected frame traffic does not fit
+};
+
+/**
+ * @brief Planned frame traffic on one bus, for BusMonitor::ProjectUtilisationPercent().
+ *
+ * Each frame writes @c channels consecutive channels of every board in one burst, as
+ * CommitFrame() does.
+ */
+struct FrameDemand {
+  uint8_t devices = 1;     ///< Boards refreshed every frame
+  uint8_t channels = 16;   ///< Channels written per board and frame (1-16)
+  float frame_hz = 50.0F;  ///< Frame rate in Hz
+};
+
+/**
+ * @class BusMonitor
+ * @brief Decorator over any I2cInterface bus that estimates how busy the bus is.
+ *
+ * Every transfer is charged its wire time, computed from its bit count and the configured
+ * SCL frequency (e.g. `Esp32Pca9685I2cBus::I2CConfig::frequency`): 9 clocks per byte
+ * (address, register, payload) plus START and STOP, and a repeated START and second address
+ * byte for reads. Failed transfers are charged in full. Time is summed per device address
+ * and per window (default one second, timed with the clock set by SetClock()); each completed
+ * window yields a utilisation percentage, and the busiest window is kept as the peak.
+ *
+ * Place one monitor under all drivers on a bus — below a BusArbiter when several tasks share
+ * it — so it sees the whole traffic:
+ *
+ * @code
+ *   pca9685::BusMonitor<MyBus> monitor(bus);
+ *   pca9685::BusMonitor<MyBus>::Config cfg;
+ *   cfg.bus_hz = 400000;
+ *   monitor.Configure(cfg);
+ *   monitor.SetClock(MyBus::NowUs);
+ *   pca9685::PCA9685<pca9685::BusMonitor<MyBus>> board_a(&monitor, 0x40);
+ *   pca9685::PCA9685<pca9685::BusMonitor<MyBus>> board_b(&monitor, 0x41);
+ *   // ... later, from the same task:
+ *   monitor.Update();
+ *   printf("bus %.1f %% (peak %.1f %%)\n", monitor.GetUtilisationPercent(),
+ *          monitor.GetPeakUtilisationPercent());
+ * @endcode
+ *
+ * The figures are wire time only: driver, RTOS and controller overhead between transfers
+ * come on top, so plan for well below 100 % (the default warning threshold is 70 %).
+ * ProjectUtilisationPercent() and CheckDemand() estimate the same figure for planned frame
+ * traffic before it runs, e.g. to decide when boards must move to another bus.
+ *
+ * Not thread-safe: use it from the task that owns the bus (or below an arbiter).
+ *
+ * @tparam Bus Wrapped bus type (an I2cInterface implementation).
+ * @tparam MaxDevices Device addresses tracked individually; traffic to further addresses is
+ *         summed in GetUntrackedStats().
+ */
+template <typename Bus, size_t MaxDevices = 8>
+class BusMonitor : public I2cInterface<BusMonitor<Bus, MaxDevices>> {
+  static_assert(MaxDevices >= 1, "BusMonitor needs at least one device slot");
+
+public:
+  /** @brief Monotonic microsecond clock (may wrap), as for PCA9685::SetClock(). */
+  using ClockFn = uint32_t (*)();
+  /** @brief Warning callback; @p utilisation is the offending figure in percent. */
+  using WarningFn = void (*)(void* context, BusWarning warning, float utilisation);
+
+  /**
+   * @brief Accounting parameters.
+   */
+  struct Config {
+    uint32_t bus_hz = 100000;     ///< SCL frequency in Hz (must be > 0)
+    uint32_t window_us = 1000000; ///< Accounting window (must be > 0)
+    float warn_percent = 70.0F;   ///< Warning threshold for windows and CheckDemand()
+  };
+
+  /**
+   * @brief Traffic of one device address.
+   */
+  struct DeviceStats {
+    uint8_t addr = 0;            ///< 7-bit device address
+    uint32_t transfers = 0;      ///< Write/Read calls
+    uint32_t failed = 0;         ///< Calls the wrapped bus reported as failed
+    uint64_t bytes = 0;          ///< Payload bytes (register address excluded)
+    uint64_t busy_ns = 0;        ///< Wire time since construction or Reset()
+    uint64_t window_busy_ns = 0; ///< Wire time in the last completed window
+  };
+
+  /**
+   * @brief Wrap a bus.
+   * @param bus Bus that performs the transfers; must outlive this object.
+   */
+  explicit BusMonitor(Bus& bus) noexcept : bus_(bus) {}
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    const bool ok = bus_.Write(addr, reg, data, len);
+    account(addr, len, TransferClocks(len, false), ok);
+    return ok;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    const bool ok = bus_.Read(addr, reg, data, len);
+    account(addr, len, TransferClocks(len, true), ok);
+    return ok;
+  }
+
+  bool EnsureInitialized() noexcept {
+    return bus_.EnsureInitialized();
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+    bus_.GpioSet(pin, signal);
+  }
+
+  /**
+   * @brief SCL clock cycles of one register transfer.
+   * @param len Payload bytes (register address excluded).
+   * @param is_read true for a register read (repeated START and second address byte).
+   */
+  [[nodiscard]] static constexpr uint64_t TransferClocks(size_t len, bool is_read) noexcept {
+    const uint64_t bytes = 2U + static_cast<uint64_t>(len) + (is_read ? 1U : 0U);
+    return (9U * bytes) + (is_read ? 3U : 2U);
+  }
+
+  /**
+   * @brief Replace the accounting parameters. Zero bus_hz or window_us are ignored.
+   */
+  void Configure(const Config& config) noexcept {
+    if (config.bus_hz != 0) {
+      config_.bus_hz = config.bus_hz;
+    }
+    if (config.window_us != 0) {
+      config_.window_us = config.window_us;
+    }
+    config_.warn_percent = config.warn_percent;
+  }
+
+  /** @brief Active configuration. */
+  [[nodiscard]] const Config& GetConfig() const noexcept {
+    return config_;
+  }
+
+  /**
+   * @brief Set the clock that times the windows (nullptr = totals only, no windows).
+   */
+  void SetClock(ClockFn fn) noexcept {
+    clock_ = fn;
+    started_ = false;
+  }
+
+  /**
+   * @brief Set the callback for threshold warnings (nullptr = none).
+   * @param fn Called from Write()/Read()/Update() when a window closes over the threshold,
+   *           and from CheckDemand().
+   * @param context Passed back to @p fn.
+   */
+  void SetWarningCallback(WarningFn fn, void* context) noexcept {
+    warn_fn_ = fn;
+    warn_context_ = context;
+  }
+
+  /**
+   * @brief Close the windows that have ended. Call periodically so an idle bus still
+   *        reports (transfers do this too).
+   */
+  void Update() noexcept {
+    if (clock_ != nullptr) {
+      roll(clock_());
+    }
+  }
+
+  /** @brief Utilisation of the last completed window in percent (0 before the first). */
+  [[nodiscard]] float GetUtilisationPercent() const noexcept {
+    return last_percent_;
+  }
+
+  /** @brief Busiest completed window since construction or Reset(), in percent. */
+  [[nodiscard]] float GetPeakUtilisationPercent() const noexcept {
+    return peak_percent_;
+  }
+
+  /** @brief Clock value (µs) at which the busiest window started. */
+  [[nodiscard]] uint32_t GetPeakWindowStartUs() const noexcept {
+    return peak_start_us_;
+  }
+
+  /** @brief Number of completed windows. */
+  [[nodiscard]] uint32_t GetWindowCount() const noexcept {
+    return windows_;
+  }
+
+  /** @brief Completed windows that exceeded the warning threshold. */
+  [[nodiscard]] uint32_t GetOverThresholdCount() const noexcept {
+    return over_threshold_;
+  }
+
+  /** @brief Wire time of all transfers since construction or Reset(), in ns. */
+  [[nodiscard]] uint64_t GetBusyNs() const noexcept {
+    return busy_ns_;
+  }
+
+  /** @brief Number of device addresses tracked so far. */
+  [[nodiscard]] size_t GetDeviceCount() const noexcept {
+    return device_count_;
+  }
+
+  /**
+   * @brief Traffic of the @p index-th address seen (index < GetDeviceCount()).
+   */
+  [[nodiscard]] const DeviceStats& GetDeviceStats(size_t index) const noexcept {
+    return devices_[index < device_count_ ? index : MaxDevices];
+  }
+
+  /**
+   * @brief Traffic of one address, or nullptr if it has not been seen (or is untracked).
+   */
+  [[nodiscard]] const DeviceStats* FindDevice(uint8_t addr) const noexcept {
+    for (size_t i = 0; i < device_count_; ++i) {
+      if (devices_[i].addr == addr) {
+        return &devices_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  /** @brief Traffic to addresses beyond the first MaxDevices (addr is 0). */
+  [[nodiscard]] const DeviceStats& GetUntrackedStats() const noexcept {
+    return devices_[MaxDevices];
+  }
+
+  /**
+   * @brief Share of the last completed window a device kept the bus busy, in percent.
+   */
+  [[nodiscard]] float GetDeviceUtilisationPercent(size_t index) const noexcept {
+    return percentOfWindow(GetDeviceStats(index).window_busy_ns);
+  }
+
+  /**
+   * @brief Projected utilisation of planned frame traffic, in percent.
+   *
+   * Each board costs one burst write of 4 × channels bytes per frame (see TransferClocks());
+   * the result can exceed 100 when the demand does not fit at all.
+   */
+  [[nodiscard]] float ProjectUtilisationPercent(const FrameDemand& demand) const noexcept {
+    const double clocks_per_s = static_cast<double>(demand.devices) *
+                                static_cast<double>(demand.frame_hz) *
+                                static_cast<double>(frameClocks(demand.channels));
+    return static_cast<float>(clocks_per_s * 100.0 / config_.bus_hz);
+  }
+
+  /**
+   * @brief Highest frame rate that keeps @p devices boards of @p channels channels under the
+   *        warning threshold.
+   */
+  [[nodiscard]] float MaxFrameRateHz(uint8_t devices, uint8_t channels) const noexcept {
+    if (devices == 0) {
+      return 0.0F;
+    }
+    const double clocks_per_frame =
+        static_cast<double>(devices) * static_cast<double>(frameClocks(channels));
+    return static_cast<float>(static_cast<double>(config_.bus_hz) * config_.warn_percent /
+                              (100.0 * clocks_per_frame));
+  }
+
+  /**
+   * @brief Check that planned frame traffic fits under the warning threshold.
+   * @return true if it fits; otherwise the warning callback is called with
+   *         BusWarning::DemandOverCapacity and false is returned.
+   */
+  bool CheckDemand(const FrameDemand& demand) noexcept {
+    const float projected = ProjectUtilisationPercent(demand);
+    if (projected <= config_.warn_percent) {
+      return true;
+    }
+    if (warn_fn_ != nullptr) {
+      warn_fn_(warn_context_, BusWarning::DemandOverCapacity, projected);
+    }
+    return false;
+  }
+
+  /** @brief Clear all counters, windows and the device table. */
+  void Reset() noexcept {
+    for (DeviceStats& device : devices_) {
+      device = DeviceStats{};
+    }
+    for (uint64_t& ns : window_device_ns_) {
+      ns = 0;
+    }
+    device_count_ = 0;
+    busy_ns_ = 0;
+    window_ns_ = 0;
+    last_percent_ = 0.0F;
+    peak_percent_ = 0.0F;
+    peak_start_us_ = 0;
+    windows_ = 0;
+    over_threshold_ = 0;
+    started_ = false;
+  }
+
+  /** @brief The wrapped bus. */
+  Bus& GetBus() noexcept {
+    return bus_;
+  }
+
+private:
+  Bus& bus_;
+  Config config_{};
+  ClockFn clock_{nullptr};
+  WarningFn warn_fn_{nullptr};
+  void* warn_context_{nullptr};
+  DeviceStats devices_[MaxDevices + 1]{}; // Last slot: untracked addresses
+  uint64_t window_device_ns_[MaxDevices + 1]{};
+  size_t device_count_{0};
+  uint64_t busy_ns_{0};
+  uint64_t window_ns_{0};
+  uint32_t window_start_us_{0};
+  float last_percent_{0.0F};
+  float peak_percent_{0.0F};
+  uint32_t peak_start_us_{0};
+  uint32_t windows_{0};
+  uint32_t over_threshold_{0};
+  bool started_{false};
+
+  [[nodiscard]] static constexpr uint64_t frameClocks(uint8_t channels) noexcept {
+    return TransferClocks(static_cast<size_t>(channels) * 4U, false);
+  }
+
+  [[nodiscard]] float percentOfWindow(uint64_t ns) const noexcept {
+    return static_cast<float>(static_cast<double>(ns) * 100.0 /
+                              (static_cast<double>(config_.window_us) * 1000.0));
+  }
+
+  size_t slotFor(uint8_t addr) noexcept {
+    for (size_t i = 0; i < device_count_; ++i) {
+      if (devices_[i].addr == addr) {
+        return i;
+      }
+    }
+    if (device_count_ == MaxDevices) {
+      return MaxDevices;
+    }
+    devices_[device_count_].addr = addr;
+    return device_count_++;
+  }
+
+  void account(uint8_t addr, size_t len, uint64_t clocks, bool ok) noexcept {
+    if (clock_ != nullptr) {
+      roll(clock_());
+    }
+    const uint64_t ns = (clocks * 1000000000ULL) / config_.bus_hz;
+    const size_t slot = slotFor(addr);
+    DeviceStats& device = devices_[slot];
+    ++device.transfers;
+    device.failed += ok ? 0U : 1U;
+    device.bytes += len;
+    device.busy_ns += ns;
+    window_device_ns_[slot] += ns;
+    busy_ns_ += ns;
+    window_ns_ += ns;
+  }
+
+  /** @brief Close every window that ended before @p now_us. */
+  void roll(uint32_t now_us) noexcept {
+    if (!started_) {
+      started_ = true;
+      window_start_us_ = now_us;
+      return;
+    }
+    uint32_t elapsed = now_us - window_start_us_;
+    if (elapsed < config_.window_us) {
+      return;
+    }
+    closeWindow(window_ns_);
+    window_ns_ = 0;
+    window_start_us_ += config_.window_us;
+    elapsed -= config_.window_us;
+    // Whole windows without traffic (an idle bus, or Update() not called for a while)
+    const uint32_t idle = elapsed / config_.window_us;
+    if (idle != 0) {
+      closeWindow(0);
+      windows_ += idle - 1U;
+      window_start_us_ += idle * config_.window_us;
+    }
+  }
+
+  void closeWindow(uint64_t ns) noexcept {
+    const float percent = percentOfWindow(ns);
+    ++windows_;
+    last_percent_ = percent;
+    for (size_t i = 0; i <= MaxDevices; ++i) {
+      devices_[i].window_busy_ns = window_device_ns_[i];
+      window_device_ns_[i] = 0;
+    }
+    if (percent > peak_percent_) {
+      peak_percent_ = percent;
+      peak_start_us_ = window_start_us_;
+    }
+    if (percent > config_.warn_percent) {
+      ++over_threshold_;
+      if (warn_fn_ != nullptr) {
+        warn_fn_(warn_context_, BusWarning::WindowOverThreshold, percent);
+      }
+    }
+  }
+};
+
+} // namespace pca9685
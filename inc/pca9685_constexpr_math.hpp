@@ -0,0 +1,109 @@
+/**
+ * @file pca9685_constexpr_math.hpp
+ * @brief Compile-time math helpers used to generate PCA9685 lookup tables
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @namespace pca9685::cmath
+ * @brief constexpr replacements for the <cmath> functions needed by table generators.
+ *
+ * `std::sin`, `std::exp`, `std::pow`, ... are not constexpr before C++26, so tables built from them
+ * would have to be computed at start-up. These versions use range reduction plus a short
+ * series and are accurate to well below one 16-bit step; they are intended for constant
+ * evaluation (initialising `constexpr` tables), not for hot paths.
+ */
+namespace cmath {
+
+inline constexpr double PI = 3.14159265358979323846;
+inline constexpr double LN2 = 0.69314718055994530942;
+
+/** @brief Round to the nearest integer (halves away from zero). */
+constexpr int64_t Round(double x) noexcept {
+  return x >= 0.0 ? static_cast<int64_t>(x + 0.5) : -static_cast<int64_t>(-x + 0.5);
+}
+
+/** @brief Sine of @p x radians. */
+constexpr double Sin(double x) noexcept {
+  x -= 2.0 * PI * static_cast<double>(Round(x / (2.0 * PI))); // [-pi, pi]
+  if (x > PI / 2.0) {
+    x = PI - x; // sin(pi - x) == sin(x): fold into [-pi/2, pi/2]
+  } else if (x < -PI / 2.0) {
+    x = -PI - x;
+  }
+  const double x2 = x * x;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n <= 8; ++n) {
+    term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+/** @brief Cosine of @p x radians. */
+constexpr double Cos(double x) noexcept {
+  return Sin(x + (PI / 2.0));
+}
+
+/** @brief e raised to @p x. */
+constexpr double Exp(double x) noexcept {
+  if (x < -700.0) {
+    return 0.0;
+  }
+  const int64_t k = Round(x / LN2); // x = k * ln2 + r, |r| <= ln2 / 2
+  const double r = x - (static_cast<double>(k) * LN2);
+  double term = 1.0;
+  double sum = 1.0;
+  for (int n = 1; n <= 14; ++n) {
+    term *= r / static_cast<double>(n);
+    sum += term;
+  }
+  for (int64_t i = 0; i < k; ++i) {
+    sum *= 2.0;
+  }
+  for (int64_t i = 0; i > k; --i) {
+    sum *= 0.5;
+  }
+  return sum;
+}
+
+/** @brief Natural logarithm of @p x (returns a large negative value for x <= 0). */
+constexpr double Log(double x) noexcept {
+  if (x <= 0.0) {
+    return -1.0e300;
+  }
+  int k = 0; // x = m * 2^k with m in [sqrt(1/2), sqrt(2))
+  while (x > 1.4142135623730951) {
+    x *= 0.5;
+    ++k;
+  }
+  while (x < 0.7071067811865476) {
+    x *= 2.0;
+    --k;
+  }
+  const double z = (x - 1.0) / (x + 1.0); // ln(m) = 2 * atanh(z), |z| <= 0.172
+  const double z2 = z * z;
+  double term = z;
+  double sum = z;
+  for (int n = 1; n <= 10; ++n) {
+    term *= z2;
+    sum += term / static_cast<double>((2 * n) + 1);
+  }
+  return (2.0 * sum) + (static_cast<double>(k) * LN2);
+}
+
+/** @brief @p base raised to @p exponent, for base >= 0. */
+constexpr double Pow(double base, double exponent) noexcept {
+  if (base <= 0.0) {
+    return exponent == 0.0 ? 1.0 : 0.0;
+  }
+  return Exp(exponent * Log(base));
+}
+
+} // namespace cmath
+} // namespace pca9685
@@ -0,0 +1,188 @@
+/**
+ * @file pca9685_device_health.hpp
+ * @brief Per-device health tracking and circuit breaker for the PCA9685 driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class DeviceHealth
+ * @brief Tracks transfer outcomes for one device and implements a circuit breaker.
+ *
+ * States:
+ * - **Closed**: normal operation; every transfer goes to the bus.
+ * - **Open**: the device failed `failure_threshold` transfers in a row; transfers are
+ *   rejected without touching the bus until `cooldown_us` has elapsed.
+ * - **HalfOpen**: the cool-down expired and the driver is probing the device. A successful
+ *   probe closes the breaker; a failed probe re-opens it for another cool-down.
+ *
+ * The class is pure bookkeeping: timestamps are supplied by the caller (the driver's
+ * ClockFn), so it has no platform dependencies. With `failure_threshold == 0` the breaker
+ * never opens and only the statistics are maintained.
+ */
+class DeviceHealth {
+public:
+  /**
+   * @brief Circuit breaker state.
+   */
+  enum class State : uint8_t {
+    Closed = 0,  ///< Device healthy, transfers allowed
+    Open = 1,    ///< Device considered dead, transfers skipped until cool-down expires
+    HalfOpen = 2 ///< Cool-down expired, probing the device
+  };
+
+  /**
+   * @brief Circuit breaker configuration.
+   */
+  struct Config {
+    uint8_t failure_threshold = 0; ///< Consecutive failed transfers that trip (0 = disabled)
+    uint32_t cooldown_us = 100000; ///< Time the breaker stays open before the next probe
+  };
+
+  constexpr DeviceHealth() noexcept = default;
+
+  /**
+   * @brief Replace the configuration; closes the breaker.
+   * @param config New configuration.
+   */
+  void Configure(const Config& config) noexcept {
+    config_ = config;
+    state_ = State::Closed;
+  }
+
+  /**
+   * @brief Get the active configuration.
+   */
+  [[nodiscard]] const Config& GetConfig() const noexcept {
+    return config_;
+  }
+
+  /**
+   * @brief Check whether a transfer may go to the bus right now.
+   * @return true when closed or half-open; false while open.
+   */
+  [[nodiscard]] bool AllowsTransfer() const noexcept {
+    return state_ != State::Open;
+  }
+
+  /**
+   * @brief Check whether an open breaker's cool-down has expired.
+   * @param now_us Current time (µs, wrap-around safe).
+   * @return true if the breaker is open and a probe is due.
+   */
+  [[nodiscard]] bool ProbeDue(uint32_t now_us) const noexcept {
+    return state_ == State::Open && (now_us - opened_at_us_) >= config_.cooldown_us;
+  }
+
+  /**
+   * @brief Enter the half-open state before probing the device.
+   */
+  void BeginProbe() noexcept {
+    state_ = State::HalfOpen;
+    ++probes_;
+  }
+
+  /**
+   * @brief Record a successful transfer.
+   * @param now_us Current time (µs).
+   * @return true if this success closed a half-open breaker (device recovered).
+   */
+  bool RecordSuccess(uint32_t now_us) noexcept {
+    consecutive_failures_ = 0;
+    last_success_us_ = now_us;
+    has_succeeded_ = true;
+    if (state_ == State::HalfOpen) {
+      state_ = State::Closed;
+      ++recoveries_;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Record a failed transfer (after all permitted retries).
+   * @param now_us Current time (µs).
+   * @return true if this failure opened (or re-opened) the breaker.
+   */
+  bool RecordFailure(uint32_t now_us) noexcept {
+    if (consecutive_failures_ != UINT16_MAX) {
+      ++consecutive_failures_;
+    }
+    const bool trip = state_ == State::HalfOpen ||
+                      (state_ == State::Closed && config_.failure_threshold != 0 &&
+                       consecutive_failures_ >= config_.failure_threshold);
+    if (trip) {
+      if (state_ == State::Closed) {
+        ++trips_;
+      }
+      state_ = State::Open;
+      opened_at_us_ = now_us;
+    }
+    return trip;
+  }
+
+  /**
+   * @brief Record a transfer rejected because the breaker was open.
+   */
+  void RecordSkipped() noexcept {
+    ++skipped_;
+  }
+
+  /**
+   * @brief Force the breaker closed and clear the failure streak (PCA9685::Reset() does this).
+   */
+  void ForceClose() noexcept {
+    state_ = State::Closed;
+    consecutive_failures_ = 0;
+  }
+
+  /** @brief Current breaker state. */
+  [[nodiscard]] State GetState() const noexcept {
+    return state_;
+  }
+  /** @brief Consecutive failed transfers since the last success. */
+  [[nodiscard]] uint16_t GetConsecutiveFailures() const noexcept {
+    return consecutive_failures_;
+  }
+  /** @brief Timestamp (µs) of the last successful transfer; valid if HasSucceeded(). */
+  [[nodiscard]] uint32_t GetLastSuccessUs() const noexcept {
+    return last_success_us_;
+  }
+  /** @brief true once at least one transfer has succeeded. */
+  [[nodiscard]] bool HasSucceeded() const noexcept {
+    return has_succeeded_;
+  }
+  /** @brief Number of times the breaker opened from the closed state. */
+  [[nodiscard]] uint32_t GetTripCount() const noexcept {
+    return trips_;
+  }
+  /** @brief Number of probes issued while open. */
+  [[nodiscard]] uint32_t GetProbeCount() const noexcept {
+    return probes_;
+  }
+  /** @brief Number of successful recoveries (half-open -> closed). */
+  [[nodiscard]] uint32_t GetRecoveryCount() const noexcept {
+    return recoveries_;
+  }
+  /** @brief Number of transfers skipped while the breaker was open. */
+  [[nodiscard]] uint32_t GetSkippedCount() const noexcept {
+    return skipped_;
+  }
+
+private:
+  Config config_{};
+  State state_{State::Closed};
+  bool has_succeeded_{false};
+  uint16_t consecutive_failures_{0};
+  uint32_t last_success_us_{0};
+  uint32_t opened_at_us_{0};
+  uint32_t trips_{0};
+  uint32_t probes_{0};
+  uint32_t recoveries_{0};
+  uint32_t skipped_{0};
+};
+
+} // namespace pca9685
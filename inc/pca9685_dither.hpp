@@ -0,0 +1,163 @@
+/**
+ * @file pca9685_dither.hpp
+ * @brief Sigma-delta temporal dithering of 16-bit duty targets onto the PCA9685's 12 bits
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class Dither
+ * @brief Per-channel first-order sigma-delta modulator for higher effective resolution.
+ *
+ * Targets are 16-bit duties (0 = off, 65535 = full on), i.e. 4 bits finer than a PWM
+ * tick. Each Step() outputs, per channel, the tick value just below or just above the
+ * target; the rounding error is carried to the next frame, so the average over 16 frames
+ * equals the target exactly. At low brightness, where one tick is a visible step, this
+ * turns the 12-bit staircase into a smooth 16-bit ramp.
+ *
+ * Only channels whose output changed are staged, and a channel sitting exactly on a tick
+ * never changes, so bus traffic is one CommitFrame() burst covering the dithering
+ * channels. To limit it further, SetThreshold() confines dithering to the low end, where
+ * it is visible:
+ *
+ * @code
+ *   pca9685::Dither<16> dither;
+ *   dither.SetThreshold(256); // dither below 1/16 duty only
+ *   dither.SetTarget(0, 100); // 6.25 ticks
+ *   ...
+ *   // every frame (faster than the eye integrates, e.g. at the PWM frequency):
+ *   if (dither.Step() != 0) {
+ *     dither.Stage(driver);
+ *     driver.CommitFrame();
+ *   }
+ * @endcode
+ *
+ * @tparam NumChannels Number of channels (16 per PCA9685).
+ */
+template <size_t NumChannels = 16>
+class Dither {
+public:
+  static constexpr uint16_t FULL_SCALE_ = 4096; ///< Output ticks meaning "fully on"
+  static constexpr uint8_t FRAC_BITS_ = 4;      ///< Target bits below one tick
+
+  /**
+   * @brief Set a channel's 16-bit target duty.
+   * @param channel Channel index.
+   * @param level 0 (off) to 65535 (full on).
+   * @return true on success; false for an invalid channel.
+   */
+  bool SetTarget(size_t channel, uint16_t level) noexcept {
+    if (channel >= NumChannels) {
+      return false;
+    }
+    // 0-65535 -> 0-65536, so full scale is exactly FULL_SCALE_ << FRAC_BITS_
+    target_[channel] = level + (static_cast<uint32_t>(level) >> 15U);
+    return true;
+  }
+
+  /**
+   * @brief Set every channel's target duty.
+   */
+  void SetAllTargets(uint16_t level) noexcept {
+    for (size_t ch = 0; ch < NumChannels; ++ch) {
+      (void)SetTarget(ch, level);
+    }
+  }
+
+  /**
+   * @brief Dither only targets below @p ticks; higher targets are rounded to a tick.
+   * @param ticks Threshold in ticks (FULL_SCALE_, the default, dithers everything).
+   */
+  void SetThreshold(uint16_t ticks) noexcept {
+    threshold_ = static_cast<uint32_t>(ticks) << FRAC_BITS_;
+  }
+
+  /**
+   * @brief Compute the next frame's outputs.
+   * @return Bitmask of the channels 0-31 whose output changed (use IsChanged() for
+   *         channels from 32 up).
+   */
+  uint32_t Step() noexcept {
+    uint32_t mask = 0;
+    for (size_t ch = 0; ch < NumChannels; ++ch) {
+      const uint32_t target = target_[ch];
+      uint32_t ticks = target >> FRAC_BITS_;
+      const uint32_t frac = target & ((1U << FRAC_BITS_) - 1U);
+      if (target >= threshold_) {
+        ticks += frac >> (FRAC_BITS_ - 1U); // Round to nearest
+        error_[ch] = 0;
+      } else {
+        error_[ch] = static_cast<uint8_t>(error_[ch] + frac);
+        if (error_[ch] >= (1U << FRAC_BITS_)) {
+          error_[ch] = static_cast<uint8_t>(error_[ch] - (1U << FRAC_BITS_));
+          ++ticks;
+        }
+      }
+      const auto out = static_cast<uint16_t>(ticks > FULL_SCALE_ ? FULL_SCALE_ : ticks);
+      changed_[ch] = out != output_[ch];
+      output_[ch] = out;
+      if (changed_[ch] && ch < 32) {
+        mask |= 1U << ch;
+      }
+    }
+    return mask;
+  }
+
+  /**
+   * @brief Stage the channels changed by the last Step() into a driver's pending frame.
+   * @tparam Driver A PCA9685 driver type.
+   * @param driver Driver to stage into (follow with CommitFrame()).
+   * @param first_channel Channel mapped to driver channel 0 (16 channels per driver).
+   * @return true if every changed channel was staged.
+   */
+  template <typename Driver>
+  bool Stage(Driver& driver, size_t first_channel = 0) const noexcept {
+    if (first_channel >= NumChannels) {
+      return false;
+    }
+    const size_t count = (NumChannels - first_channel) < 16 ? (NumChannels - first_channel) : 16;
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+      if (changed_[first_channel + i]) {
+        ok &= driver.StageDutyTicks(static_cast<uint8_t>(i), output_[first_channel + i]);
+      }
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Mark every channel changed so the next Stage() writes all of them.
+   */
+  void Invalidate() noexcept {
+    changed_.fill(true);
+  }
+
+  /** @brief Output of a channel (0-4096 ticks) from the last Step(). */
+  [[nodiscard]] uint16_t GetOutput(size_t channel) const noexcept {
+    return channel < NumChannels ? output_[channel] : 0;
+  }
+
+  /** @brief Check whether a channel's output changed in the last Step(). */
+  [[nodiscard]] bool IsChanged(size_t channel) const noexcept {
+    return channel < NumChannels && changed_[channel];
+  }
+
+  /** @brief Target of a channel in 1/16 ticks (0-65536). */
+  [[nodiscard]] uint32_t GetTarget(size_t channel) const noexcept {
+    return channel < NumChannels ? target_[channel] : 0;
+  }
+
+private:
+  ::std::array<uint32_t, NumChannels> target_{}; ///< Targets in ticks << FRAC_BITS_
+  ::std::array<uint16_t, NumChannels> output_{};
+  ::std::array<uint8_t, NumChannels> error_{}; ///< Carried rounding error, < 1 << FRAC_BITS_
+  ::std::array<bool, NumChannels> changed_{};
+  uint32_t threshold_{static_cast<uint32_t>(FULL_SCALE_) << FRAC_BITS_};
+};
+
+} // namespace pca9685
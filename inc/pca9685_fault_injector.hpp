@@ -0,0 +1,332 @@
+/**
+ * @file pca9685_fault_injector.hpp
+ * @brief I2C bus decorator that injects NACKs, timeouts and stuck-bus conditions
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_i2c_interface.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Kind of fault injected into a transfer.
+ */
+enum class BusFault : uint8_t {
+  None = 0,    ///< Transfer passed through to the wrapped bus
+  Nack = 1,    ///< Address or data NACK: fails at once
+  Timeout = 2, ///< No completion: fails after Config::timeout_us
+  StuckBus = 3 ///< SDA held low: this and following transfers time out until the bus recovers
+};
+
+/**
+ * @class FaultInjectingBus
+ * @brief Decorator over any I2cInterface bus that fails transfers on purpose.
+ *
+ * Faults come from three sources, checked in this order for each transfer:
+ * - **Scripted**: FailNext() fails the next n transfers with a given fault.
+ * - **Pattern**: every `every_n`-th transfer fails.
+ * - **Random**: independent per-transfer probabilities (parts per million, xorshift32, seeded
+ *   with Seed() for repeatable runs).
+ *
+ * A NACK or timeout from the pattern or random source repeats for `burst_length`
+ * consecutive transfers, modelling a noise burst.
+ *
+ * A failed transfer never reaches the wrapped bus, so the device is unchanged. While the bus
+ * is stuck every transfer times out, for `stuck_transfers` transfers or until
+ * ClearStuckBus() (the equivalent of a bus-clear sequence).
+ *
+ * The time a transfer costs is passed to an optional delay callback: a timeout costs
+ * `timeout_us`, and with `bus_hz` set every transfer also costs its nominal wire time. On a
+ * workstation the callback advances a virtual clock that is also given to the driver's
+ * SetClock() and SetRetryDelayUs(), so the driver's latency histograms show the effect of a
+ * fault rate and retry policy without real hardware or real waiting:
+ *
+ * @code
+ *   static uint32_t now_us = 0;
+ *   static uint32_t Now() { return now_us; }
+ *   static void Spend(uint32_t us) { now_us += us; }
+ *
+ *   pca9685::FaultInjectingBus<MyBus> faulty(bus);
+ *   pca9685::FaultInjectingBus<MyBus>::Config cfg;
+ *   cfg.nack_ppm = 20000;    // 2 % of transfers NACK
+ *   cfg.timeout_ppm = 1000;  // 0.1 % time out after 1 ms
+ *   cfg.bus_hz = 400000;
+ *   faulty.Configure(cfg);
+ *   faulty.SetDelayUs(Spend);
+ *
+ *   pca9685::PCA9685<pca9685::FaultInjectingBus<MyBus>> pwm(&faulty, 0x40);
+ *   pwm.SetClock(Now);
+ *   pwm.SetRetryDelayUs(Spend);
+ *   // ... run a workload, then read pwm.GetLatencyHistogram(...) and faulty.GetStats()
+ * @endcode
+ *
+ * Not thread-safe: use it from the task that owns the bus.
+ *
+ * @tparam Bus Wrapped bus type (an I2cInterface implementation).
+ */
+template <typename Bus>
+class FaultInjectingBus : public I2cInterface<FaultInjectingBus<Bus>> {
+public:
+  /** @brief Callback that spends (or accounts for) a duration in microseconds. */
+  using DelayUsFn = void (*)(uint32_t delay_us);
+
+  /**
+   * @brief Fault rates and patterns. The default injects nothing.
+   */
+  struct Config {
+    uint32_t nack_ppm = 0;                   ///< NACK probability per transfer (ppm)
+    uint32_t timeout_ppm = 0;                ///< Timeout probability per transfer (ppm)
+    uint32_t stuck_ppm = 0;                  ///< Stuck-bus probability per transfer (ppm)
+    uint32_t every_n = 0;                    ///< Also fail every n-th transfer (0 = off)
+    BusFault every_n_fault = BusFault::Nack; ///< Fault used by the every_n pattern
+    uint8_t burst_length = 1;                ///< Consecutive transfers hit per NACK / timeout
+    uint32_t timeout_us = 1000;              ///< Duration of a timed-out transfer
+    uint32_t stuck_transfers = 16;           ///< Transfers per stuck event (0 = until cleared)
+    uint32_t bus_hz = 0;                     ///< SCL frequency for wire-time accounting (0 = off)
+  };
+
+  /**
+   * @brief Counters since construction or ResetStats().
+   */
+  struct Stats {
+    uint32_t transfers = 0;      ///< Write/Read calls
+    uint32_t passed = 0;         ///< Transfers forwarded to the wrapped bus
+    uint32_t nacks = 0;          ///< Transfers failed with a NACK
+    uint32_t timeouts = 0;       ///< Transfers failed with a timeout (excluding stuck bus)
+    uint32_t stuck_failures = 0; ///< Transfers failed while the bus was stuck
+    uint32_t stuck_events = 0;   ///< Times the bus got stuck
+    uint64_t charged_us = 0;     ///< Time passed to the delay callback
+  };
+
+  /**
+   * @brief Wrap a bus.
+   * @param bus Bus that performs the transfers that are not failed; must outlive this object.
+   */
+  explicit FaultInjectingBus(Bus& bus) noexcept : bus_(bus) {}
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    if (inject(len)) {
+      return false;
+    }
+    ++stats_.passed;
+    return bus_.Write(addr, reg, data, len);
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    // A register read also sends the register address and a repeated START
+    if (inject(len + 2)) {
+      return false;
+    }
+    ++stats_.passed;
+    return bus_.Read(addr, reg, data, len);
+  }
+
+  bool EnsureInitialized() noexcept {
+    return bus_.EnsureInitialized();
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+    bus_.GpioSet(pin, signal);
+  }
+
+  /**
+   * @brief Replace the fault configuration (pending bursts and a stuck bus are kept).
+   */
+  void Configure(const Config& config) noexcept {
+    config_ = config;
+  }
+
+  /** @brief Active configuration. */
+  [[nodiscard]] const Config& GetConfig() const noexcept {
+    return config_;
+  }
+
+  /**
+   * @brief Seed the random fault generator.
+   * @param seed Any value; 0 is replaced by a fixed non-zero seed.
+   */
+  void Seed(uint32_t seed) noexcept {
+    rng_state_ = seed != 0 ? seed : DEFAULT_SEED_;
+  }
+
+  /**
+   * @brief Set the callback that spends transfer time (nullptr = time is only counted).
+   */
+  void SetDelayUs(DelayUsFn fn) noexcept {
+    delay_us_ = fn;
+  }
+
+  /**
+   * @brief Fail the next @p count transfers with @p fault, before any pattern or random fault.
+   * @param count Number of transfers (0 cancels).
+   * @param fault Fault to inject; BusFault::StuckBus holds the bus stuck for @p count
+   *              transfers.
+   */
+  void FailNext(uint32_t count, BusFault fault = BusFault::Nack) noexcept {
+    if (fault == BusFault::StuckBus) {
+      scripted_count_ = 0;
+      stuck_ = count != 0;
+      stuck_remaining_ = count;
+      stats_.stuck_events += stuck_ ? 1U : 0U;
+      return;
+    }
+    scripted_count_ = fault == BusFault::None ? 0 : count;
+    scripted_fault_ = fault;
+  }
+
+  /** @brief Number of scripted failures not yet used. */
+  [[nodiscard]] uint32_t GetPendingFailures() const noexcept {
+    return scripted_count_;
+  }
+
+  /**
+   * @brief Release a stuck bus, as a bus-clear sequence would.
+   */
+  void ClearStuckBus() noexcept {
+    stuck_ = false;
+    stuck_remaining_ = 0;
+  }
+
+  /** @brief Check whether the bus is currently stuck. */
+  [[nodiscard]] bool IsStuck() const noexcept {
+    return stuck_;
+  }
+
+  /** @brief Counters; see Stats. */
+  [[nodiscard]] const Stats& GetStats() const noexcept {
+    return stats_;
+  }
+
+  /** @brief Total number of transfers failed on purpose. */
+  [[nodiscard]] uint32_t GetInjectedCount() const noexcept {
+    return stats_.nacks + stats_.timeouts + stats_.stuck_failures;
+  }
+
+  /** @brief Reset the counters. */
+  void ResetStats() noexcept {
+    stats_ = Stats{};
+  }
+
+  /** @brief The wrapped bus. */
+  Bus& GetBus() noexcept {
+    return bus_;
+  }
+
+private:
+  static constexpr uint32_t DEFAULT_SEED_ = 0x2545F491U;
+  static constexpr uint32_t PPM_ = 1000000;
+
+  Bus& bus_;
+  Config config_{};
+  Stats stats_{};
+  DelayUsFn delay_us_{nullptr};
+  uint32_t rng_state_{DEFAULT_SEED_};
+  uint32_t scripted_count_{0};
+  BusFault scripted_fault_{BusFault::Nack};
+  uint32_t burst_remaining_{0};
+  BusFault burst_fault_{BusFault::None};
+  uint32_t stuck_remaining_{0};
+  bool stuck_{false};
+
+  /**
+   * @brief Decide the fault for one transfer and charge its time.
+   * @param payload Bytes after the address byte (register address excluded).
+   * @return true if the transfer must fail.
+   */
+  bool inject(size_t payload) noexcept {
+    ++stats_.transfers;
+    const BusFault fault = nextFault();
+    switch (fault) {
+    case BusFault::None:
+      // START + address + register + payload + STOP, 9 clocks per byte
+      charge(wireTimeUs(payload + 2));
+      return false;
+    case BusFault::Nack:
+      ++stats_.nacks;
+      charge(wireTimeUs(1));
+      return true;
+    case BusFault::Timeout:
+      ++stats_.timeouts;
+      charge(config_.timeout_us);
+      return true;
+    case BusFault::StuckBus:
+      ++stats_.stuck_failures;
+      charge(config_.timeout_us);
+      return true;
+    }
+    return false;
+  }
+
+  BusFault nextFault() noexcept {
+    if (stuck_) {
+      if (stuck_remaining_ != 0 && --stuck_remaining_ == 0) {
+        stuck_ = false;
+      }
+      return BusFault::StuckBus;
+    }
+    if (scripted_count_ != 0) {
+      --scripted_count_;
+      return scripted_fault_;
+    }
+    if (burst_remaining_ != 0) {
+      --burst_remaining_;
+      return burst_fault_;
+    }
+    BusFault fault = BusFault::None;
+    if (config_.every_n != 0 && stats_.transfers % config_.every_n == 0) {
+      fault = config_.every_n_fault;
+    } else if (config_.nack_ppm != 0 || config_.timeout_ppm != 0 || config_.stuck_ppm != 0) {
+      const uint32_t roll = nextRandom() % PPM_;
+      if (roll < config_.nack_ppm) {
+        fault = BusFault::Nack;
+      } else if (roll - config_.nack_ppm < config_.timeout_ppm) {
+        fault = BusFault::Timeout;
+      } else if (roll - config_.nack_ppm - config_.timeout_ppm < config_.stuck_ppm) {
+        fault = BusFault::StuckBus;
+      }
+    }
+    if (fault == BusFault::StuckBus) {
+      // This transfer is the first of the event
+      ++stats_.stuck_events;
+      stuck_ = config_.stuck_transfers != 1;
+      stuck_remaining_ = config_.stuck_transfers == 0 ? 0 : config_.stuck_transfers - 1;
+    } else if (fault != BusFault::None && config_.burst_length > 1) {
+      burst_remaining_ = config_.burst_length - 1U;
+      burst_fault_ = fault;
+    }
+    return fault;
+  }
+
+  [[nodiscard]] uint32_t wireTimeUs(size_t bytes) const noexcept {
+    if (config_.bus_hz == 0) {
+      return 0;
+    }
+    const uint64_t clocks = (9U * (static_cast<uint64_t>(bytes) + 1U)) + 2U;
+    return static_cast<uint32_t>((clocks * 1000000U + config_.bus_hz - 1U) / config_.bus_hz);
+  }
+
+  void charge(uint32_t us) noexcept {
+    if (us == 0) {
+      return;
+    }
+    stats_.charged_us += us;
+    if (delay_us_) {
+      delay_us_(us);
+    }
+  }
+
+  /** @brief xorshift32 step. */
+  uint32_t nextRandom() noexcept {
+    uint32_t x = rng_state_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state_ = x;
+    return x;
+  }
+};
+
+} // namespace pca9685
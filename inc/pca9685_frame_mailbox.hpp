@@ -0,0 +1,153 @@
+/**
+ * @file pca9685_frame_mailbox.hpp
+ * @brief Lock-free single-producer / single-consumer latest-frame mailbox (triple buffer)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class TripleBuffer
+ * @brief Wait-free handoff of the latest value from one producer to one consumer.
+ *
+ * Three slots rotate between the producer (back), the consumer (front) and a shared
+ * middle slot. Publishing writes the back slot and swaps it with the middle one;
+ * consuming swaps the middle slot with the front one if it holds something new. Both
+ * are a single atomic exchange, never wait for the other side, and allocate nothing. If
+ * the producer publishes faster than the consumer takes, intermediate values are
+ * overwritten: the consumer always gets the most recent one.
+ *
+ * Exactly one task may call Publish() and exactly one (possibly on another core) may
+ * call Consume()/Front().
+ *
+ * @tparam T Copyable value type.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer() noexcept = default;
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+   * @brief Publish a value (producer side, wait-free).
+   */
+  void Publish(const T& value) noexcept {
+    slots_[back_].value = value;
+    back_ = static_cast<uint8_t>(
+        middle_.exchange(static_cast<uint8_t>(back_ | FRESH_), ::std::memory_order_acq_rel) &
+        INDEX_MASK_);
+    published_.fetch_add(1, ::std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Take the latest published value, if any (consumer side, wait-free).
+   * @return true if Front() now holds a value not seen before.
+   */
+  bool Consume() noexcept {
+    if ((middle_.load(::std::memory_order_relaxed) & FRESH_) == 0) {
+      return false;
+    }
+    front_ = static_cast<uint8_t>(middle_.exchange(front_, ::std::memory_order_acq_rel) &
+                                  INDEX_MASK_);
+    consumed_.fetch_add(1, ::std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Value taken by the last successful Consume() (consumer side).
+   */
+  [[nodiscard]] const T& Front() const noexcept {
+    return slots_[front_].value;
+  }
+
+  /** @brief Number of values published. */
+  [[nodiscard]] uint32_t GetPublishCount() const noexcept {
+    return published_.load(::std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of published values overwritten before the consumer took them
+   *        (approximate while both sides are running).
+   */
+  [[nodiscard]] uint32_t GetOverwrittenCount() const noexcept {
+    const uint32_t consumed = consumed_.load(::std::memory_order_relaxed);
+    const uint32_t published = published_.load(::std::memory_order_relaxed);
+    const bool pending = (middle_.load(::std::memory_order_relaxed) & FRESH_) != 0;
+    return published - consumed - (pending ? 1U : 0U);
+  }
+
+private:
+  static constexpr uint8_t INDEX_MASK_ = 0x03; ///< Slot index bits of middle_
+  static constexpr uint8_t FRESH_ = 0x04;      ///< middle_ holds an unconsumed value
+
+  /** @brief Slots on separate cache lines so producer and consumer do not false-share. */
+  struct alignas(64) Slot {
+    T value{};
+  };
+
+  ::std::array<Slot, 3> slots_{};
+  alignas(64) ::std::atomic<uint8_t> middle_{1};
+  alignas(64) uint8_t back_{0}; ///< Producer-owned
+  ::std::atomic<uint32_t> published_{0};
+  alignas(64) uint8_t front_{2}; ///< Consumer-owned
+  ::std::atomic<uint32_t> consumed_{0};
+};
+
+/**
+ * @brief Complete duty state of one PCA9685: ticks 0-4096 per channel (as StageDutyTicks()).
+ */
+struct ChannelFrame {
+  ::std::array<uint16_t, 16> ticks{};
+};
+
+/**
+ * @class FrameMailbox
+ * @brief Per-driver latest-frame mailbox between a control task and a bus task.
+ *
+ * The control task builds complete ChannelFrames and publishes them without locks; the
+ * bus task applies the most recent one whenever it runs. Frames are full snapshots, so
+ * skipping intermediate frames never loses a channel change, and CommitFrame() still
+ * writes only the channels that differ from the device.
+ *
+ * @code
+ *   pca9685::FrameMailbox mailbox; // one per board
+ *
+ *   // Control task (core 0)
+ *   pca9685::ChannelFrame frame;
+ *   frame.ticks[3] = 2048;
+ *   mailbox.Publish(frame);
+ *
+ *   // Bus task (core 1)
+ *   mailbox.Apply(driver);
+ * @endcode
+ */
+class FrameMailbox : public TripleBuffer<ChannelFrame> {
+public:
+  /**
+   * @brief Stage and commit the latest published frame, if there is a new one.
+   * @tparam Driver A PCA9685 driver type.
+   * @param driver Driver owned by the calling (consumer) task.
+   * @return true if there was nothing new or the frame was written; false on failure
+   *         (invalid value or I2C error; the frame stays staged in the driver).
+   */
+  template <typename Driver>
+  bool Apply(Driver& driver) noexcept {
+    if (!Consume()) {
+      return true;
+    }
+    const ChannelFrame& frame = Front();
+    bool ok = true;
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      ok &= driver.StageDutyTicks(ch, frame.ticks[ch]);
+    }
+    return driver.CommitFrame() && ok;
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,500 @@
+/**
+ * @file pca9685_frame_stream.hpp
+ * @brief Compact delta-encoded binary frame stream format, streaming decoder and encoder
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pca9685 {
+
+/**
+ * @brief Layout of the binary frame stream ("PCAS") format.
+ *
+ * A stream describes duty values (0-4096 ticks, as taken by StageDutyTicks()) of up to
+ * 253 boards x 16 channels over time. Every channel starts at 0; each frame lists only
+ * the channels that changed since the previous frame. All multi-byte fields are
+ * little-endian.
+ *
+ * @code
+ *   stream := header frame* END_OF_STREAM
+ *   header := 'P' 'C' 'A' 'S'  version:u8  boards:u8  frame_period_ms:u16
+ *   frame  := block* END_OF_FRAME
+ *   block  := board:u8 (< boards)  mask:u16  value{popcount(mask)}  (channel order)
+ *   value  := 0b0ddddddd                -> previous value + d (7-bit signed delta, -64..63)
+ *           | 0b100vvvvv vvvvvvvv       -> absolute value (13 bits, 0-4096)
+ * @endcode
+ *
+ * A frame in which nothing changes is a single END_OF_FRAME byte, and slow fades cost
+ * one byte per changed channel, so long shows stay small.
+ */
+struct FrameStreamFormat {
+  static constexpr uint8_t VERSION_ = 1;           ///< Format version written and accepted
+  static constexpr size_t HEADER_SIZE_ = 8;        ///< Bytes before the first frame
+  static constexpr uint8_t MAX_BOARDS_ = 0xFD;     ///< Largest board count
+  static constexpr uint8_t END_OF_STREAM_ = 0xFE;  ///< Terminates the stream
+  static constexpr uint8_t END_OF_FRAME_ = 0xFF;   ///< Terminates a frame
+  static constexpr uint8_t ABSOLUTE_FLAG_ = 0x80;  ///< First byte of a 2-byte absolute value
+  static constexpr uint16_t MAX_VALUE_ = 4096;     ///< Largest channel value (full on)
+  static constexpr uint8_t MAGIC_[4] = {'P', 'C', 'A', 'S'};
+};
+
+/**
+ * @brief Stream parameters from the header.
+ */
+struct FrameStreamHeader {
+  uint8_t version{FrameStreamFormat::VERSION_}; ///< Format version
+  uint8_t boards{1};                            ///< Boards described by the stream
+  uint16_t frame_period_ms{20};                 ///< Intended time between frames
+};
+
+/**
+ * @brief Byte source reading from a buffer in memory (e.g. a show linked into flash).
+ *
+ * Byte sources provide `size_t Read(uint8_t* dst, size_t max)` returning the number of
+ * bytes copied (0 at the end) and `bool Rewind()`.
+ */
+class MemorySource {
+public:
+  MemorySource(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  size_t Read(uint8_t* dst, size_t max) noexcept {
+    const size_t n = (size_ - pos_) < max ? (size_ - pos_) : max;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = data_[pos_ + i];
+    }
+    pos_ += n;
+    return n;
+  }
+
+  bool Rewind() noexcept {
+    pos_ = 0;
+    return true;
+  }
+
+private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_{0};
+};
+
+#if defined(__linux__)
+/**
+ * @brief Byte source over a memory-mapped file (Linux).
+ *
+ * Mapping makes opening a show of any length constant-time: pages are faulted in as the
+ * decoder reaches them, with sequential read-ahead requested from the kernel.
+ */
+class MappedFileSource {
+public:
+  MappedFileSource() noexcept = default;
+  explicit MappedFileSource(const char* path) noexcept {
+    (void)Open(path);
+  }
+  ~MappedFileSource() noexcept {
+    Close();
+  }
+  MappedFileSource(const MappedFileSource&) = delete;
+  MappedFileSource& operator=(const MappedFileSource&) = delete;
+
+  /**
+   * @brief Map a file read-only (closes any file mapped before).
+   * @return true on success; false if the file cannot be opened, is empty, or mmap fails.
+   */
+  bool Open(const char* path) noexcept {
+    Close();
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+    void* map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file referenced
+    if (map == MAP_FAILED) {
+      return false;
+    }
+    (void)::madvise(map, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+    pos_ = 0;
+    return true;
+  }
+
+  /** @brief Unmap the file. */
+  void Close() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+  }
+
+  [[nodiscard]] bool IsOpen() const noexcept {
+    return data_ != nullptr;
+  }
+
+  size_t Read(uint8_t* dst, size_t max) noexcept {
+    const size_t n = (size_ - pos_) < max ? (size_ - pos_) : max;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = data_[pos_ + i];
+    }
+    pos_ += n;
+    return n;
+  }
+
+  bool Rewind() noexcept {
+    pos_ = 0;
+    return data_ != nullptr;
+  }
+
+private:
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+  size_t pos_{0};
+};
+#endif
+
+/**
+ * @brief Result of decoding one frame.
+ */
+enum class StreamResult : uint8_t {
+  Frame = 0, ///< A frame was decoded
+  End = 1,   ///< End of stream reached
+  Error = 2  ///< Malformed or truncated stream (or header not read)
+};
+
+/**
+ * @class FrameStreamReader
+ * @brief Streaming decoder for the frame stream format.
+ *
+ * Pulls bytes from the source in chunks of @p ChunkSize and keeps only the current value
+ * of each channel, so RAM use is fixed by the template parameters whatever the length of
+ * the show. Each decoded frame is staged into the driver(s) channel by channel, only for
+ * channels that changed, and written with one CommitFrame() burst per board:
+ *
+ * @code
+ *   pca9685::MappedFileSource file("show.pcas");
+ *   pca9685::FrameStreamReader<pca9685::MappedFileSource, 2> show(file);
+ *   if (show.Begin()) {
+ *     while (show.Next() == pca9685::StreamResult::Frame) {
+ *       show.Stage(board0, 0) && board0.CommitFrame();
+ *       show.Stage(board1, 1) && board1.CommitFrame();
+ *       sleep_ms(show.GetHeader().frame_period_ms);
+ *     }
+ *   }
+ * @endcode
+ *
+ * @tparam Source Byte source (see MemorySource).
+ * @tparam MaxBoards Largest board count accepted.
+ * @tparam ChunkSize Read buffer size in bytes.
+ */
+template <typename Source, size_t MaxBoards = 1, size_t ChunkSize = 64>
+class FrameStreamReader {
+  static_assert(MaxBoards > 0 && MaxBoards <= FrameStreamFormat::MAX_BOARDS_,
+                "MaxBoards must be 1-253");
+  static_assert(ChunkSize > 0, "ChunkSize must be non-zero");
+
+public:
+  explicit FrameStreamReader(Source& source) noexcept : source_(source) {}
+
+  /**
+   * @brief Read and validate the header, and reset all channels to 0.
+   * @return true if the stream is a supported version with at most MaxBoards boards.
+   */
+  bool Begin() noexcept {
+    len_ = 0;
+    pos_ = 0;
+    ready_ = false;
+    frame_index_ = 0;
+    for (auto& board : values_) {
+      board.fill(0);
+    }
+    changed_.fill(0);
+    uint8_t bytes[FrameStreamFormat::HEADER_SIZE_];
+    for (uint8_t& b : bytes) {
+      if (!nextByte(b)) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      if (bytes[i] != FrameStreamFormat::MAGIC_[i]) {
+        return false;
+      }
+    }
+    header_.version = bytes[4];
+    header_.boards = bytes[5];
+    header_.frame_period_ms = static_cast<uint16_t>(bytes[6] | (bytes[7] << 8));
+    ready_ = header_.version == FrameStreamFormat::VERSION_ && header_.boards > 0 &&
+             header_.boards <= MaxBoards;
+    return ready_;
+  }
+
+  /**
+   * @brief Rewind the source and read the header again (loop playback).
+   */
+  bool Restart() noexcept {
+    return source_.Rewind() && Begin();
+  }
+
+  /**
+   * @brief Decode the next frame.
+   *
+   * On Error the stream stops: further calls return Error until Begin()/Restart().
+   */
+  StreamResult Next() noexcept {
+    if (!ready_) {
+      return StreamResult::Error;
+    }
+    changed_.fill(0);
+    while (true) {
+      uint8_t tag = 0;
+      if (!nextByte(tag)) {
+        return fail();
+      }
+      if (tag == FrameStreamFormat::END_OF_FRAME_) {
+        ++frame_index_;
+        return StreamResult::Frame;
+      }
+      if (tag == FrameStreamFormat::END_OF_STREAM_) {
+        ready_ = false;
+        return StreamResult::End;
+      }
+      if (tag >= header_.boards || !decodeBlock(tag)) {
+        return fail();
+      }
+    }
+  }
+
+  /**
+   * @brief Stage the channels of one board that changed in the last frame.
+   * @tparam Driver A PCA9685 driver type.
+   * @param driver Driver to stage into (follow with CommitFrame()).
+   * @param board Board index in the stream.
+   * @return true if every changed channel was staged.
+   */
+  template <typename Driver>
+  bool Stage(Driver& driver, size_t board = 0) const noexcept {
+    if (board >= MaxBoards) {
+      return false;
+    }
+    bool ok = true;
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      if ((changed_[board] & (1U << ch)) != 0) {
+        ok &= driver.StageDutyTicks(ch, values_[board][ch]);
+      }
+    }
+    return ok;
+  }
+
+  [[nodiscard]] const FrameStreamHeader& GetHeader() const noexcept {
+    return header_;
+  }
+
+  /** @brief Current value of a channel (0-4096). */
+  [[nodiscard]] uint16_t GetValue(size_t board, uint8_t channel) const noexcept {
+    return (board < MaxBoards && channel < 16) ? values_[board][channel] : 0;
+  }
+
+  /** @brief Bitmask of the channels of @p board changed by the last frame. */
+  [[nodiscard]] uint16_t GetChangedMask(size_t board) const noexcept {
+    return board < MaxBoards ? changed_[board] : 0;
+  }
+
+  /** @brief Number of frames decoded since Begin(). */
+  [[nodiscard]] uint32_t GetFrameIndex() const noexcept {
+    return frame_index_;
+  }
+
+private:
+  Source& source_;
+  ::std::array<uint8_t, ChunkSize> chunk_{};
+  size_t len_{0};
+  size_t pos_{0};
+  FrameStreamHeader header_{};
+  ::std::array<::std::array<uint16_t, 16>, MaxBoards> values_{};
+  ::std::array<uint16_t, MaxBoards> changed_{};
+  uint32_t frame_index_{0};
+  bool ready_{false};
+
+  bool nextByte(uint8_t& b) noexcept {
+    if (pos_ == len_) {
+      len_ = source_.Read(chunk_.data(), ChunkSize);
+      pos_ = 0;
+      if (len_ == 0) {
+        return false;
+      }
+    }
+    b = chunk_[pos_++];
+    return true;
+  }
+
+  bool decodeBlock(uint8_t board) noexcept {
+    uint8_t lo = 0;
+    uint8_t hi = 0;
+    if (!nextByte(lo) || !nextByte(hi)) {
+      return false;
+    }
+    const auto mask = static_cast<uint16_t>(lo | (hi << 8));
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      if ((mask & (1U << ch)) == 0) {
+        continue;
+      }
+      uint8_t b = 0;
+      if (!nextByte(b)) {
+        return false;
+      }
+      int32_t value = 0;
+      if ((b & FrameStreamFormat::ABSOLUTE_FLAG_) == 0) {
+        const int32_t delta = (b & 0x40) != 0 ? static_cast<int32_t>(b) - 0x80 : b;
+        value = values_[board][ch] + delta;
+      } else {
+        uint8_t low = 0;
+        if ((b & 0x60) != 0 || !nextByte(low)) {
+          return false;
+        }
+        value = ((b & 0x1F) << 8) | low;
+      }
+      if (value < 0 || value > FrameStreamFormat::MAX_VALUE_) {
+        return false;
+      }
+      values_[board][ch] = static_cast<uint16_t>(value);
+    }
+    changed_[board] |= mask;
+    return true;
+  }
+
+  StreamResult fail() noexcept {
+    ready_ = false;
+    changed_.fill(0);
+    return StreamResult::Error;
+  }
+};
+
+/**
+ * @class FrameStreamWriter
+ * @brief Encoder for the frame stream format (offline authoring tools, recorders).
+ *
+ * Set channel values with SetValue(), then EndFrame() emits only the channels that
+ * differ from the previous frame, as 1-byte deltas where possible.
+ *
+ * @tparam Sink Type providing `bool Write(const uint8_t* data, size_t size)`.
+ * @tparam MaxBoards Largest board count.
+ */
+template <typename Sink, size_t MaxBoards = 1>
+class FrameStreamWriter {
+  static_assert(MaxBoards > 0 && MaxBoards <= FrameStreamFormat::MAX_BOARDS_,
+                "MaxBoards must be 1-253");
+
+public:
+  explicit FrameStreamWriter(Sink& sink) noexcept : sink_(sink) {}
+
+  /**
+   * @brief Write the header and reset all channels to 0.
+   * @return true on success; false if @p boards is 0 or above MaxBoards, or the write fails.
+   */
+  bool Begin(uint8_t boards, uint16_t frame_period_ms) noexcept {
+    if (boards == 0 || boards > MaxBoards) {
+      return false;
+    }
+    boards_ = boards;
+    for (size_t b = 0; b < MaxBoards; ++b) {
+      previous_[b].fill(0);
+      current_[b].fill(0);
+    }
+    const uint8_t header[FrameStreamFormat::HEADER_SIZE_] = {
+        FrameStreamFormat::MAGIC_[0],
+        FrameStreamFormat::MAGIC_[1],
+        FrameStreamFormat::MAGIC_[2],
+        FrameStreamFormat::MAGIC_[3],
+        FrameStreamFormat::VERSION_,
+        boards,
+        static_cast<uint8_t>(frame_period_ms & 0xFF),
+        static_cast<uint8_t>(frame_period_ms >> 8)};
+    return sink_.Write(header, sizeof(header));
+  }
+
+  /**
+   * @brief Set a channel's value for the frame being built.
+   * @return true on success; false for an invalid board, channel or value (> 4096).
+   */
+  bool SetValue(uint8_t board, uint8_t channel, uint16_t value) noexcept {
+    if (board >= boards_ || channel >= 16 || value > FrameStreamFormat::MAX_VALUE_) {
+      return false;
+    }
+    current_[board][channel] = value;
+    return true;
+  }
+
+  /**
+   * @brief Emit the frame being built (values carry over to the next frame).
+   */
+  bool EndFrame() noexcept {
+    for (uint8_t b = 0; b < boards_; ++b) {
+      uint16_t mask = 0;
+      for (uint8_t ch = 0; ch < 16; ++ch) {
+        if (current_[b][ch] != previous_[b][ch]) {
+          mask |= static_cast<uint16_t>(1U << ch);
+        }
+      }
+      if (mask == 0) {
+        continue;
+      }
+      // Largest block: tag, mask and 16 absolute values
+      uint8_t block[3 + (2 * 16)];
+      size_t n = 0;
+      block[n++] = b;
+      block[n++] = static_cast<uint8_t>(mask & 0xFF);
+      block[n++] = static_cast<uint8_t>(mask >> 8);
+      for (uint8_t ch = 0; ch < 16; ++ch) {
+        if ((mask & (1U << ch)) == 0) {
+          continue;
+        }
+        const int32_t delta =
+            static_cast<int32_t>(current_[b][ch]) - static_cast<int32_t>(previous_[b][ch]);
+        if (delta >= -64 && delta <= 63) {
+          block[n++] = static_cast<uint8_t>(delta & 0x7F);
+        } else {
+          block[n++] = static_cast<uint8_t>(FrameStreamFormat::ABSOLUTE_FLAG_ |
+                                            (current_[b][ch] >> 8));
+          block[n++] = static_cast<uint8_t>(current_[b][ch] & 0xFF);
+        }
+      }
+      if (!sink_.Write(block, n)) {
+        return false;
+      }
+      previous_[b] = current_[b];
+    }
+    const uint8_t end = FrameStreamFormat::END_OF_FRAME_;
+    return sink_.Write(&end, 1);
+  }
+
+  /**
+   * @brief Terminate the stream.
+   */
+  bool End() noexcept {
+    const uint8_t end = FrameStreamFormat::END_OF_STREAM_;
+    return sink_.Write(&end, 1);
+  }
+
+private:
+  Sink& sink_;
+  uint8_t boards_{0};
+  ::std::array<::std::array<uint16_t, 16>, MaxBoards> previous_{};
+  ::std::array<::std::array<uint16_t, 16>, MaxBoards> current_{};
+};
+
+} // namespace pca9685
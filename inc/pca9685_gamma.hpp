@@ -0,0 +1,104 @@
+/**
+ * @file pca9685_gamma.hpp
+ * @brief constexpr gamma / CIE 1931 lightness lookup tables for PCA9685 LED channels
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_constexpr_math.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Brightness response curve.
+ */
+enum class GammaCurve : uint8_t {
+  Linear = 0, ///< Output proportional to input
+  Power = 1,  ///< output = input ^ exponent (classic gamma, e.g. 2.2 or 2.8)
+  Cie1931 = 2 ///< CIE 1931 lightness: equal input steps look like equal brightness steps
+};
+
+/**
+ * @brief Brightness lookup table: 257 duty values (0-4096 ticks) for inputs 0, 1/256, ... 1.
+ *
+ * Lookups interpolate between entries, so one 514-byte table serves both 8-bit and 16-bit
+ * inputs. The last entry is DUTY_FULL_SCALE_ (full on) for every curve.
+ */
+using GammaTable = ::std::array<uint16_t, 257>;
+
+/**
+ * @brief Generate a brightness lookup table.
+ *
+ * Intended for constant evaluation, so the table is computed by the compiler and placed
+ * in flash:
+ * @code
+ *   constexpr auto GAMMA_28 = pca9685::MakeGammaTable(pca9685::GammaCurve::Power, 2.8);
+ *   driver.SetGammaTable(&GAMMA_28);
+ * @endcode
+ *
+ * @param curve Response curve.
+ * @param exponent Exponent for GammaCurve::Power (ignored otherwise).
+ * @return The table.
+ */
+constexpr GammaTable MakeGammaTable(GammaCurve curve, double exponent = 2.2) noexcept {
+  GammaTable table{};
+  const size_t last = table.size() - 1;
+  for (size_t i = 0; i <= last; ++i) {
+    const double x = static_cast<double>(i) / static_cast<double>(last);
+    double y = x;
+    switch (curve) {
+    case GammaCurve::Linear:
+      break;
+    case GammaCurve::Power:
+      y = cmath::Pow(x, exponent);
+      break;
+    case GammaCurve::Cie1931: {
+      const double lightness = 100.0 * x; // L*, 0-100
+      y = lightness <= 8.0 ? lightness / 903.3 : cmath::Pow((lightness + 16.0) / 116.0, 3.0);
+      break;
+    }
+    }
+    y = y < 0.0 ? 0.0 : (y > 1.0 ? 1.0 : y);
+    table[i] = static_cast<uint16_t>(cmath::Round(y * 4096.0));
+  }
+  return table;
+}
+
+/// Gamma 2.2 (sRGB-like) table
+inline constexpr GammaTable GAMMA_2_2_TABLE = MakeGammaTable(GammaCurve::Power, 2.2);
+
+/// CIE 1931 lightness table
+inline constexpr GammaTable GAMMA_CIE1931_TABLE = MakeGammaTable(GammaCurve::Cie1931);
+
+/**
+ * @brief Map a 16-bit level (0-65535) to duty ticks (0-4096) through a table.
+ *
+ * 65535 maps exactly to the last entry. Two multiplies and no division. User tables need
+ * not be monotonic: falling segments interpolate downwards, and the result is clamped to
+ * 0-4096.
+ */
+constexpr uint16_t GammaLookup(const GammaTable& table, uint16_t level) noexcept {
+  constexpr int32_t FULL_SCALE = 4096;
+  const uint32_t pos = level + (static_cast<uint32_t>(level) >> 15U); // 0-65536, Q8 index
+  const uint32_t i = pos >> 8U;
+  if (i >= table.size() - 1) {
+    return static_cast<uint16_t>(::std::min<int32_t>(table[table.size() - 1], FULL_SCALE));
+  }
+  const auto frac = static_cast<int32_t>(pos & 0xFFU);
+  const int32_t delta = static_cast<int32_t>(table[i + 1]) - static_cast<int32_t>(table[i]);
+  const int32_t ticks = table[i] + (((delta * frac) + 128) >> 8);
+  return static_cast<uint16_t>(::std::clamp<int32_t>(ticks, 0, FULL_SCALE));
+}
+
+/**
+ * @brief Map an 8-bit level (0-255) to duty ticks (0-4096) through a table.
+ */
+constexpr uint16_t GammaLookup8(const GammaTable& table, uint8_t level) noexcept {
+  return GammaLookup(table, static_cast<uint16_t>(level * 257U));
+}
+
+} // namespace pca9685
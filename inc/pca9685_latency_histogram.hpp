@@ -0,0 +1,133 @@
+/**
+ * @file pca9685_latency_histogram.hpp
+ * @brief Lock-free, log2-bucketed latency histogram used by the PCA9685 driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size latency histogram with power-of-two microsecond buckets.
+ *
+ * Bucket 0 counts samples of 0 µs; bucket `i` (i >= 1) counts samples in
+ * `[2^(i-1), 2^i)` µs. The last bucket also absorbs every sample above its
+ * lower bound, so no sample is ever dropped.
+ *
+ * All counters are `std::atomic<uint32_t>` updated with relaxed ordering: a
+ * single task records while any other task (or core) may read the counts
+ * without locking. Readers see each counter atomically, but a snapshot taken
+ * while recording is in progress may be off by the in-flight sample.
+ */
+class LatencyHistogram {
+public:
+  static constexpr size_t NUM_BUCKETS_ = 20; ///< Buckets cover 0 µs .. >= 2^18 µs (~262 ms)
+
+  LatencyHistogram() noexcept = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  /**
+   * @brief Record one latency sample.
+   * @param elapsed_us Measured duration in microseconds.
+   */
+  void Record(uint32_t elapsed_us) noexcept {
+    buckets_[BucketIndex(elapsed_us)].fetch_add(1, ::std::memory_order_relaxed);
+    count_.fetch_add(1, ::std::memory_order_relaxed);
+    uint32_t prev = max_us_.load(::std::memory_order_relaxed);
+    while (elapsed_us > prev &&
+           !max_us_.compare_exchange_weak(prev, elapsed_us, ::std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief Reset all counters to zero.
+   */
+  void Reset() noexcept {
+    for (auto& bucket : buckets_) {
+      bucket.store(0, ::std::memory_order_relaxed);
+    }
+    count_.store(0, ::std::memory_order_relaxed);
+    max_us_.store(0, ::std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of samples recorded in a bucket.
+   * @param bucket Bucket index (0 .. NUM_BUCKETS_-1).
+   * @return Sample count, or 0 if the index is out of range.
+   */
+  [[nodiscard]] uint32_t GetBucketCount(size_t bucket) const noexcept {
+    return bucket < NUM_BUCKETS_ ? buckets_[bucket].load(::std::memory_order_relaxed) : 0;
+  }
+
+  /**
+   * @brief Get the total number of samples recorded.
+   */
+  [[nodiscard]] uint32_t GetCount() const noexcept {
+    return count_.load(::std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the largest sample recorded (µs).
+   */
+  [[nodiscard]] uint32_t GetMaxUs() const noexcept {
+    return max_us_.load(::std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Estimate a percentile from the bucket counts.
+   *
+   * Returns the exclusive upper bound of the bucket that contains the
+   * requested percentile, i.e. a value that is at most 2x the true latency.
+   *
+   * @param percent Percentile in the range 0-100 (e.g. 99 for p99).
+   * @return Upper bound in µs, or 0 if no samples have been recorded.
+   */
+  [[nodiscard]] uint32_t GetPercentileUs(uint8_t percent) const noexcept {
+    const uint32_t total = GetCount();
+    if (total == 0) {
+      return 0;
+    }
+    percent = percent > 100 ? 100 : percent;
+    const uint64_t rank = (static_cast<uint64_t>(total) * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS_; ++i) {
+      seen += GetBucketCount(i);
+      if (seen >= rank && seen != 0) {
+        return GetBucketUpperBoundUs(i);
+      }
+    }
+    return GetMaxUs();
+  }
+
+  /**
+   * @brief Map a duration to its bucket index.
+   * @param elapsed_us Duration in microseconds.
+   * @return Bucket index (0 .. NUM_BUCKETS_-1).
+   */
+  static constexpr size_t BucketIndex(uint32_t elapsed_us) noexcept {
+    const auto width = static_cast<size_t>(::std::bit_width(elapsed_us));
+    return width < NUM_BUCKETS_ ? width : NUM_BUCKETS_ - 1;
+  }
+
+  /**
+   * @brief Get the exclusive upper bound of a bucket (µs).
+   * @param bucket Bucket index.
+   * @return `2^bucket` µs; the last bucket is open-ended and returns UINT32_MAX.
+   */
+  static constexpr uint32_t GetBucketUpperBoundUs(size_t bucket) noexcept {
+    return bucket + 1 < NUM_BUCKETS_ ? (1U << bucket) : UINT32_MAX;
+  }
+
+private:
+  ::std::atomic<uint32_t> buckets_[NUM_BUCKETS_]{};
+  ::std::atomic<uint32_t> count_{0};
+  ::std::atomic<uint32_t> max_us_{0};
+};
+
+} // namespace pca9685
@@ -0,0 +1,175 @@
+/**
+ * @file pca9685_power_policy.hpp
+ * @brief Idle-sleep power policy for the PCA9685 driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class PowerPolicy
+ * @brief Decides when an idle device may sleep and accounts the time it spends asleep.
+ *
+ * A device is idle while every channel in the driver's shadow image is off (full-off bit
+ * set, or equal ON and OFF counts without full-on). Once it has been idle for
+ * `idle_timeout_us`, the driver puts it to sleep, which stops the oscillator. The first
+ * write that turns a channel on wakes it again before the write goes out. Since no channel
+ * was running when it went to sleep, the device holds no outputs for RESTART, and the
+ * channel write alone resumes the PWM.
+ *
+ * Only sleeps entered through the policy are tracked: a device put to sleep with Sleep()
+ * stays asleep until the application wakes it.
+ *
+ * Like DeviceHealth, the class is pure bookkeeping: timestamps come from the caller (the
+ * driver's ClockFn), wrap-around safe. With `idle_timeout_us == 0` the policy never sleeps
+ * the device.
+ */
+class PowerPolicy {
+public:
+  /**
+   * @brief Policy configuration.
+   */
+  struct Config {
+    uint32_t idle_timeout_us = 0; ///< Idle time before sleeping the device (0 = disabled)
+  };
+
+  constexpr PowerPolicy() noexcept = default;
+
+  /**
+   * @brief Replace the configuration.
+   *
+   * The idle timer restarts with the next NoteActivity(). A device asleep under the policy
+   * stays asleep and is still woken by the next channel write.
+   *
+   * @param config New configuration.
+   */
+  void Configure(const Config& config) noexcept {
+    config_ = config;
+    idle_ = false;
+  }
+
+  /**
+   * @brief Get the active configuration.
+   */
+  [[nodiscard]] const Config& GetConfig() const noexcept {
+    return config_;
+  }
+
+  /** @brief true if the policy may sleep the device (idle_timeout_us != 0). */
+  [[nodiscard]] bool Enabled() const noexcept {
+    return config_.idle_timeout_us != 0;
+  }
+
+  /**
+   * @brief Check whether one channel's LEDn registers keep its output off.
+   * @param regs Four register bytes (ON_L, ON_H, OFF_L, OFF_H).
+   */
+  [[nodiscard]] static constexpr bool IsChannelIdle(const uint8_t* regs) noexcept {
+    return (regs[3] & FULL_BIT_) != 0 ||
+           ((regs[1] & FULL_BIT_) == 0 && regs[0] == regs[2] &&
+            (regs[1] & 0x0F) == (regs[3] & 0x0F));
+  }
+
+  /**
+   * @brief Check whether every channel of a register image keeps its output off.
+   * @param image LEDn register bytes, four per channel.
+   * @param channels Number of channels in @p image.
+   */
+  [[nodiscard]] static constexpr bool IsImageIdle(const uint8_t* image, size_t channels) noexcept {
+    for (size_t ch = 0; ch < channels; ++ch) {
+      if (!IsChannelIdle(image + (4 * ch))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Record the idle state of the shadow image after it changed.
+   * @param idle true if every channel is off.
+   * @param now_us Current time (µs).
+   */
+  void NoteActivity(bool idle, uint32_t now_us) noexcept {
+    if (idle && !idle_) {
+      idle_since_us_ = now_us;
+    }
+    idle_ = idle;
+  }
+
+  /**
+   * @brief Check whether the device has been idle long enough to sleep.
+   * @param now_us Current time (µs, wrap-around safe).
+   * @return true if enabled, idle for at least idle_timeout_us and not asleep yet.
+   */
+  [[nodiscard]] bool SleepDue(uint32_t now_us) const noexcept {
+    return Enabled() && idle_ && !asleep_ && (now_us - idle_since_us_) >= config_.idle_timeout_us;
+  }
+
+  /**
+   * @brief Record that the policy put the device to sleep.
+   * @param now_us Current time (µs).
+   */
+  void RecordSleep(uint32_t now_us) noexcept {
+    asleep_ = true;
+    slept_at_us_ = now_us;
+    ++sleeps_;
+  }
+
+  /**
+   * @brief Record that a device asleep under the policy woke up (no effect otherwise).
+   * @param now_us Current time (µs).
+   */
+  void RecordWake(uint32_t now_us) noexcept {
+    if (!asleep_) {
+      return;
+    }
+    asleep_ = false;
+    asleep_us_ += now_us - slept_at_us_;
+    ++wakes_;
+  }
+
+  /** @brief true while the device is asleep under the policy. */
+  [[nodiscard]] bool IsAsleep() const noexcept {
+    return asleep_;
+  }
+  /** @brief true while every channel in the shadow image is off. */
+  [[nodiscard]] bool IsIdle() const noexcept {
+    return idle_;
+  }
+  /** @brief Timestamp (µs) at which the device became idle; valid if IsIdle(). */
+  [[nodiscard]] uint32_t GetIdleSinceUs() const noexcept {
+    return idle_since_us_;
+  }
+  /**
+   * @brief Total time spent asleep under the policy, including the current sleep.
+   * @param now_us Current time (µs).
+   */
+  [[nodiscard]] uint64_t GetAsleepUs(uint32_t now_us) const noexcept {
+    return asleep_us_ + (asleep_ ? static_cast<uint32_t>(now_us - slept_at_us_) : 0U);
+  }
+  /** @brief Number of times the policy put the device to sleep. */
+  [[nodiscard]] uint32_t GetSleepCount() const noexcept {
+    return sleeps_;
+  }
+  /** @brief Number of wake-ups from a policy sleep (by a channel write or otherwise). */
+  [[nodiscard]] uint32_t GetWakeCount() const noexcept {
+    return wakes_;
+  }
+
+private:
+  static constexpr uint8_t FULL_BIT_ = 0x10; ///< Full-on / full-off bit in LEDn_ON_H / OFF_H
+
+  Config config_{};
+  bool idle_{false};
+  bool asleep_{false};
+  uint32_t idle_since_us_{0};
+  uint32_t slept_at_us_{0};
+  uint64_t asleep_us_{0};
+  uint32_t sleeps_{0};
+  uint32_t wakes_{0};
+};
+
+} // namespace pca9685
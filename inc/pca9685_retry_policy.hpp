@@ -0,0 +1,219 @@
+/**
+ * @file pca9685_retry_policy.hpp
+ * @brief I2C retry policy (exponential backoff, jitter, frame budget, fast-fail) for PCA9685
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class RetryPolicy
+ * @brief Decides whether and how long to wait before retrying a failed I2C transfer.
+ *
+ * The policy combines four independent limits:
+ * - **Per-transfer retries**: at most `max_retries` retries after the first attempt.
+ * - **Exponential backoff with jitter**: the n-th retry waits
+ *   `base_delay_us * 2^(n * backoff_shift)` µs (capped at `max_delay_us`), reduced by a
+ *   random amount of up to `jitter_percent` so that several boards do not retry in lockstep.
+ * - **Per-frame retry budget**: at most `frame_retry_budget` retries between two
+ *   BeginFrame() calls, so one noisy device cannot consume a whole update period.
+ * - **Fast-fail when offline**: after `offline_threshold` consecutive failed transfers the
+ *   device is treated as offline and each transfer gets a single attempt until one succeeds.
+ *
+ * A zero value disables the corresponding limit (no delay, no budget, no fast-fail).
+ * The default configuration reproduces the legacy behaviour: 3 retries, no backoff.
+ */
+class RetryPolicy {
+public:
+  /**
+   * @brief Static configuration of a retry policy.
+   */
+  struct Config {
+    uint8_t max_retries = 3;         ///< Retries per transfer after the first attempt
+    uint32_t base_delay_us = 0;      ///< Delay before the first retry (0 = no backoff delay)
+    uint32_t max_delay_us = 0;       ///< Upper bound for a single backoff delay (0 = uncapped)
+    uint8_t backoff_shift = 1;       ///< Delay grows by 2^backoff_shift per retry (1 = doubling)
+    uint8_t jitter_percent = 0;      ///< Random reduction of each delay, 0-100 %
+    uint16_t frame_retry_budget = 0; ///< Retries allowed per frame (0 = unlimited)
+    uint8_t offline_threshold = 0;   ///< Consecutive failed transfers before fast-fail (0 = off)
+  };
+
+  /**
+   * @brief Counters describing how the policy has behaved since the last reset.
+   */
+  struct Stats {
+    uint32_t retries = 0;          ///< Retries performed
+    uint32_t budget_exhausted = 0; ///< Retries refused because the frame budget was spent
+    uint32_t fast_fails = 0;       ///< Retries refused because the device was offline
+    uint32_t failed_transfers = 0; ///< Transfers that failed after all permitted attempts
+  };
+
+  constexpr RetryPolicy() noexcept = default;
+
+  /**
+   * @brief Construct a policy with the given configuration.
+   * @param config Policy configuration.
+   */
+  explicit constexpr RetryPolicy(const Config& config) noexcept
+      : config_(config), budget_remaining_(config.frame_retry_budget) {}
+
+  /**
+   * @brief Replace the configuration and refill the frame budget.
+   * @param config New configuration.
+   */
+  void Configure(const Config& config) noexcept {
+    config_ = config;
+    budget_remaining_ = config.frame_retry_budget;
+  }
+
+  /**
+   * @brief Get the active configuration.
+   */
+  [[nodiscard]] const Config& GetConfig() const noexcept {
+    return config_;
+  }
+
+  /**
+   * @brief Set the per-transfer retry count only.
+   * @param retries Retries after the first attempt.
+   */
+  void SetMaxRetries(uint8_t retries) noexcept {
+    config_.max_retries = retries;
+  }
+
+  /**
+   * @brief Start a new frame: refill the per-frame retry budget.
+   */
+  void BeginFrame() noexcept {
+    budget_remaining_ = config_.frame_retry_budget;
+  }
+
+  /**
+   * @brief Seed the jitter generator (e.g. with the device address or a hardware RNG).
+   * @param seed Any value; 0 is replaced by a fixed non-zero seed.
+   */
+  void Seed(uint32_t seed) noexcept {
+    rng_state_ = seed != 0 ? seed : DEFAULT_SEED_;
+  }
+
+  /**
+   * @brief Decide whether a failed attempt may be retried, consuming budget if so.
+   * @param retries_done Retries already performed for this transfer.
+   * @return true if another attempt is permitted.
+   */
+  bool ConsumeRetry(uint8_t retries_done) noexcept {
+    if (retries_done >= config_.max_retries) {
+      return false;
+    }
+    if (IsOffline()) {
+      ++stats_.fast_fails;
+      return false;
+    }
+    if (config_.frame_retry_budget != 0) {
+      if (budget_remaining_ == 0) {
+        ++stats_.budget_exhausted;
+        return false;
+      }
+      --budget_remaining_;
+    }
+    ++stats_.retries;
+    return true;
+  }
+
+  /**
+   * @brief Compute the backoff delay before a retry.
+   * @param retries_done Retries already performed for this transfer (0 for the first retry).
+   * @return Delay in microseconds (0 = retry immediately).
+   */
+  uint32_t NextDelayUs(uint8_t retries_done) noexcept {
+    if (config_.base_delay_us == 0) {
+      return 0;
+    }
+    uint64_t delay = config_.base_delay_us;
+    const uint32_t cap = config_.max_delay_us != 0 ? config_.max_delay_us : UINT32_MAX;
+    const uint32_t shift = static_cast<uint32_t>(retries_done) * config_.backoff_shift;
+    delay = shift >= 32 ? cap : ::std::min<uint64_t>(delay << shift, cap);
+    if (config_.jitter_percent != 0) {
+      const uint8_t percent = config_.jitter_percent > 100 ? 100 : config_.jitter_percent;
+      const uint64_t span = (delay * percent) / 100;
+      delay -= nextRandom() % (span + 1);
+    }
+    return static_cast<uint32_t>(delay);
+  }
+
+  /**
+   * @brief Record a transfer that completed successfully.
+   */
+  void RecordSuccess() noexcept {
+    consecutive_failures_ = 0;
+  }
+
+  /**
+   * @brief Record a transfer that failed after all permitted attempts.
+   */
+  void RecordFailure() noexcept {
+    ++stats_.failed_transfers;
+    if (consecutive_failures_ != UINT16_MAX) {
+      ++consecutive_failures_;
+    }
+  }
+
+  /**
+   * @brief Check whether the device is currently considered offline (fast-fail active).
+   */
+  [[nodiscard]] bool IsOffline() const noexcept {
+    return config_.offline_threshold != 0 && consecutive_failures_ >= config_.offline_threshold;
+  }
+
+  /**
+   * @brief Number of consecutive failed transfers since the last success.
+   */
+  [[nodiscard]] uint16_t GetConsecutiveFailures() const noexcept {
+    return consecutive_failures_;
+  }
+
+  /**
+   * @brief Retries left in the current frame (meaningful only when a budget is configured).
+   */
+  [[nodiscard]] uint16_t GetFrameBudgetRemaining() const noexcept {
+    return budget_remaining_;
+  }
+
+  /**
+   * @brief Get the policy statistics.
+   */
+  [[nodiscard]] const Stats& GetStats() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief Reset the statistics counters.
+   */
+  void ResetStats() noexcept {
+    stats_ = Stats{};
+  }
+
+private:
+  static constexpr uint32_t DEFAULT_SEED_ = 0x9E3779B9U;
+
+  Config config_{};
+  Stats stats_{};
+  uint16_t budget_remaining_{0};
+  uint16_t consecutive_failures_{0};
+  uint32_t rng_state_{DEFAULT_SEED_};
+
+  /** @brief xorshift32 step; cheap, deterministic jitter source. */
+  uint32_t nextRandom() noexcept {
+    uint32_t x = rng_state_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state_ = x;
+    return x;
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,274 @@
+/**
+ * @file pca9685_scheduler.hpp
+ * @brief Fixed-rate frame scheduler with absolute deadlines, jitter/overrun accounting and
+ *        drop/merge overload handling
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_latency_histogram.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief What a producer is told when it runs.
+ */
+struct FrameTick {
+  uint32_t frame;       ///< Index of this frame since Reset() (counts skipped frames too)
+  uint32_t frames;      ///< Frames this call stands for: 1, or more when merging missed frames
+  uint32_t deadline_us; ///< Scheduled start of this frame (clock time)
+  uint32_t jitter_us;   ///< How late the frame started relative to its deadline
+};
+
+/**
+ * @brief How a producer sees frames missed under overload.
+ */
+enum class OverloadPolicy : uint8_t {
+  Drop = 0, ///< Missed frames are dropped; the producer always advances one frame
+  Merge = 1 ///< Missed frames are merged into the next call (FrameTick::frames > 1)
+};
+
+/**
+ * @brief Counters kept by FrameScheduler.
+ */
+struct SchedulerStats {
+  uint32_t frames_run{0};     ///< Frames executed
+  uint32_t frames_missed{0};  ///< Deadlines that passed without a frame (dropped or merged)
+  uint32_t overruns{0};       ///< Frames whose producers took longer than one period
+  uint32_t task_failures{0};  ///< Producer calls that returned false
+  uint32_t max_jitter_us{0};  ///< Largest start delay after a deadline
+  uint32_t max_work_us{0};    ///< Longest time spent running producers in one frame
+};
+
+/**
+ * @class FrameScheduler
+ * @brief Runs registered frame producers at a fixed rate on absolute deadlines.
+ *
+ * Deadlines are `start + n * period`, never "now + period", so execution time and sleep
+ * granularity do not accumulate into drift: a late frame is followed by an earlier
+ * wake-up. If a frame starts one or more whole periods late, the missed deadlines are not
+ * replayed back to back (which would add latency); they are counted and either dropped or
+ * merged into the next call, per producer.
+ *
+ * Time comes from a microsecond clock (`ClockFn`, as for SetClock()) and a microsecond
+ * sleep. The sleep may return early but should not overshoot; on an RTOS, block for the
+ * whole ticks and busy-wait only the sub-tick remainder. The clock may wrap.
+ *
+ * @code
+ *   bool update_board(void* ctx, const pca9685::FrameTick& tick) {
+ *     auto* show = static_cast<Show*>(ctx);
+ *     show->Advance(tick.frames);
+ *     return show->Stage(show->driver) && show->driver.CommitFrame();
+ *   }
+ *   ...
+ *   pca9685::FrameScheduler<2> scheduler(Bus::NowUs, Bus::SleepUs, 20000);
+ *   scheduler.AddTask(update_board, &show0, pca9685::OverloadPolicy::Merge);
+ *   scheduler.AddTask(update_board, &show1, pca9685::OverloadPolicy::Merge);
+ *   scheduler.Run(); // until RequestStop()
+ * @endcode
+ *
+ * Not thread-safe except for RequestStop() and reading GetJitterHistogram().
+ *
+ * @tparam MaxTasks Maximum number of producers.
+ */
+template <size_t MaxTasks = 4>
+class FrameScheduler {
+public:
+  using ClockFn = uint32_t (*)();
+  using SleepUsFn = void (*)(uint32_t delay_us);
+  /** @brief Frame producer; return false to report a failure (counted, not fatal). */
+  using ProducerFn = bool (*)(void* context, const FrameTick& tick);
+
+  /**
+   * @brief Construct a scheduler.
+   * @param clock Microsecond clock.
+   * @param sleep Microsecond sleep (may return early; the scheduler re-checks the clock).
+   * @param period_us Frame period in microseconds (> 0).
+   */
+  FrameScheduler(ClockFn clock, SleepUsFn sleep, uint32_t period_us) noexcept
+      : clock_(clock), sleep_(sleep), period_us_(period_us > 0 ? period_us : 1) {}
+
+  FrameScheduler(const FrameScheduler&) = delete;
+  FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+  /**
+   * @brief Register a producer; producers run in registration order every frame.
+   * @return Task index, or -1 if the scheduler is full or @p fn is null.
+   */
+  int AddTask(ProducerFn fn, void* context, OverloadPolicy policy = OverloadPolicy::Drop) noexcept {
+    if (fn == nullptr || task_count_ >= MaxTasks) {
+      return -1;
+    }
+    tasks_[task_count_] = Task{fn, context, policy};
+    return static_cast<int>(task_count_++);
+  }
+
+  /**
+   * @brief Change the frame period; takes effect from the next deadline.
+   */
+  void SetPeriodUs(uint32_t period_us) noexcept {
+    period_us_ = period_us > 0 ? period_us : 1;
+  }
+
+  [[nodiscard]] uint32_t GetPeriodUs() const noexcept {
+    return period_us_;
+  }
+
+  /**
+   * @brief Restart the timeline: the next frame is frame 0, due immediately.
+   */
+  void Reset() noexcept {
+    started_ = false;
+    frame_ = 0;
+  }
+
+  /**
+   * @brief Sleep until the next deadline, then run one frame.
+   * @return true if every producer succeeded.
+   */
+  bool RunOnce() noexcept {
+    if (!started_) {
+      start();
+    }
+    int32_t remaining = static_cast<int32_t>(next_deadline_us_ - clock_());
+    while (remaining > 0) {
+      if (sleep_ != nullptr) {
+        sleep_(static_cast<uint32_t>(remaining));
+      }
+      remaining = static_cast<int32_t>(next_deadline_us_ - clock_());
+    }
+    return runFrame();
+  }
+
+  /**
+   * @brief Run one frame if its deadline has passed, without sleeping.
+   *
+   * For callers with their own event loop.
+   *
+   * @return true if a frame was run.
+   */
+  bool Poll() noexcept {
+    if (!started_) {
+      start();
+    }
+    if (static_cast<int32_t>(next_deadline_us_ - clock_()) > 0) {
+      return false;
+    }
+    (void)runFrame();
+    return true;
+  }
+
+  /**
+   * @brief Run frames until @p frames periods have elapsed, or until RequestStop().
+   * @param frames Number of periods to run (missed frames count), 0 = until stopped.
+   * @return Number of frames executed.
+   */
+  uint32_t Run(uint32_t frames = 0) noexcept {
+    stop_.store(false, ::std::memory_order_relaxed);
+    const uint32_t first = started_ ? frame_ : 0;
+    uint32_t executed = 0;
+    while (!stop_.load(::std::memory_order_relaxed) && (frames == 0 || frame_ - first < frames)) {
+      (void)RunOnce();
+      ++executed;
+    }
+    return executed;
+  }
+
+  /**
+   * @brief Make Run() return after the current frame (callable from any task or ISR).
+   */
+  void RequestStop() noexcept {
+    stop_.store(true, ::std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] const SchedulerStats& GetStats() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief Distribution of frame start jitter (µs after the deadline).
+   */
+  [[nodiscard]] const LatencyHistogram& GetJitterHistogram() const noexcept {
+    return jitter_;
+  }
+
+  /**
+   * @brief Zero the statistics and the jitter histogram.
+   */
+  void ResetStats() noexcept {
+    stats_ = SchedulerStats{};
+    jitter_.Reset();
+  }
+
+  /** @brief Index of the next frame. */
+  [[nodiscard]] uint32_t GetFrameIndex() const noexcept {
+    return frame_;
+  }
+
+private:
+  struct Task {
+    ProducerFn fn{nullptr};
+    void* context{nullptr};
+    OverloadPolicy policy{OverloadPolicy::Drop};
+  };
+
+  ClockFn clock_;
+  SleepUsFn sleep_;
+  uint32_t period_us_;
+  ::std::array<Task, MaxTasks> tasks_{};
+  size_t task_count_{0};
+  uint32_t next_deadline_us_{0};
+  uint32_t frame_{0};
+  bool started_{false};
+  ::std::atomic<bool> stop_{false};
+  SchedulerStats stats_{};
+  LatencyHistogram jitter_;
+
+  void start() noexcept {
+    next_deadline_us_ = clock_();
+    frame_ = 0;
+    started_ = true;
+  }
+
+  bool runFrame() noexcept {
+    const uint32_t start_us = clock_();
+    const uint32_t late_us = start_us - next_deadline_us_;
+    // Deadlines that passed entirely are not replayed: skip to the latest one
+    const uint32_t missed = late_us / period_us_;
+    const uint32_t deadline_us = next_deadline_us_ + (missed * period_us_);
+    const FrameTick tick{frame_ + missed, missed + 1, deadline_us, start_us - deadline_us};
+
+    stats_.frames_missed += missed;
+    stats_.max_jitter_us = tick.jitter_us > stats_.max_jitter_us ? tick.jitter_us
+                                                                 : stats_.max_jitter_us;
+    jitter_.Record(tick.jitter_us);
+
+    bool ok = true;
+    for (size_t i = 0; i < task_count_; ++i) {
+      FrameTick task_tick = tick;
+      if (tasks_[i].policy == OverloadPolicy::Drop) {
+        task_tick.frames = 1;
+      }
+      if (!tasks_[i].fn(tasks_[i].context, task_tick)) {
+        ++stats_.task_failures;
+        ok = false;
+      }
+    }
+
+    const uint32_t work_us = clock_() - start_us;
+    stats_.max_work_us = work_us > stats_.max_work_us ? work_us : stats_.max_work_us;
+    if (work_us > period_us_) {
+      ++stats_.overruns;
+    }
+    ++stats_.frames_run;
+    frame_ += missed + 1;
+    next_deadline_us_ = deadline_us + period_us_;
+    return ok;
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,630 @@
+/**
+ * @file pca9685_simulator.hpp
+ * @brief Behavioural PCA9685 model on a simulated I2C bus, with output edge timelines and VCD
+ *        export (host testing)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "pca9685_i2c_interface.hpp"
+
+namespace pca9685 {
+
+/**
+ * @brief Physical level of an LEDn pin.
+ */
+enum class SimLevel : uint8_t {
+  Low = 0,  ///< Driven low
+  High = 1, ///< Driven high (totem-pole)
+  HighZ = 2 ///< Not driven (open-drain off, or OE deasserted with OUTNE = high-Z)
+};
+
+/**
+ * @brief One output transition reported by PCA9685Simulator.
+ */
+struct SimEdge {
+  uint64_t time_ns; ///< Simulation time of the transition
+  uint8_t channel;  ///< LEDn pin (0-15)
+  SimLevel level;   ///< New level
+};
+
+/**
+ * @class PCA9685Simulator
+ * @brief Cycle-level PCA9685 model that doubles as the driver's I2C bus.
+ *
+ * Pass it to PCA9685 in place of a hardware bus; every transfer advances simulated time by
+ * its duration on the wire, and AdvanceUs()/AdvanceNs() let time pass between calls. The
+ * model covers:
+ * - register file with power-on defaults, auto-increment (0x00-0x45 and 0xFA-0xFF), ALL_LED
+ *   broadcast, LED ALLCALL address and the general-call software reset;
+ * - the oscillator (25 MHz internal or EXTCLK), the PRE_SCALE divider and the 4096-tick
+ *   counter, with per-channel ON/OFF edges and the full-on/full-off bits (full-off wins);
+ * - output latching at STOP (MODE2 OCH = 0) or at the ACK of a channel's last register
+ *   (OCH = 1); latched values take effect at the start of the next PWM period;
+ * - SLEEP (outputs off, PRE_SCALE and EXTCLK writable), the 500 µs oscillator start-up,
+ *   and the RESTART hold: channels active when sleep was entered stay off after waking
+ *   until RESTART is written (not earlier than 500 µs after waking) or a PWM register is
+ *   written;
+ * - MODE2 INVRT, OUTDRV and OUTNE, and the OE pin (via GpioSet()).
+ *
+ * Output transitions are reported through SetEdgeCallback(), e.g. to a VcdWriter.
+ * Violations of datasheet timing rules (RESTART too early, PRE_SCALE or EXTCLK written
+ * while awake) are counted, and the offending write is ignored, as on the chip.
+ *
+ * @code
+ *   pca9685::PCA9685Simulator sim;
+ *   pca9685::PCA9685<pca9685::PCA9685Simulator> pwm(&sim, 0x40);
+ *   pwm.EnsureInitialized();
+ *   pwm.SetPwmFreq(1000.0F);
+ *   sim.AdvanceUs(500); // oscillator start-up
+ *   pwm.SetPwm(0, 0, 2048);
+ *   sim.AdvanceUs(10000); // ten 1 ms periods of edges
+ * @endcode
+ */
+class PCA9685Simulator : public I2cInterface<PCA9685Simulator> {
+public:
+  using EdgeFn = void (*)(void* context, const SimEdge& edge);
+
+  static constexpr uint8_t NUM_CHANNELS_ = 16;
+  static constexpr uint16_t COUNTER_STEPS_ = 4096;
+  static constexpr uint32_t INTERNAL_OSC_HZ_ = 25000000;
+  static constexpr uint64_t OSC_STARTUP_NS_ = 500000; ///< Oscillator start-up after wake
+  static constexpr uint8_t ALLCALL_ADDRESS_ = 0x70;   ///< Power-on LED All Call address
+  static constexpr uint8_t GENERAL_CALL_ = 0x00;      ///< Software reset: general call + 0x06
+
+  /**
+   * @param address 7-bit address the model answers on.
+   * @param bus_hz I2C clock used for transfer durations (0 = transfers take no time).
+   */
+  explicit PCA9685Simulator(uint8_t address = 0x40, uint32_t bus_hz = 400000) noexcept
+      : address_(address), bus_hz_(bus_hz) {
+    resetRegisters();
+  }
+
+  // ---- I2cInterface ----
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    ++transactions_;
+    if (addr == GENERAL_CALL_ && reg == 0x06 && len == 0) {
+      AdvanceNs(transferNs(1, 0));
+      softwareReset();
+      return true;
+    }
+    if (!addressed(addr)) {
+      AdvanceNs(transferNs(0, 0)); // Address byte NACKed
+      return false;
+    }
+    const uint64_t start = now_ns_;
+    uint16_t touched = 0;
+    uint8_t r = reg;
+    for (size_t i = 0; i < len; ++i) {
+      advanceTo(start + transferNs(1, i + 1)); // ACK of data byte i
+      writeByte(r, data[i], touched);
+      r = nextRegister(r);
+    }
+    advanceTo(start + transferNs(1, len));
+    if ((regs_[MODE2_] & MODE2_OCH_) == 0 && touched != 0) {
+      latch(touched); // STOP
+    }
+    return true;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    ++transactions_;
+    if (!addressed(addr)) {
+      AdvanceNs(transferNs(0, 0));
+      return false;
+    }
+    uint8_t r = reg;
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = readByte(r);
+      r = nextRegister(r);
+    }
+    AdvanceNs(transferNs(3, len)); // Register write, repeated start, address, data
+    return true;
+  }
+
+  bool EnsureInitialized() noexcept {
+    return true;
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+    if (pin == CtrlPin::OE) {
+      oe_active_ = signal == GpioSignal::ACTIVE;
+      refreshOutputs();
+    }
+  }
+
+  // ---- Simulation control ----
+
+  /** @brief Let @p ns nanoseconds of simulated time pass. */
+  void AdvanceNs(uint64_t ns) noexcept {
+    advanceTo(now_ns_ + ns);
+  }
+
+  /** @brief Let @p us microseconds of simulated time pass. */
+  void AdvanceUs(uint64_t us) noexcept {
+    advanceTo(now_ns_ + (us * 1000U));
+  }
+
+  [[nodiscard]] uint64_t NowNs() const noexcept {
+    return now_ns_;
+  }
+
+  /**
+   * @brief Report every output transition (and the initial levels) to @p fn.
+   */
+  void SetEdgeCallback(EdgeFn fn, void* context) noexcept {
+    edge_fn_ = fn;
+    edge_context_ = context;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      emit(ch, output_[ch]);
+    }
+  }
+
+  /** @brief Frequency of the clock on the EXTCLK pin, used once MODE1 EXTCLK is set. */
+  void SetExternalClockHz(uint32_t hz) noexcept {
+    ext_clock_hz_ = hz > 0 ? hz : 1;
+  }
+
+  /** @brief Actual internal oscillator frequency (to model its ±tolerance). */
+  void SetInternalOscillatorHz(uint32_t hz) noexcept {
+    internal_osc_hz_ = hz > 0 ? hz : 1;
+  }
+
+  /** @brief Remove and restore power: registers and outputs return to power-on state. */
+  void PowerCycle() noexcept {
+    softwareReset();
+  }
+
+  // ---- Inspection ----
+
+  /** @brief Current level of an LEDn pin. */
+  [[nodiscard]] SimLevel GetOutput(uint8_t channel) const noexcept {
+    return channel < NUM_CHANNELS_ ? output_[channel] : SimLevel::Low;
+  }
+
+  /** @brief Register contents as stored (no read side effects; ALL_LED reads 0). */
+  [[nodiscard]] uint8_t GetRegister(uint8_t reg) const noexcept {
+    return readByte(reg);
+  }
+
+  /** @brief Check whether the counter is running (awake and oscillator stable). */
+  [[nodiscard]] bool IsRunning() const noexcept {
+    return running_;
+  }
+
+  /** @brief Check whether outputs are held off waiting for RESTART. */
+  [[nodiscard]] bool IsRestartPending() const noexcept {
+    return restart_hold_;
+  }
+
+  /** @brief Clock driving the prescaler now (internal or EXTCLK). */
+  [[nodiscard]] uint32_t GetClockHz() const noexcept {
+    return ext_clock_ ? ext_clock_hz_ : internal_osc_hz_;
+  }
+
+  /** @brief PWM period for the current clock and PRE_SCALE. */
+  [[nodiscard]] uint64_t GetPeriodNs() const noexcept {
+    return cyclesToNs(static_cast<uint64_t>(COUNTER_STEPS_) * (regs_[PRE_SCALE_] + 1U),
+                      GetClockHz());
+  }
+
+  /** @brief Number of I2C transactions addressed to the bus. */
+  [[nodiscard]] uint32_t GetTransactionCount() const noexcept {
+    return transactions_;
+  }
+
+  /** @brief Number of writes ignored for breaking a datasheet timing or mode rule. */
+  [[nodiscard]] uint32_t GetTimingViolations() const noexcept {
+    return violations_;
+  }
+
+private:
+  static constexpr uint8_t MODE1_ = 0x00;
+  static constexpr uint8_t MODE2_ = 0x01;
+  static constexpr uint8_t ALLCALLADR_ = 0x05;
+  static constexpr uint8_t LED0_ON_L_ = 0x06;
+  static constexpr uint8_t LED_LAST_ = 0x45;
+  static constexpr uint8_t ALL_LED_ON_L_ = 0xFA;
+  static constexpr uint8_t ALL_LED_OFF_H_ = 0xFD;
+  static constexpr uint8_t PRE_SCALE_ = 0xFE;
+  static constexpr uint8_t MODE1_RESTART_ = 0x80;
+  static constexpr uint8_t MODE1_EXTCLK_ = 0x40;
+  static constexpr uint8_t MODE1_AI_ = 0x20;
+  static constexpr uint8_t MODE1_SLEEP_ = 0x10;
+  static constexpr uint8_t MODE1_ALLCALL_ = 0x01;
+  static constexpr uint8_t MODE2_INVRT_ = 0x10;
+  static constexpr uint8_t MODE2_OCH_ = 0x08;
+  static constexpr uint8_t MODE2_OUTDRV_ = 0x04;
+  static constexpr uint8_t MODE2_OUTNE_ = 0x03;
+  static constexpr uint8_t FULL_ = 0x10; ///< Full-on/full-off bit in LEDn_ON_H/OFF_H
+
+  struct Event {
+    uint64_t time_ns;
+    uint8_t channel;
+    bool level;
+  };
+
+  uint8_t address_;
+  uint32_t bus_hz_;
+  uint32_t internal_osc_hz_{INTERNAL_OSC_HZ_};
+  uint32_t ext_clock_hz_{INTERNAL_OSC_HZ_};
+  bool ext_clock_{false};
+  ::std::array<uint8_t, 256> regs_{};
+  /** @brief LEDn values latched by ACK/STOP, taking effect at the next period. */
+  ::std::array<uint8_t, 4 * NUM_CHANNELS_> latched_{};
+  ::std::array<uint8_t, 4 * NUM_CHANNELS_> active_{};
+
+  uint64_t now_ns_{0};
+  bool oe_active_{true};
+  bool running_{false};
+  bool restart_hold_{false};
+  uint64_t osc_ready_ns_{0}; ///< When the oscillator is stable after waking
+  uint64_t epoch_ns_{0};     ///< Start of period 0 of the current run
+  uint64_t period_{0};
+  uint64_t period_end_ns_{0};
+  ::std::array<Event, 3 * NUM_CHANNELS_> events_{}; ///< Level at tick 0, ON and OFF edges
+  size_t event_count_{0};
+  size_t next_event_{0};
+  ::std::array<bool, NUM_CHANNELS_> counter_level_{}; ///< Waveform before gating/mapping
+  ::std::array<SimLevel, NUM_CHANNELS_> output_{};
+
+  EdgeFn edge_fn_{nullptr};
+  void* edge_context_{nullptr};
+  uint32_t transactions_{0};
+  uint32_t violations_{0};
+
+  [[nodiscard]] bool sleeping() const noexcept {
+    return (regs_[MODE1_] & MODE1_SLEEP_) != 0;
+  }
+
+  [[nodiscard]] bool addressed(uint8_t addr) const noexcept {
+    return addr == address_ || ((regs_[MODE1_] & MODE1_ALLCALL_) != 0 &&
+                                addr == static_cast<uint8_t>(regs_[ALLCALLADR_] >> 1));
+  }
+
+  /** @brief Duration of a transfer with @p overhead extra bytes plus address and register. */
+  [[nodiscard]] uint64_t transferNs(size_t overhead, size_t data_bytes) const noexcept {
+    if (bus_hz_ == 0) {
+      return 0;
+    }
+    const uint64_t bits = 2U + (9U * (1U + overhead + data_bytes)); // START, bytes, STOP
+    return (bits * 1000000000ULL) / bus_hz_;
+  }
+
+  static uint64_t cyclesToNs(uint64_t cycles, uint32_t hz) noexcept {
+    return ((cycles / hz) * 1000000000ULL) + (((cycles % hz) * 1000000000ULL) / hz);
+  }
+
+  /** @brief Register pointer after a byte: auto-increment (MODE1 AI) or stay. */
+  [[nodiscard]] uint8_t nextRegister(uint8_t reg) const noexcept {
+    if ((regs_[MODE1_] & MODE1_AI_) == 0) {
+      return reg;
+    }
+    return reg == LED_LAST_ ? 0 : static_cast<uint8_t>(reg + 1); // 0xFF wraps to 0x00 too
+  }
+
+  [[nodiscard]] uint8_t readByte(uint8_t reg) const noexcept {
+    if (reg == MODE1_) {
+      return static_cast<uint8_t>((regs_[MODE1_] & ~MODE1_RESTART_) |
+                                  (restart_hold_ ? MODE1_RESTART_ : 0));
+    }
+    if ((reg > LED_LAST_ && reg < PRE_SCALE_) || reg == 0xFF) {
+      return 0; // Reserved, ALL_LED (write-only) and TESTMODE
+    }
+    return regs_[reg];
+  }
+
+  void writeByte(uint8_t reg, uint8_t value, uint16_t& touched) noexcept {
+    if (reg == MODE1_) {
+      writeMode1(value);
+    } else if (reg == MODE2_) {
+      regs_[MODE2_] = value & 0x1F;
+      refreshOutputs();
+    } else if (reg >= LED0_ON_L_ && reg <= LED_LAST_) {
+      writeLed(static_cast<uint8_t>(reg - LED0_ON_L_), value, touched);
+    } else if (reg >= ALL_LED_ON_L_ && reg <= ALL_LED_OFF_H_) {
+      for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+        writeLed(static_cast<uint8_t>((4 * ch) + (reg - ALL_LED_ON_L_)), value, touched);
+      }
+    } else if (reg == PRE_SCALE_) {
+      if (!sleeping()) {
+        ++violations_; // Only writable in sleep
+        return;
+      }
+      regs_[PRE_SCALE_] = ::std::max<uint8_t>(value, 3);
+    } else if (reg < LED0_ON_L_) {
+      regs_[reg] = value; // SUBADRx, ALLCALLADR
+    }
+  }
+
+  void writeLed(uint8_t offset, uint8_t value, uint16_t& touched) noexcept {
+    const bool high_byte = (offset & 1U) != 0;
+    regs_[LED0_ON_L_ + offset] = high_byte ? static_cast<uint8_t>(value & 0x1F) : value;
+    const auto channel = static_cast<uint8_t>(offset / 4);
+    touched |= static_cast<uint16_t>(1U << channel);
+    if ((regs_[MODE2_] & MODE2_OCH_) != 0 && (offset % 4) == 3) {
+      latch(static_cast<uint16_t>(1U << channel)); // ACK of LEDn_OFF_H
+    }
+  }
+
+  void writeMode1(uint8_t value) noexcept {
+    const bool was_sleeping = sleeping();
+    const bool restart = (value & MODE1_RESTART_) != 0;
+    if ((value & MODE1_EXTCLK_) != 0 && !ext_clock_) {
+      if (was_sleeping) {
+        ext_clock_ = true; // Sticky until power cycle or software reset
+      } else {
+        ++violations_;
+      }
+    }
+    regs_[MODE1_] = static_cast<uint8_t>((value & 0x3F) | (ext_clock_ ? MODE1_EXTCLK_ : 0));
+
+    if (!was_sleeping && sleeping()) {
+      enterSleep();
+    } else if (was_sleeping && !sleeping()) {
+      osc_ready_ns_ = now_ns_ + OSC_STARTUP_NS_;
+    }
+    if (restart && restart_hold_) {
+      if (!sleeping() && !was_sleeping && now_ns_ >= osc_ready_ns_) {
+        restart_hold_ = false;
+        refreshOutputs();
+      } else {
+        ++violations_; // RESTART needs SLEEP = 0 for at least 500 µs
+      }
+    }
+  }
+
+  void enterSleep() noexcept {
+    bool active = false;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_ && running_; ++ch) {
+      const uint8_t* led = active_.data() + (4 * ch);
+      active |= (led[3] & FULL_) == 0 && ((led[1] & FULL_) != 0 || led[0] != led[2] ||
+                                          (led[1] & 0x0F) != (led[3] & 0x0F));
+    }
+    restart_hold_ = restart_hold_ || active;
+    running_ = false;
+    counter_level_.fill(false);
+    refreshOutputs();
+  }
+
+  /** @brief Make the channels' register values the next period's waveform. */
+  void latch(uint16_t channels) noexcept {
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      if ((channels & (1U << ch)) != 0) {
+        ::std::copy_n(regs_.begin() + LED0_ON_L_ + (4 * ch), 4, latched_.begin() + (4 * ch));
+      }
+    }
+    if (restart_hold_ && !sleeping()) {
+      restart_hold_ = false; // A PWM register update also clears RESTART
+      refreshOutputs();
+    }
+  }
+
+  void resetRegisters() noexcept {
+    regs_.fill(0);
+    regs_[MODE1_] = MODE1_SLEEP_ | MODE1_ALLCALL_;
+    regs_[MODE2_] = MODE2_OUTDRV_;
+    regs_[0x02] = 0xE2;
+    regs_[0x03] = 0xE4;
+    regs_[0x04] = 0xE8;
+    regs_[ALLCALLADR_] = 0xE0;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      regs_[LED0_ON_L_ + (4 * ch) + 3] = FULL_;
+    }
+    regs_[PRE_SCALE_] = 0x1E;
+    ::std::copy_n(regs_.begin() + LED0_ON_L_, latched_.size(), latched_.begin());
+    active_ = latched_;
+  }
+
+  void softwareReset() noexcept {
+    resetRegisters();
+    ext_clock_ = false;
+    running_ = false;
+    restart_hold_ = false;
+    counter_level_.fill(false);
+    refreshOutputs();
+  }
+
+  /** @brief Compute period @p index's edges from the latched values. */
+  void beginPeriod(uint64_t index) noexcept {
+    const uint32_t hz = GetClockHz();
+    const uint64_t tick_cycles = regs_[PRE_SCALE_] + 1U;
+    const uint64_t first_tick = index * COUNTER_STEPS_;
+    const auto tick_ns = [&](uint64_t tick) {
+      return epoch_ns_ + cyclesToNs((first_tick + tick) * tick_cycles, hz);
+    };
+    period_ = index;
+    period_end_ns_ = tick_ns(COUNTER_STEPS_);
+    active_ = latched_;
+
+    event_count_ = 0;
+    next_event_ = 0;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      const uint8_t* led = active_.data() + (4 * ch);
+      const uint16_t on = static_cast<uint16_t>(led[0] | ((led[1] & 0x0F) << 8));
+      const uint16_t off = static_cast<uint16_t>(led[2] | ((led[3] & 0x0F) << 8));
+      const bool full_off = (led[3] & FULL_) != 0;
+      const bool full_on = !full_off && (led[1] & FULL_) != 0;
+      if (full_off || full_on || on == off) {
+        events_[event_count_++] = Event{tick_ns(0), ch, full_on};
+        continue;
+      }
+      // High from ON to OFF, wrapping through the end of the period when OFF < ON
+      const bool at_start = on < off ? on == 0 : off != 0;
+      events_[event_count_++] = Event{tick_ns(0), ch, at_start};
+      if (on != 0) {
+        events_[event_count_++] = Event{tick_ns(on), ch, true};
+      }
+      if (off != 0) {
+        events_[event_count_++] = Event{tick_ns(off), ch, false};
+      }
+    }
+    ::std::stable_sort(events_.begin(), events_.begin() + static_cast<ptrdiff_t>(event_count_),
+                       [](const Event& a, const Event& b) { return a.time_ns < b.time_ns; });
+  }
+
+  void advanceTo(uint64_t to_ns) noexcept {
+    while (true) {
+      if (!running_) {
+        if (sleeping() || osc_ready_ns_ > to_ns) {
+          break;
+        }
+        running_ = true; // Oscillator stable: the counter starts at 0
+        now_ns_ = ::std::max(now_ns_, osc_ready_ns_);
+        epoch_ns_ = now_ns_;
+        beginPeriod(0);
+      }
+      while (next_event_ < event_count_ && events_[next_event_].time_ns <= to_ns) {
+        const Event& event = events_[next_event_++];
+        now_ns_ = ::std::max(now_ns_, event.time_ns);
+        counter_level_[event.channel] = event.level;
+        updateOutput(event.channel);
+      }
+      if (next_event_ < event_count_ || period_end_ns_ > to_ns) {
+        break;
+      }
+      now_ns_ = ::std::max(now_ns_, period_end_ns_);
+      beginPeriod(period_ + 1);
+    }
+    now_ns_ = ::std::max(now_ns_, to_ns);
+  }
+
+  [[nodiscard]] SimLevel pinLevel(uint8_t channel) const noexcept {
+    const uint8_t mode2 = regs_[MODE2_];
+    const bool totem_pole = (mode2 & MODE2_OUTDRV_) != 0;
+    if (!oe_active_) {
+      switch (mode2 & MODE2_OUTNE_) {
+      case 0:
+        return SimLevel::Low;
+      case 1:
+        return totem_pole ? SimLevel::High : SimLevel::HighZ;
+      default:
+        return SimLevel::HighZ;
+      }
+    }
+    bool on = running_ && !restart_hold_ && counter_level_[channel];
+    on = on != ((mode2 & MODE2_INVRT_) != 0);
+    if (totem_pole) {
+      return on ? SimLevel::High : SimLevel::Low;
+    }
+    return on ? SimLevel::HighZ : SimLevel::Low;
+  }
+
+  void updateOutput(uint8_t channel) noexcept {
+    const SimLevel level = pinLevel(channel);
+    if (level != output_[channel]) {
+      output_[channel] = level;
+      emit(channel, level);
+    }
+  }
+
+  void refreshOutputs() noexcept {
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      updateOutput(ch);
+    }
+  }
+
+  void emit(uint8_t channel, SimLevel level) const noexcept {
+    if (edge_fn_ != nullptr) {
+      edge_fn_(edge_context_, SimEdge{now_ns_, channel, level});
+    }
+  }
+};
+
+/**
+ * @class VcdWriter
+ * @brief Writes PCA9685Simulator edges as a Value Change Dump (GTKWave, PulseView, ...).
+ *
+ * @code
+ *   FileSink file("pwm.vcd");
+ *   pca9685::VcdWriter<FileSink> vcd(file);
+ *   vcd.Begin();
+ *   sim.SetEdgeCallback(pca9685::VcdWriter<FileSink>::OnEdge, &vcd);
+ *   ... // drive the simulator
+ *   vcd.End(sim.NowNs());
+ * @endcode
+ *
+ * @tparam Sink Type providing `bool Write(const uint8_t* data, size_t size)`.
+ */
+template <typename Sink>
+class VcdWriter {
+public:
+  explicit VcdWriter(Sink& sink) noexcept : sink_(sink) {}
+
+  /**
+   * @brief Write the header declaring one wire per channel (timescale 1 ns).
+   * @param module Scope name shown in the viewer.
+   */
+  bool Begin(const char* module = "pca9685") noexcept {
+    char line[64];
+    bool ok = put("$timescale 1ns $end\n");
+    (void)::std::snprintf(line, sizeof(line), "$scope module %s $end\n", module);
+    ok &= put(line);
+    for (uint8_t ch = 0; ch < PCA9685Simulator::NUM_CHANNELS_; ++ch) {
+      (void)::std::snprintf(line, sizeof(line), "$var wire 1 %c led%u $end\n", id(ch), ch);
+      ok &= put(line);
+    }
+    ok &= put("$upscope $end\n$enddefinitions $end\n");
+    ok_ = ok;
+    return ok;
+  }
+
+  /** @brief Edge callback for PCA9685Simulator::SetEdgeCallback(). */
+  static void OnEdge(void* context, const SimEdge& edge) noexcept {
+    static_cast<VcdWriter*>(context)->write(edge);
+  }
+
+  /**
+   * @brief Mark the end of the trace so viewers show the final levels up to @p end_ns.
+   * @return true if every write to the sink succeeded.
+   */
+  bool End(uint64_t end_ns) noexcept {
+    writeTime(end_ns);
+    return ok_;
+  }
+
+private:
+  Sink& sink_;
+  uint64_t last_time_ns_{0};
+  bool time_written_{false};
+  bool ok_{true};
+
+  static char id(uint8_t channel) noexcept {
+    return static_cast<char>('A' + channel);
+  }
+
+  bool put(const char* text) noexcept {
+    size_t len = 0;
+    while (text[len] != '\0') {
+      ++len;
+    }
+    return sink_.Write(reinterpret_cast<const uint8_t*>(text), len);
+  }
+
+  void writeTime(uint64_t time_ns) noexcept {
+    if (time_written_ && time_ns == last_time_ns_) {
+      return;
+    }
+    char line[32];
+    (void)::std::snprintf(line, sizeof(line), "#%llu\n", static_cast<unsigned long long>(time_ns));
+    ok_ &= put(line);
+    last_time_ns_ = time_ns;
+    time_written_ = true;
+  }
+
+  void write(const SimEdge& edge) noexcept {
+    writeTime(edge.time_ns);
+    static constexpr char VALUES[] = {'0', '1', 'z'};
+    const char line[] = {VALUES[static_cast<uint8_t>(edge.level)], id(edge.channel), '\n', '\0'};
+    ok_ &= put(line);
+  }
+};
+
+} // namespace pca9685
@@ -0,0 +1,413 @@
+/**
+ * @file pca9685_trace.hpp
+ * @brief I2C transaction trace: ring-buffer recorder, binary dump format, reader and replay
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Dump format (little-endian):
+ *
+ * | Offset | Size | Field |
+ * |--------|------|-------|
+ * | 0  | 4 | Magic `P9TR` |
+ * | 4  | 1 | Format version (1) |
+ * | 5  | 1 | File header size (16) |
+ * | 6  | 1 | Record header size (8) |
+ * | 7  | 1 | Reserved (0) |
+ * | 8  | 4 | Number of records |
+ * | 12 | 4 | Records dropped (overwritten in the ring) before the first one |
+ * | 16 | .. | Records, oldest first |
+ *
+ * Each record is an 8-byte header — timestamp (µs, u32), 7-bit address, register, payload
+ * length, flags (TraceEvent::READ_, FAILED_, TRUNCATED_) — followed by the payload:
+ * the bytes written, or the bytes read back for a read.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "pca9685_i2c_interface.hpp"
+
+namespace pca9685 {
+
+inline constexpr uint8_t TRACE_VERSION = 1;           ///< Dump format version
+inline constexpr size_t TRACE_FILE_HEADER_SIZE = 16;  ///< Dump header bytes
+inline constexpr size_t TRACE_RECORD_HEADER_SIZE = 8; ///< Record header bytes
+
+/**
+ * @brief One decoded trace record (payload points into the dump buffer).
+ */
+struct TraceEvent {
+  static constexpr uint8_t READ_ = 0x01;      ///< Flag: Read (else Write)
+  static constexpr uint8_t FAILED_ = 0x02;    ///< Flag: the bus reported failure
+  static constexpr uint8_t TRUNCATED_ = 0x04; ///< Flag: payload cut to fit the record
+
+  uint32_t time_us;    ///< Recorder clock at the start of the transfer
+  uint8_t addr;        ///< 7-bit device address
+  uint8_t reg;         ///< Start register
+  uint8_t flags;       ///< READ_ | FAILED_ | TRUNCATED_
+  uint8_t len;         ///< Payload bytes stored
+  const uint8_t* data; ///< Payload
+
+  [[nodiscard]] bool IsRead() const noexcept {
+    return (flags & READ_) != 0;
+  }
+  [[nodiscard]] bool Failed() const noexcept {
+    return (flags & FAILED_) != 0;
+  }
+};
+
+/**
+ * @class TraceRecorder
+ * @brief Bus decorator that records every transfer into a fixed-size byte ring.
+ *
+ * Records are variable length (8 bytes + payload), so a 4 KiB ring holds about 300
+ * single-channel writes or 55 full-frame bursts. When the ring is full the oldest records
+ * are overwritten and counted as dropped: the ring always holds the most recent traffic,
+ * which is what matters after a glitch. Recording is a bounded copy with no allocation.
+ *
+ * @code
+ *   pca9685::TraceRecorder<MyBus> recorder(bus);
+ *   recorder.SetClock(MyBus::NowUs);
+ *   pca9685::PCA9685<pca9685::TraceRecorder<MyBus>> pwm(&recorder, 0x40);
+ *   ... // run; after a glitch:
+ *   recorder.SetEnabled(false);
+ *   recorder.Dump(uart_sink); // replay on the host with tools/pca9685_trace_replay
+ * @endcode
+ *
+ * Not thread-safe: record and dump from the task that owns the bus.
+ *
+ * @tparam Bus Wrapped bus type (an I2cInterface implementation).
+ * @tparam CapacityBytes Ring size, a power of two of at least 512 bytes.
+ */
+template <typename Bus, size_t CapacityBytes = 4096>
+class TraceRecorder : public I2cInterface<TraceRecorder<Bus, CapacityBytes>> {
+  static_assert(CapacityBytes >= 512 && (CapacityBytes & (CapacityBytes - 1)) == 0,
+                "TraceRecorder capacity must be a power of two >= 512");
+
+public:
+  /** @brief Monotonic microsecond clock (same contract as PCA9685::SetClock()). */
+  using ClockFn = uint32_t (*)();
+
+  /**
+   * @brief Wrap a bus.
+   * @param bus Bus that performs the transfers; must outlive this object.
+   */
+  explicit TraceRecorder(Bus& bus) noexcept : bus_(bus) {}
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    const uint32_t time = now();
+    const bool ok = bus_.Write(addr, reg, data, len);
+    record(time, addr, reg, ok ? 0 : TraceEvent::FAILED_, data, len);
+    return ok;
+  }
+
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    const uint32_t time = now();
+    const bool ok = bus_.Read(addr, reg, data, len);
+    const uint8_t flags = ok ? TraceEvent::READ_ : (TraceEvent::READ_ | TraceEvent::FAILED_);
+    record(time, addr, reg, flags, data, ok ? len : 0);
+    return ok;
+  }
+
+  bool EnsureInitialized() noexcept {
+    return bus_.EnsureInitialized();
+  }
+
+  void GpioSet(CtrlPin pin, GpioSignal signal) noexcept {
+    bus_.GpioSet(pin, signal);
+  }
+
+  /**
+   * @brief Set the timestamp clock (nullptr = all timestamps 0).
+   */
+  void SetClock(ClockFn fn) noexcept {
+    clock_ = fn;
+  }
+
+  /**
+   * @brief Pause or resume recording (e.g. freeze the ring while dumping it).
+   */
+  void SetEnabled(bool enabled) noexcept {
+    enabled_ = enabled;
+  }
+
+  /** @brief Check whether transfers are being recorded. */
+  [[nodiscard]] bool IsEnabled() const noexcept {
+    return enabled_;
+  }
+
+  /** @brief Discard all records and reset the dropped count. */
+  void Clear() noexcept {
+    head_ = 0;
+    tail_ = 0;
+    count_ = 0;
+    dropped_ = 0;
+  }
+
+  /** @brief Records currently held. */
+  [[nodiscard]] uint32_t GetRecordCount() const noexcept {
+    return count_;
+  }
+
+  /** @brief Records overwritten since the last Clear(). */
+  [[nodiscard]] uint32_t GetDroppedCount() const noexcept {
+    return dropped_;
+  }
+
+  /** @brief Size in bytes of the dump Dump() would write now. */
+  [[nodiscard]] size_t GetDumpSize() const noexcept {
+    return TRACE_FILE_HEADER_SIZE + (head_ - tail_);
+  }
+
+  /**
+   * @brief Write the ring as a binary dump (see the file comment for the format).
+   * @tparam Sink Type providing `bool Write(const uint8_t* data, size_t size)`.
+   * @return true if every write to the sink succeeded.
+   */
+  template <typename Sink>
+  bool Dump(Sink& sink) const noexcept {
+    uint8_t header[TRACE_FILE_HEADER_SIZE] = {'P', '9', 'T', 'R', TRACE_VERSION,
+                                               TRACE_FILE_HEADER_SIZE, TRACE_RECORD_HEADER_SIZE};
+    putU32(header + 8, count_);
+    putU32(header + 12, dropped_);
+    if (!sink.Write(header, sizeof(header))) {
+      return false;
+    }
+    // The used region is at most two contiguous pieces of the ring
+    const size_t used = head_ - tail_;
+    const size_t start = tail_ & MASK_;
+    const size_t first = used < CapacityBytes - start ? used : CapacityBytes - start;
+    if (first != 0 && !sink.Write(ring_ + start, first)) {
+      return false;
+    }
+    return used == first || sink.Write(ring_, used - first);
+  }
+
+  /** @brief The wrapped bus. */
+  Bus& GetBus() noexcept {
+    return bus_;
+  }
+
+private:
+  static constexpr size_t MASK_ = CapacityBytes - 1;
+  static constexpr size_t MAX_PAYLOAD_ = 255;
+
+  Bus& bus_;
+  ClockFn clock_{nullptr};
+  bool enabled_{true};
+  size_t head_{0}; ///< Next byte to write (free-running)
+  size_t tail_{0}; ///< First byte of the oldest record (free-running)
+  uint32_t count_{0};
+  uint32_t dropped_{0};
+  uint8_t ring_[CapacityBytes]{};
+
+  [[nodiscard]] uint32_t now() const noexcept {
+    return clock_ != nullptr ? clock_() : 0;
+  }
+
+  static void putU32(uint8_t* out, uint32_t value) noexcept {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+  }
+
+  void put(uint8_t byte) noexcept {
+    ring_[head_++ & MASK_] = byte;
+  }
+
+  void record(uint32_t time, uint8_t addr, uint8_t reg, uint8_t flags, const uint8_t* data,
+              size_t len) noexcept {
+    if (!enabled_) {
+      return;
+    }
+    size_t stored = len < MAX_PAYLOAD_ ? len : MAX_PAYLOAD_;
+    // A record never takes more than a quarter of the ring
+    stored = stored < (CapacityBytes / 4) ? stored : (CapacityBytes / 4);
+    if (stored != len) {
+      flags |= TraceEvent::TRUNCATED_;
+    }
+    const size_t size = TRACE_RECORD_HEADER_SIZE + stored;
+    while (CapacityBytes - (head_ - tail_) < size) {
+      tail_ += TRACE_RECORD_HEADER_SIZE + ring_[(tail_ + 6) & MASK_];
+      --count_;
+      ++dropped_;
+    }
+    uint8_t header[TRACE_RECORD_HEADER_SIZE];
+    putU32(header, time);
+    header[4] = addr;
+    header[5] = reg;
+    header[6] = static_cast<uint8_t>(stored);
+    header[7] = flags;
+    for (const uint8_t byte : header) {
+      put(byte);
+    }
+    for (size_t i = 0; i < stored; ++i) {
+      put(data[i]);
+    }
+    ++count_;
+  }
+};
+
+/**
+ * @class TraceReader
+ * @brief Iterates the records of a binary trace dump.
+ */
+class TraceReader {
+public:
+  /**
+   * @param data Dump bytes (must stay valid while reading).
+   * @param size Dump size.
+   */
+  TraceReader(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {
+    valid_ = size >= TRACE_FILE_HEADER_SIZE && data[0] == 'P' && data[1] == '9' &&
+             data[2] == 'T' && data[3] == 'R' && data[4] == TRACE_VERSION &&
+             data[5] >= TRACE_FILE_HEADER_SIZE && data[6] == TRACE_RECORD_HEADER_SIZE &&
+             data[5] <= size;
+    if (valid_) {
+      records_ = getU32(data + 8);
+      dropped_ = getU32(data + 12);
+      first_ = data[5];
+      pos_ = first_;
+    }
+  }
+
+  /** @brief Check whether the dump header is well formed. */
+  [[nodiscard]] bool IsValid() const noexcept {
+    return valid_;
+  }
+
+  /** @brief Number of records the header announces. */
+  [[nodiscard]] uint32_t GetRecordCount() const noexcept {
+    return records_;
+  }
+
+  /** @brief Records dropped by the recorder before the first one in the dump. */
+  [[nodiscard]] uint32_t GetDroppedCount() const noexcept {
+    return dropped_;
+  }
+
+  /**
+   * @brief Decode the next record.
+   * @return false at the end of the dump or if the remaining bytes are malformed.
+   */
+  bool Next(TraceEvent& event) noexcept {
+    if (!valid_ || read_ >= records_ || size_ - pos_ < TRACE_RECORD_HEADER_SIZE) {
+      return false;
+    }
+    const uint8_t* header = data_ + pos_;
+    const size_t len = header[6];
+    if (size_ - pos_ - TRACE_RECORD_HEADER_SIZE < len) {
+      valid_ = false;
+      return false;
+    }
+    event.time_us = getU32(header);
+    event.addr = header[4];
+    event.reg = header[5];
+    event.len = static_cast<uint8_t>(len);
+    event.flags = header[7];
+    event.data = header + TRACE_RECORD_HEADER_SIZE;
+    pos_ += TRACE_RECORD_HEADER_SIZE + len;
+    ++read_;
+    return true;
+  }
+
+  /** @brief Restart from the first record. */
+  void Rewind() noexcept {
+    if (first_ != 0) {
+      pos_ = first_;
+      read_ = 0;
+      valid_ = true;
+    }
+  }
+
+private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t first_{0}; ///< Offset of the first record (0 = invalid header)
+  size_t pos_{0};
+  uint32_t records_{0};
+  uint32_t dropped_{0};
+  uint32_t read_{0};
+  bool valid_{false};
+
+  static uint32_t getU32(const uint8_t* in) noexcept {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+  }
+};
+
+/**
+ * @brief Options for ReplayTrace().
+ */
+struct ReplayOptions {
+  /** @brief Callback that waits (or advances simulated time) for a duration in µs. */
+  using DelayUsFn = void (*)(uint32_t delay_us);
+
+  bool replay_failed = false;   ///< Also replay transfers that failed when recorded
+  bool compare_reads = true;    ///< Compare read data with the recorded data
+  DelayUsFn delay_us = nullptr; ///< Reproduce recorded gaps between transfers (nullptr = off)
+};
+
+/**
+ * @brief Outcome of ReplayTrace().
+ */
+struct ReplayStats {
+  uint32_t writes = 0;          ///< Writes issued
+  uint32_t reads = 0;           ///< Reads issued
+  uint32_t failed = 0;          ///< Issued transfers the bus rejected
+  uint32_t read_mismatches = 0; ///< Reads whose data differed from the recording
+  uint32_t skipped = 0;         ///< Records not replayed (failed or truncated)
+};
+
+/**
+ * @brief Replay a trace onto a bus (a PCA9685Simulator or a real bus).
+ * @tparam Bus An I2cInterface implementation.
+ * @param reader Trace positioned at the first record to replay.
+ * @param bus Target bus.
+ * @param options See ReplayOptions.
+ * @param[out] stats Counters.
+ * @return true if the whole trace was replayed with no failure and no read mismatch.
+ */
+template <typename Bus>
+bool ReplayTrace(TraceReader& reader, Bus& bus, const ReplayOptions& options,
+                 ReplayStats& stats) noexcept {
+  stats = ReplayStats{};
+  TraceEvent event{};
+  bool first = true;
+  uint32_t last_time = 0;
+  uint8_t buffer[256];
+  while (reader.Next(event)) {
+    if ((event.flags & TraceEvent::TRUNCATED_) != 0 || (event.Failed() && !options.replay_failed)) {
+      ++stats.skipped;
+      continue;
+    }
+    if (options.delay_us != nullptr && !first) {
+      options.delay_us(event.time_us - last_time);
+    }
+    first = false;
+    last_time = event.time_us;
+    if (event.IsRead()) {
+      ++stats.reads;
+      if (!bus.Read(event.addr, event.reg, buffer, event.len)) {
+        ++stats.failed;
+        continue;
+      }
+      if (options.compare_reads && !event.Failed()) {
+        for (uint8_t i = 0; i < event.len; ++i) {
+          if (buffer[i] != event.data[i]) {
+            ++stats.read_mismatches;
+            break;
+          }
+        }
+      }
+    } else {
+      ++stats.writes;
+      if (!bus.Write(event.addr, event.reg, event.data, event.len)) {
+        ++stats.failed;
+      }
+    }
+  }
+  return reader.IsValid() && stats.failed == 0 && stats.read_mismatches == 0;
+}
+
+} // namespace pca9685
@@ -0,0 +1,360 @@
+/**
+ * @file pca9685_trajectory.hpp
+ * @brief Acceleration-limited (trapezoidal / S-curve) multi-axis motion generator for PCA9685
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pca9685 {
+
+/**
+ * @class Trajectory
+ * @brief Generates smooth per-frame PWM targets for many servo (or other) axes.
+ *
+ * Each axis follows its target with bounded velocity and acceleration:
+ * - **Trapezoidal**: accelerate at `max_accel`, cruise at `max_velocity`, and start
+ *   braking exactly when the remaining distance requires it, so the axis stops on the
+ *   target without overshoot. Targets may change every frame.
+ * - **S-curve**: the trapezoidal path is passed through a moving-average filter of
+ *   `2^scurve_shift` frames. Averaging a trapezoidal velocity over N frames yields a
+ *   jerk-limited profile (jerk = max_accel / N) at the cost of N frames of extra lag.
+ *
+ * All arithmetic is integer: positions and velocities are PWM ticks in Q8 fixed point,
+ * time is measured in frames (one Step() per update period). An axis at rest on its
+ * target costs a couple of comparisons per Step().
+ *
+ * Output is fed to the driver's frame staging API, so each update costs one
+ * CommitFrame() burst per board instead of one transaction per channel:
+ *
+ * @code
+ *   using Motion = pca9685::Trajectory<64>; // four boards
+ *   Motion motion;
+ *   motion.SetAllLimits({6 << 8, 1 << 8, Motion::Profile::SCurve, 2, 205, 410});
+ *   ...
+ *   motion.Step();
+ *   for (size_t b = 0; b < 4; ++b) {
+ *     motion.Stage(boards[b], b * 16);
+ *     boards[b].CommitFrame();
+ *   }
+ * @endcode
+ *
+ * @tparam NumAxes Number of axes (any size; 16 per PCA9685).
+ * @tparam MaxSmoothing Largest S-curve filter length in frames (power of two, 1-128).
+ */
+template <size_t NumAxes, size_t MaxSmoothing = 8>
+class Trajectory {
+  static_assert(NumAxes > 0, "Trajectory needs at least one axis");
+  static_assert(MaxSmoothing > 0 && MaxSmoothing <= 128 &&
+                    (MaxSmoothing & (MaxSmoothing - 1)) == 0,
+                "MaxSmoothing must be a power of two no larger than 128");
+
+public:
+  static constexpr uint8_t FRAC_BITS_ = 8;     ///< Fractional bits of positions and limits
+  static constexpr uint16_t MAX_TICKS_ = 4095; ///< Largest PWM tick value
+
+  /**
+   * @brief Motion profile of an axis.
+   */
+  enum class Profile : uint8_t {
+    Trapezoidal = 0, ///< Bounded velocity and acceleration
+    SCurve = 1       ///< Trapezoidal followed by a moving average (bounded jerk)
+  };
+
+  /**
+   * @brief Per-axis motion limits.
+   */
+  struct Limits {
+    uint16_t max_velocity = 6 << FRAC_BITS_;  ///< Q8 ticks per frame (> 0)
+    uint16_t max_accel = 1 << FRAC_BITS_;     ///< Q8 ticks per frame^2 (> 0)
+    Profile profile = Profile::Trapezoidal;   ///< Motion profile
+    uint8_t scurve_shift = 2;                 ///< S-curve filter length = 2^shift frames
+    uint16_t min_ticks = 0;                   ///< Lowest allowed target (ticks)
+    uint16_t max_ticks = MAX_TICKS_;          ///< Highest allowed target (ticks)
+  };
+
+  /**
+   * @brief Construct with every axis at rest at tick 0 and default limits.
+   */
+  Trajectory() noexcept {
+    for (size_t i = 0; i < NumAxes; ++i) {
+      Jump(i, 0);
+    }
+  }
+
+  /**
+   * @brief Set the limits of one axis; its S-curve filter is re-seeded at the current position.
+   * @param axis Axis index.
+   * @param limits New limits (zero velocity or acceleration is raised to 1).
+   */
+  void SetLimits(size_t axis, const Limits& limits) noexcept {
+    if (axis >= NumAxes) {
+      return;
+    }
+    Axis& a = axes_[axis];
+    a.limits = limits;
+    a.limits.max_velocity = limits.max_velocity != 0 ? limits.max_velocity : 1;
+    a.limits.max_accel = limits.max_accel != 0 ? limits.max_accel : 1;
+    a.limits.max_ticks = limits.max_ticks > MAX_TICKS_ ? MAX_TICKS_ : limits.max_ticks;
+    a.limits.min_ticks = limits.min_ticks > a.limits.max_ticks ? a.limits.max_ticks
+                                                               : limits.min_ticks;
+    a.shift = 0;
+    if (limits.profile == Profile::SCurve) {
+      while (a.shift < limits.scurve_shift && (size_t{1} << (a.shift + 1)) <= MaxSmoothing) {
+        ++a.shift;
+      }
+    }
+    a.target = clampTicks(a, a.target);
+    seedFilter(a);
+  }
+
+  /**
+   * @brief Set the same limits on every axis.
+   * @param limits New limits.
+   */
+  void SetAllLimits(const Limits& limits) noexcept {
+    for (size_t i = 0; i < NumAxes; ++i) {
+      SetLimits(i, limits);
+    }
+  }
+
+  /**
+   * @brief Get the limits of an axis.
+   * @param axis Axis index (must be < NumAxes).
+   */
+  [[nodiscard]] const Limits& GetLimits(size_t axis) const noexcept {
+    return axes_[axis < NumAxes ? axis : 0].limits;
+  }
+
+  /**
+   * @brief Set the target of one axis (clamped to its min/max ticks).
+   * @param axis Axis index.
+   * @param ticks Target position in ticks.
+   */
+  void SetTarget(size_t axis, uint16_t ticks) noexcept {
+    if (axis < NumAxes) {
+      axes_[axis].target = clampTicks(axes_[axis], ticks);
+    }
+  }
+
+  /**
+   * @brief Set every axis to the same target.
+   * @param ticks Target position in ticks.
+   */
+  void SetAllTargets(uint16_t ticks) noexcept {
+    for (size_t i = 0; i < NumAxes; ++i) {
+      SetTarget(i, ticks);
+    }
+  }
+
+  /**
+   * @brief Place an axis at a position immediately, at rest (e.g. to sync with hardware at boot).
+   * @param axis Axis index.
+   * @param ticks Position and target in ticks.
+   */
+  void Jump(size_t axis, uint16_t ticks) noexcept {
+    if (axis >= NumAxes) {
+      return;
+    }
+    Axis& a = axes_[axis];
+    a.target = clampTicks(a, ticks);
+    a.position = static_cast<int32_t>(a.target) << FRAC_BITS_;
+    a.velocity = 0;
+    seedFilter(a);
+  }
+
+  /**
+   * @brief Place every axis at the same position, at rest.
+   * @param ticks Position and target in ticks.
+   */
+  void JumpAll(uint16_t ticks) noexcept {
+    for (size_t i = 0; i < NumAxes; ++i) {
+      Jump(i, ticks);
+    }
+  }
+
+  /**
+   * @brief Advance every axis by one frame.
+   * @return true if at least one axis output changed.
+   */
+  bool Step() noexcept {
+    bool changed = false;
+    for (Axis& a : axes_) {
+      const uint16_t before = outputTicks(a);
+      stepAxis(a);
+      changed |= outputTicks(a) != before;
+    }
+    return changed;
+  }
+
+  /**
+   * @brief Current output position of an axis (after S-curve smoothing), in ticks.
+   * @param axis Axis index.
+   */
+  [[nodiscard]] uint16_t GetPosition(size_t axis) const noexcept {
+    return axis < NumAxes ? outputTicks(axes_[axis]) : 0;
+  }
+
+  /**
+   * @brief Current target of an axis, in ticks.
+   * @param axis Axis index.
+   */
+  [[nodiscard]] uint16_t GetTarget(size_t axis) const noexcept {
+    return axis < NumAxes ? axes_[axis].target : 0;
+  }
+
+  /**
+   * @brief Current velocity of an axis before smoothing (Q8 ticks per frame, signed).
+   * @param axis Axis index.
+   */
+  [[nodiscard]] int32_t GetVelocity(size_t axis) const noexcept {
+    return axis < NumAxes ? axes_[axis].velocity : 0;
+  }
+
+  /**
+   * @brief Check whether an axis is at rest on its target (including the S-curve filter).
+   * @param axis Axis index.
+   */
+  [[nodiscard]] bool AtTarget(size_t axis) const noexcept {
+    return axis >= NumAxes || settled(axes_[axis]);
+  }
+
+  /**
+   * @brief Check whether every axis is at rest on its target.
+   */
+  [[nodiscard]] bool AllAtTarget() const noexcept {
+    for (const Axis& a : axes_) {
+      if (!settled(a)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Stage up to 16 consecutive axes into a driver's pending frame.
+   *
+   * Axis `first_axis + ch` becomes a pulse of GetPosition() ticks on channel `ch`,
+   * staged with StageDutyTicks() so the driver's phase mode applies. Call
+   * CommitFrame() on the driver afterwards; unchanged channels cost no bus traffic.
+   *
+   * @tparam Driver A PCA9685 driver type.
+   * @param driver Driver to stage into.
+   * @param first_axis First axis mapped to channel 0.
+   * @param channels Number of channels to stage (clamped to 16 and to the axes left).
+   * @return true if every channel was staged.
+   */
+  template <typename Driver>
+  bool Stage(Driver& driver, size_t first_axis = 0, uint8_t channels = 16) const noexcept {
+    if (first_axis >= NumAxes) {
+      return false;
+    }
+    const size_t count = ::std::min<size_t>({channels, size_t{16}, NumAxes - first_axis});
+    bool ok = true;
+    for (size_t ch = 0; ch < count; ++ch) {
+      ok &= driver.StageDutyTicks(static_cast<uint8_t>(ch), outputTicks(axes_[first_axis + ch]));
+    }
+    return ok;
+  }
+
+private:
+  struct Axis {
+    Limits limits{};
+    int32_t position{0};   ///< Q8 ticks, unfiltered
+    int32_t velocity{0};   ///< Q8 ticks per frame
+    int32_t filter_sum{0}; ///< Sum of the filter taps
+    ::std::array<int32_t, MaxSmoothing> taps{};
+    uint8_t shift{0}; ///< Active filter length = 2^shift
+    uint8_t tap_index{0};
+    uint8_t settle{0}; ///< Frames the unfiltered position has been at rest on target
+    uint16_t target{0};
+  };
+
+  ::std::array<Axis, NumAxes> axes_{};
+
+  static uint16_t clampTicks(const Axis& a, uint16_t ticks) noexcept {
+    if (ticks < a.limits.min_ticks) {
+      return a.limits.min_ticks;
+    }
+    return ticks > a.limits.max_ticks ? a.limits.max_ticks : ticks;
+  }
+
+  static bool settled(const Axis& a) noexcept {
+    return a.velocity == 0 && a.position == (static_cast<int32_t>(a.target) << FRAC_BITS_) &&
+           a.settle >= (1U << a.shift);
+  }
+
+  /** @brief Filtered position in ticks, clamped to the axis range (the unfiltered position
+   * can pass it when braking from a target change or a lower max_accel overshoots). */
+  static uint16_t outputTicks(const Axis& a) noexcept {
+    const int32_t filtered = a.filter_sum >> a.shift;
+    const int32_t ticks = (filtered + (1 << (FRAC_BITS_ - 1))) >> FRAC_BITS_;
+    return static_cast<uint16_t>(
+        ::std::clamp<int32_t>(ticks, a.limits.min_ticks, a.limits.max_ticks));
+  }
+
+  static void seedFilter(Axis& a) noexcept {
+    a.taps.fill(a.position);
+    a.filter_sum = a.position << a.shift;
+    a.tap_index = 0;
+    a.settle = static_cast<uint8_t>(1U << a.shift);
+  }
+
+  /**
+   * @brief Check that an axis moving at @p speed can still stop within @p remaining.
+   *
+   * Braking at `accel` per frame from `speed` covers `n * speed - accel * n(n+1)/2` with
+   * `n = speed / accel` further frames; that distance must fit after this frame's move.
+   */
+  static bool canStop(int32_t speed, int32_t remaining, int32_t accel) noexcept {
+    if (speed > remaining) {
+      return false;
+    }
+    const int64_t n = speed / accel;
+    const int64_t braking = (n * speed) - ((accel * n * (n + 1)) / 2);
+    return braking <= static_cast<int64_t>(remaining - speed);
+  }
+
+  static void stepAxis(Axis& a) noexcept {
+    const int32_t goal = static_cast<int32_t>(a.target) << FRAC_BITS_;
+    const int32_t dist = goal - a.position;
+    if (dist == 0 && a.velocity == 0 && a.settle >= (1U << a.shift)) {
+      return; // At rest and the filter has converged
+    }
+    if (dist != 0 || a.velocity != 0) {
+      const int32_t accel = a.limits.max_accel;
+      const int32_t vmax = a.limits.max_velocity;
+      const int32_t dir = dist > 0 || (dist == 0 && a.velocity < 0) ? 1 : -1;
+      const int32_t remaining = dist * dir;
+      const int32_t speed = a.velocity * dir; // Negative while moving away from the goal
+      if (remaining <= accel && speed >= -accel && speed <= accel) {
+        // Close enough to come to rest within one acceleration step: land on the goal
+        a.position = goal;
+        a.velocity = 0;
+      } else {
+        int32_t next = speed + accel;
+        next = next > vmax ? (speed - accel > vmax ? speed - accel : vmax) : next;
+        if (speed >= 0 && !canStop(next, remaining, accel)) {
+          // Largest of accelerate / hold / brake that still stops on the goal; if even full
+          // braking overshoots (the target jumped closer), brake anyway and come back
+          next = speed <= vmax && canStop(speed, remaining, accel) ? speed : speed - accel;
+        }
+        a.velocity = next * dir;
+        a.position += a.velocity;
+      }
+      a.settle = 0;
+    }
+    if (a.settle < (1U << a.shift)) {
+      ++a.settle;
+    }
+    const uint8_t mask = static_cast<uint8_t>((1U << a.shift) - 1);
+    a.filter_sum += a.position - a.taps[a.tap_index];
+    a.taps[a.tap_index] = a.position;
+    a.tap_index = static_cast<uint8_t>((a.tap_index + 1) & mask);
+  }
+};
+
+} // namespace pca9685
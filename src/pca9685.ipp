@@ -27,6 +27,9 @@ pca9685::PCA9685<I2cType>::PCA9685(I2cType* bus, uint8_t address) : i2c_(bus), a
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::EnsureInitialized() noexcept {
   if (initialized_) {
+    if (verify_pending_) {
+      (void)VerifyAndRestore(); // A transfer failed earlier: check for a power loss first
+    }
     return true; // Already initialized
   }
   return Reset();
@@ -34,6 +37,9 @@ bool pca9685::PCA9685<I2cType>::EnsureInitialized() noexcept {
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::Reset() noexcept {
+  // An explicit reset is a recovery attempt: let it reach the bus even with the breaker open
+  health_.ForceClose();
+  retry_policy_.BeginFrame();
   // Ensure I2C bus is initialized and ready (mirrors PCAL95555 pattern)
   if (!i2c_ || !i2c_->EnsureInitialized()) {
     setError(Error::I2cWrite);
@@ -41,23 +47,25 @@ bool pca9685::PCA9685<I2cType>::Reset() noexcept {
     return false;
   }
 
-  uint8_t mode1 = 0x00; // Reset value
+  uint8_t mode1 = MODE1_AI_; // Reset value, with auto-increment for block transfers
   if (!writeReg(static_cast<uint8_t>(Register::MODE1), mode1)) {
     initialized_ = false;
     return false;
   }
   initialized_ = true;
+  verify_pending_ = false;
   last_error_ = Error::None;
   return true;
 }
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::SetPwmFreq(float freq_hz) noexcept {
+  LatencyScope latency(*this, Operation::SetPwmFreq);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
   }
-  if (freq_hz < 24.0F || freq_hz > 1526.0F) {
+  if (freq_hz < GetMinPwmFreq() || freq_hz > GetMaxPwmFreq()) {
     setError(Error::OutOfRange);
     return false;
   }
@@ -81,39 +89,144 @@ bool pca9685::PCA9685<I2cType>::SetPwmFreq(float freq_hz) noexcept {
 }
 
 template <typename I2cType>
-bool pca9685::PCA9685<I2cType>::SetPwm(uint8_t channel, uint16_t on_time,
-                                       uint16_t off_time) noexcept {
+bool pca9685::PCA9685<I2cType>::SetPwmFreqFast(float freq_hz) noexcept {
+  LatencyScope latency(*this, Operation::SetPwmFreq);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
   }
-  if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+  if (freq_hz < GetMinPwmFreq() || freq_hz > GetMaxPwmFreq()) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  const uint8_t prescale = calcPrescale(freq_hz);
+  if (prescale_known_ && prescale == prescale_cache_) {
+    last_error_ = Error::None;
+    return true;
+  }
+  const uint8_t mode1 = mode1_cache_;
+  if ((mode1 & MODE1_SLEEP_) != 0) {
+    // Already asleep: PRE_SCALE is writable and Wake() restarts the outputs later
+    if (!writeReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale)) {
+      return false;
+    }
+    last_error_ = Error::None;
+    return true;
+  }
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1),
+                static_cast<uint8_t>(mode1 | MODE1_SLEEP_))) {
+    return false;
+  }
+  if (!writeReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale)) {
+    return false;
+  }
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1), mode1)) {
+    return false;
+  }
+  restart_due_us_ = nowUs() + OSC_SETTLE_US_;
+  restart_pending_ = true;
+  last_error_ = Error::None;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::ServiceRestart() noexcept {
+  if (restart_pending_) {
+    if (clock_ && static_cast<int32_t>(nowUs() - restart_due_us_) < 0) {
+      return true; // Oscillator still settling
+    }
+    if ((mode1_cache_ & MODE1_SLEEP_) == 0 &&
+        !writeReg(static_cast<uint8_t>(Register::MODE1),
+                  static_cast<uint8_t>(mode1_cache_ | MODE1_RESTART_))) {
+      return false;
+    }
+    restart_pending_ = false;
+  }
+  return flushQueuedFrame();
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::flushQueuedFrame() noexcept {
+  if (!frame_queued_) {
+    return true;
+  }
+  frame_queued_ = false;
+  if (!commitFrame()) {
+    frame_queued_ = true;
+    return false;
+  }
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::EnableExternalClock(uint32_t clock_hz) noexcept {
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  if (!IsValidClockHz(clock_hz)) {
     setError(Error::OutOfRange);
     return false;
   }
-  uint8_t reg = static_cast<uint8_t>(Register::LED0_ON_L) + (4 * channel);
-  ::std::array<uint8_t, 4> data = {
-      static_cast<uint8_t>(on_time & 0xFF), static_cast<uint8_t>((on_time >> 8) & 0x0F),
-      static_cast<uint8_t>(off_time & 0xFF), static_cast<uint8_t>((off_time >> 8) & 0x0F)};
-  if (!writeRegBlock(reg, data.data(), 4)) {
+  uint8_t old_mode = 0;
+  if (!readReg(static_cast<uint8_t>(Register::MODE1), old_mode)) {
+    return false;
+  }
+  // EXTCLK is only accepted while SLEEP is already set
+  const uint8_t sleep = (old_mode & 0x7F) | MODE1_SLEEP_;
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1), sleep)) {
+    return false;
+  }
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1),
+                static_cast<uint8_t>(sleep | MODE1_EXTCLK_))) {
+    return false; // EXTCLK not latched: the driver keeps its previous clock
+  }
+  // Acknowledged: the device now runs from EXTCLK until a power cycle or software reset,
+  // even if the wake write below fails (it is then left asleep, see the header)
+  ext_clock_ = true;
+  osc_freq_ = clock_hz;
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1),
+                static_cast<uint8_t>((old_mode & 0x7F) | MODE1_EXTCLK_))) {
     return false;
   }
   last_error_ = Error::None;
   return true;
 }
 
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::SetPwm(uint8_t channel, uint16_t on_time,
+                                       uint16_t off_time) noexcept {
+  LatencyScope latency(*this, Operation::SetPwm);
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  return writeChannel(channel, on_time, off_time);
+}
+
 template <typename I2cType>
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters) - Types are different enough (uint8_t vs
 // float)
 bool pca9685::PCA9685<I2cType>::SetDuty(uint8_t channel, float duty) noexcept {
-  duty = ::std::max(duty, 0.0F);
-  duty = ::std::min(duty, 1.0F);
-  auto off_time = static_cast<uint16_t>(lroundf((duty * MAX_PWM_)));
-  return SetPwm(channel, 0, off_time);
+  LatencyScope latency(*this, Operation::SetPwm);
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  if (channel >= MAX_CHANNELS_) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  return writeDuty(channel, DutyToTicks(duty));
 }
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::SetAllPwm(uint16_t on_time, uint16_t off_time) noexcept {
+  LatencyScope latency(*this, Operation::Burst);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
@@ -122,26 +235,121 @@ bool pca9685::PCA9685<I2cType>::SetAllPwm(uint16_t on_time, uint16_t off_time) n
     setError(Error::OutOfRange);
     return false;
   }
-  ::std::array<uint8_t, 4> data = {
-      static_cast<uint8_t>(on_time & 0xFF), static_cast<uint8_t>((on_time >> 8) & 0x0F),
-      static_cast<uint8_t>(off_time & 0xFF), static_cast<uint8_t>((off_time >> 8) & 0x0F)};
-  if (!writeRegBlock(static_cast<uint8_t>(Register::ALL_LED_ON_L), data.data(), 4)) {
+  return writeAllChannels(on_time, off_time);
+}
+
+// ---- Frame Staging ----
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::StagePwm(uint8_t channel, uint16_t on_time,
+                                         uint16_t off_time) noexcept {
+  if (channel >= MAX_CHANNELS_ || on_time > MAX_PWM_ || off_time > MAX_PWM_) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  const ::std::array<uint8_t, 4> data = PackChannel(on_time, off_time);
+  ::std::copy(data.begin(), data.end(), frame_image_.begin() + (4 * channel));
+  duty_mask_ &= static_cast<uint16_t>(~(1U << channel));
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::StageDutyTicks(uint8_t channel, uint16_t ticks) noexcept {
+  if (channel >= MAX_CHANNELS_ || ticks > DUTY_FULL_SCALE_) {
+    setError(Error::OutOfRange);
     return false;
   }
-  last_error_ = Error::None;
+  stageDuty(channel, ticks);
   return true;
 }
 
+template <typename I2cType>
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters) - Types are different enough (uint8_t vs
+// float)
+bool pca9685::PCA9685<I2cType>::StageDuty(uint8_t channel, float duty) noexcept {
+  duty = ::std::max(duty, 0.0F);
+  duty = ::std::min(duty, 1.0F);
+  return StageDutyTicks(channel, static_cast<uint16_t>(lroundf(duty * DUTY_FULL_SCALE_)));
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::CommitFrame() noexcept {
+  LatencyScope latency(*this, Operation::Burst);
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  return commitFrame();
+}
+
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::GetPrescale(uint8_t& prescale) noexcept {
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
   }
-  if (!readReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale)) {
+  return readPrescale(prescale);
+}
+
+// ---- Brightness (LED channels) ----
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::SetBrightness(uint8_t channel, uint16_t level) noexcept {
+  LatencyScope latency(*this, Operation::SetPwm);
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
     return false;
   }
-  last_error_ = Error::None;
+  if (channel >= MAX_CHANNELS_) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  const uint16_t ticks = levelToTicks(level);
+  if (ticks == 0) {
+    return writeChannel(channel, 0, FULL_BIT_);
+  }
+  if (ticks >= DUTY_FULL_SCALE_) {
+    return writeChannel(channel, FULL_BIT_, 0);
+  }
+  return writeDuty(channel, ticks);
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::StageBrightness(uint8_t channel, uint16_t level) noexcept {
+  if (channel >= MAX_CHANNELS_) {
+    setError(Error::OutOfRange);
+    return false;
+  }
+  stageDuty(channel, levelToTicks(level));
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::StageBrightness(uint8_t first_channel, const uint16_t* levels,
+                                                uint8_t count) noexcept {
+  if (levels == nullptr || first_channel >= MAX_CHANNELS_ ||
+      count > MAX_CHANNELS_ - first_channel) {
+    setError(Error::InvalidParam);
+    return false;
+  }
+  for (uint8_t i = 0; i < count; ++i) {
+    stageDuty(static_cast<uint8_t>(first_channel + i), levelToTicks(levels[i]));
+  }
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::StageBrightness(uint8_t first_channel, const uint8_t* levels,
+                                                uint8_t count) noexcept {
+  if (levels == nullptr || first_channel >= MAX_CHANNELS_ ||
+      count > MAX_CHANNELS_ - first_channel) {
+    setError(Error::InvalidParam);
+    return false;
+  }
+  for (uint8_t i = 0; i < count; ++i) {
+    stageDuty(static_cast<uint8_t>(first_channel + i),
+              levelToTicks(static_cast<uint16_t>(levels[i] * 257U)));
+  }
   return true;
 }
 
@@ -153,20 +361,42 @@ bool pca9685::PCA9685<I2cType>::Sleep() noexcept {
     setError(Error::NotInitialized);
     return false;
   }
-  return modifyReg(static_cast<uint8_t>(Register::MODE1), 0x10, 0x10); // Set SLEEP bit
+  // Set SLEEP; write RESTART as 0 (no effect) rather than echoing a pending RESTART back
+  if (!modifyReg(static_cast<uint8_t>(Register::MODE1), MODE1_SLEEP_ | MODE1_RESTART_,
+                 MODE1_SLEEP_)) {
+    return false;
+  }
+  // A pending RESTART is moot now; LEDn registers are writable while asleep
+  restart_pending_ = false;
+  return flushQueuedFrame();
 }
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::Wake() noexcept {
+  LatencyScope latency(*this, Operation::Wake);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
   }
+  if (restart_pending_) {
+    // Settling after WakeAsync() or SetPwmFreqFast(): finish that wake (RESTART + queue)
+    const auto remaining = static_cast<int32_t>(restart_due_us_ - nowUs());
+    if (clock_ && retry_delay_us_ && remaining > 0) {
+      retry_delay_us_(static_cast<uint32_t>(remaining));
+    }
+    restart_due_us_ = nowUs();
+    if (!ServiceRestart()) {
+      return false;
+    }
+    last_error_ = Error::None;
+    return true;
+  }
   uint8_t mode1 = 0;
   if (!readReg(static_cast<uint8_t>(Register::MODE1), mode1)) {
     return false;
   }
-  uint8_t new_mode1 = mode1 & static_cast<uint8_t>(~0x10U); // Clear SLEEP
+  // Clear SLEEP; RESTART (set on read while outputs are held) is written separately below
+  uint8_t new_mode1 = mode1 & static_cast<uint8_t>(~0x90U);
   if (!writeReg(static_cast<uint8_t>(Register::MODE1), new_mode1)) {
     return false;
   }
@@ -181,6 +411,28 @@ bool pca9685::PCA9685<I2cType>::Wake() noexcept {
   return true;
 }
 
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::WakeAsync() noexcept {
+  LatencyScope latency(*this, Operation::Wake);
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  const uint8_t mode1 = mode1_cache_;
+  if ((mode1 & MODE1_SLEEP_) == 0) {
+    last_error_ = Error::None;
+    return true; // Awake, or already settling
+  }
+  if (!writeReg(static_cast<uint8_t>(Register::MODE1),
+                static_cast<uint8_t>(mode1 & ~MODE1_SLEEP_))) {
+    return false;
+  }
+  restart_due_us_ = nowUs() + OSC_SETTLE_US_;
+  restart_pending_ = true;
+  last_error_ = Error::None;
+  return true;
+}
+
 // ---- Output Configuration ----
 
 template <typename I2cType>
@@ -207,6 +459,7 @@ bool pca9685::PCA9685<I2cType>::SetOutputDriverMode(bool totem_pole) noexcept {
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::SetChannelFullOn(uint8_t channel) noexcept {
+  LatencyScope latency(*this, Operation::SetPwm);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
@@ -215,18 +468,13 @@ bool pca9685::PCA9685<I2cType>::SetChannelFullOn(uint8_t channel) noexcept {
     setError(Error::OutOfRange);
     return false;
   }
-  uint8_t reg = static_cast<uint8_t>(Register::LED0_ON_L) + (4 * channel);
   // Set LEDn_ON_H bit 4 (full-on), clear LEDn_OFF_H bit 4 (full-off)
-  ::std::array<uint8_t, 4> data = {0x00, 0x10, 0x00, 0x00};
-  if (!writeRegBlock(reg, data.data(), 4)) {
-    return false;
-  }
-  last_error_ = Error::None;
-  return true;
+  return writeChannel(channel, FULL_BIT_, 0);
 }
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::SetChannelFullOff(uint8_t channel) noexcept {
+  LatencyScope latency(*this, Operation::SetPwm);
   if (!EnsureInitialized()) {
     setError(Error::NotInitialized);
     return false;
@@ -235,10 +483,85 @@ bool pca9685::PCA9685<I2cType>::SetChannelFullOff(uint8_t channel) noexcept {
     setError(Error::OutOfRange);
     return false;
   }
-  uint8_t reg = static_cast<uint8_t>(Register::LED0_ON_L) + (4 * channel);
   // Clear LEDn_ON_H bit 4, set LEDn_OFF_H bit 4 (full-off)
-  ::std::array<uint8_t, 4> data = {0x00, 0x00, 0x00, 0x10};
-  if (!writeRegBlock(reg, data.data(), 4)) {
+  return writeChannel(channel, 0, FULL_BIT_);
+}
+
+// ---- Unchecked channel writers (shared with ReadyHandle) ----
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::writeChannel(uint8_t channel, uint16_t on_time,
+                                             uint16_t off_time) noexcept {
+  const auto reg = static_cast<uint8_t>(static_cast<uint8_t>(Register::LED0_ON_L) + (4 * channel));
+  const ::std::array<uint8_t, 4> data = PackChannel(on_time, off_time);
+  if (restart_pending_) {
+    queueChannel(channel, data.data());
+    return true;
+  }
+  if (!wakeForWrite(PowerPolicy::IsChannelIdle(data.data())) ||
+      !writeRegBlock(reg, data.data(), 4)) {
+    return false;
+  }
+  storeChannel(channel, data.data());
+  notePowerActivity();
+  last_error_ = Error::None;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::writeAllChannels(uint16_t on_time, uint16_t off_time) noexcept {
+  if (phase_mode_ != PhaseMode::None) {
+    // One ALL_LED write would put every ON edge on the same tick: stagger the duty instead
+    const uint16_t ticks = (off_time - on_time) & MAX_PWM_;
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      stageDuty(ch, ticks);
+    }
+    return commitFrame();
+  }
+  const ::std::array<uint8_t, 4> data = PackChannel(on_time, off_time);
+  if (restart_pending_) {
+    for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+      queueChannel(ch, data.data());
+    }
+    return true;
+  }
+  if (!wakeForWrite(PowerPolicy::IsChannelIdle(data.data())) ||
+      !writeRegBlock(static_cast<uint8_t>(Register::ALL_LED_ON_L), data.data(), 4)) {
+    return false;
+  }
+  for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+    storeChannel(ch, data.data());
+  }
+  notePowerActivity();
+  last_error_ = Error::None;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::commitFrame() noexcept {
+  if (restart_pending_) {
+    frame_queued_ = true; // Staged duties are packed when ServiceRestart() commits
+    last_error_ = Error::None;
+    return true;
+  }
+  layoutPhases();
+  PackDuties(frame_image_, duty_ticks_, duty_mask_, phase_offset_);
+  uint8_t first = 0;
+  uint8_t count = 0;
+  if (FindChangedSpan(frame_image_, channel_image_, first, count) &&
+      (!wakeForWrite(PowerPolicy::IsImageIdle(frame_image_.data(), MAX_CHANNELS_)) ||
+       !writeChannelRange(frame_image_, first, count))) {
+    return false;
+  }
+  written_ticks_ = duty_ticks_;
+  written_mask_ = duty_mask_;
+  last_error_ = Error::None;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::readPrescale(uint8_t& prescale) noexcept {
+  if (!readReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale)) {
     return false;
   }
   last_error_ = Error::None;
@@ -248,94 +571,280 @@ bool pca9685::PCA9685<I2cType>::SetChannelFullOff(uint8_t channel) noexcept {
 // ---- Low-level register access with retries ----
 
 template <typename I2cType>
-bool pca9685::PCA9685<I2cType>::writeReg(uint8_t reg, uint8_t value) noexcept {
+template <typename Attempt>
+bool pca9685::PCA9685<I2cType>::transfer(Attempt&& attempt, Error error) noexcept {
   if (!i2c_) {
     return false;
   }
-  for (int attempt = 0; attempt <= retries_; ++attempt) {
-    if (i2c_->Write(addr_, reg, &value, 1)) {
+  if (!health_.AllowsTransfer()) {
+    // Breaker open: skip the bus unless the cool-down has expired and a probe succeeds
+    if (!clock_ || !health_.ProbeDue(clock_()) || !ProbeDevice()) {
+      health_.RecordSkipped();
+      setError(Error::DeviceNotFound);
+      return false;
+    }
+  }
+  for (uint8_t retries_done = 0;; ++retries_done) {
+    if (attempt()) {
+      retry_policy_.RecordSuccess();
+      health_.RecordSuccess(nowUs());
       return true;
     }
-    if (attempt < retries_ && retry_delay_) {
+    if (!retry_policy_.ConsumeRetry(retries_done)) {
+      break;
+    }
+    uint32_t delay_us = retry_policy_.NextDelayUs(retries_done);
+    if (delay_us != 0 && retry_delay_us_) {
+      retry_delay_us_(delay_us);
+    } else if (retry_delay_) {
       retry_delay_();
     }
   }
-  setError(Error::I2cWrite);
+  retry_policy_.RecordFailure();
+  health_.RecordFailure(nowUs());
+  verify_pending_ = verify_after_error_ && initialized_;
+  setError(error);
   return false;
 }
 
 template <typename I2cType>
-bool pca9685::PCA9685<I2cType>::readReg(uint8_t reg, uint8_t& value) noexcept {
-  if (!i2c_) {
+bool pca9685::PCA9685<I2cType>::writeReg(uint8_t reg, uint8_t value) noexcept {
+  if (!transfer([&]() { return i2c_->Write(addr_, reg, &value, 1); }, Error::I2cWrite)) {
     return false;
   }
-  for (int attempt = 0; attempt <= retries_; ++attempt) {
-    if (i2c_->Read(addr_, reg, &value, 1)) {
-      return true;
-    }
-    if (attempt < retries_ && retry_delay_) {
-      retry_delay_();
-    }
-  }
-  setError(Error::I2cRead);
-  return false;
+  cacheConfig(reg, value);
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::readReg(uint8_t reg, uint8_t& value) noexcept {
+  return transfer([&]() { return i2c_->Read(addr_, reg, &value, 1); }, Error::I2cRead);
 }
 
 template <typename I2cType>
 bool pca9685::PCA9685<I2cType>::writeRegBlock(uint8_t reg, const uint8_t* data,
                                               size_t len) noexcept {
+  return transfer([&]() { return i2c_->Write(addr_, reg, data, len); }, Error::I2cWrite);
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::readRegBlock(uint8_t reg, uint8_t* data, size_t len) noexcept {
+  return transfer([&]() { return i2c_->Read(addr_, reg, data, len); }, Error::I2cRead);
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::modifyReg(uint8_t reg, uint8_t mask, uint8_t value) noexcept {
+  uint8_t current = 0;
+  if (!readReg(reg, current)) {
+    return false;
+  }
+  uint8_t new_val = (current & static_cast<uint8_t>(~mask)) | (value & mask);
+  if (!writeReg(reg, new_val)) {
+    return false;
+  }
+  last_error_ = Error::None;
+  return true;
+}
+
+// ---- Device health ----
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::ProbeDevice() noexcept {
   if (!i2c_) {
     return false;
   }
-  for (int attempt = 0; attempt <= retries_; ++attempt) {
-    if (i2c_->Write(addr_, reg, data, len)) {
-      return true;
+  const bool was_open = health_.GetState() != DeviceHealth::State::Closed;
+  if (was_open) {
+    health_.BeginProbe();
+  }
+  uint8_t mode1 = 0;
+  if (!i2c_->Read(addr_, static_cast<uint8_t>(Register::MODE1), &mode1, 1)) {
+    health_.RecordFailure(nowUs());
+    setError(Error::DeviceNotFound);
+    return false;
+  }
+  health_.RecordSuccess(nowUs());
+  if (was_open && initialized_) {
+    // The device may have lost power while unreachable: re-apply the cached state
+    return RestoreState();
+  }
+  return true;
+}
+
+template <typename I2cType>
+void pca9685::PCA9685<I2cType>::cacheConfig(uint8_t reg, uint8_t value) noexcept {
+  switch (static_cast<Register>(reg)) {
+  case Register::MODE1:
+    mode1_cache_ = static_cast<uint8_t>(value & ~MODE1_RESTART_); // RESTART is write-to-trigger
+    if ((value & MODE1_SLEEP_) == 0) {
+      power_policy_.RecordWake(nowUs()); // However it was woken (write, Wake(), Reset())
     }
-    if (attempt < retries_ && retry_delay_) {
-      retry_delay_();
+    if (ext_clock_) {
+      mode1_cache_ |= MODE1_EXTCLK_; // Sticky: writing 0 does not clear it
     }
+    break;
+  case Register::MODE2:
+    mode2_cache_ = value;
+    mode2_known_ = true;
+    break;
+  case Register::PRE_SCALE:
+    prescale_cache_ = value;
+    prescale_known_ = true;
+    break;
+  default:
+    break;
   }
-  setError(Error::I2cWrite);
-  return false;
 }
 
+// ---- Idle power policy ----
+
 template <typename I2cType>
-bool pca9685::PCA9685<I2cType>::readRegBlock(uint8_t reg, uint8_t* data, size_t len) noexcept {
-  if (!i2c_) {
+bool pca9685::PCA9685<I2cType>::ServicePowerPolicy() noexcept {
+  if (!initialized_ || GetPowerState() != PowerState::Awake ||
+      !power_policy_.SleepDue(nowUs())) {
+    return true;
+  }
+  if (!Sleep()) {
     return false;
   }
-  for (int attempt = 0; attempt <= retries_; ++attempt) {
-    if (i2c_->Read(addr_, reg, data, len)) {
-      return true;
-    }
-    if (attempt < retries_ && retry_delay_) {
-      retry_delay_();
+  power_policy_.RecordSleep(nowUs());
+  return true;
+}
+
+// ---- State verification / restore ----
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::VerifyAndRestore() noexcept {
+  if (!initialized_) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  uint8_t mode1 = 0;
+  if (!readReg(static_cast<uint8_t>(Register::MODE1), mode1)) {
+    return false;
+  }
+  bool consistent = (mode1 & static_cast<uint8_t>(~MODE1_RESTART_)) == mode1_cache_;
+  if (consistent && prescale_known_) {
+    uint8_t prescale = 0;
+    if (!readReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale)) {
+      return false;
     }
+    consistent = prescale == prescale_cache_;
   }
-  setError(Error::I2cRead);
-  return false;
+  verify_pending_ = false;
+  if (consistent) {
+    return true;
+  }
+  return RestoreState();
 }
 
 template <typename I2cType>
-bool pca9685::PCA9685<I2cType>::modifyReg(uint8_t reg, uint8_t mask, uint8_t value) noexcept {
-  uint8_t current = 0;
-  if (!readReg(reg, current)) {
+bool pca9685::PCA9685<I2cType>::RestoreState() noexcept {
+  if (!initialized_) {
+    setError(Error::NotInitialized);
     return false;
   }
-  uint8_t new_val = (current & static_cast<uint8_t>(~mask)) | (value & mask);
-  if (!writeReg(reg, new_val)) {
+  const uint8_t mode1 = mode1_cache_;
+  // PRE_SCALE and EXTCLK can only be written while SLEEP is set; keep outputs parked until
+  // the end
+  const auto parked = static_cast<uint8_t>(mode1 | MODE1_SLEEP_ | MODE1_AI_);
+  const bool restored =
+      writeReg(static_cast<uint8_t>(Register::MODE1),
+               static_cast<uint8_t>(parked & ~MODE1_EXTCLK_)) &&
+      ((mode1 & MODE1_EXTCLK_) == 0 || writeReg(static_cast<uint8_t>(Register::MODE1), parked)) &&
+      (!prescale_known_ || writeReg(static_cast<uint8_t>(Register::PRE_SCALE), prescale_cache_)) &&
+      (!mode2_known_ || writeReg(static_cast<uint8_t>(Register::MODE2), mode2_cache_)) &&
+      writeChannelRange(channel_image_, 0, MAX_CHANNELS_) &&
+      writeReg(static_cast<uint8_t>(Register::MODE1), mode1);
+  if (!restored) {
+    // The parked writes updated the MODE1 cache: put back the state to restore, so the next
+    // verify sees the mismatch and a retry wakes the device instead of re-parking it
+    mode1_cache_ = mode1;
+    return false;
+  }
+  ++restore_count_;
+  verify_pending_ = false;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::ReadAllChannels(
+    ::std::array<ChannelValue, MAX_CHANNELS_>& values) noexcept {
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
     return false;
   }
+  ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_> image{};
+  if (!readChannelImage(image)) {
+    return false;
+  }
+  for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+    const uint8_t* regs = image.data() + (4 * ch);
+    values[ch].on_time = static_cast<uint16_t>(regs[0] | ((regs[1] & 0x1F) << 8));
+    values[ch].off_time = static_cast<uint16_t>(regs[2] | ((regs[3] & 0x1F) << 8));
+  }
   last_error_ = Error::None;
   return true;
 }
 
 template <typename I2cType>
-uint8_t pca9685::PCA9685<I2cType>::calcPrescale(float freq_hz) const noexcept {
-  float prescale_val = (static_cast<float>(OSC_FREQ_) / (4096.0F * freq_hz)) - 1.0F;
-  prescale_val = ::std::max(prescale_val, 3.0F);
-  prescale_val = ::std::min(prescale_val, 255.0F);
-  return static_cast<uint8_t>(lroundf(prescale_val));
+bool pca9685::PCA9685<I2cType>::Verify(uint16_t& mismatch_mask) noexcept {
+  mismatch_mask = 0;
+  if (!EnsureInitialized()) {
+    setError(Error::NotInitialized);
+    return false;
+  }
+  ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_> image{};
+  if (!readChannelImage(image)) {
+    return false;
+  }
+  for (uint8_t ch = 0; ch < MAX_CHANNELS_; ++ch) {
+    const uint8_t* read = image.data() + (4 * ch);
+    const uint8_t* written = channel_image_.data() + (4 * ch);
+    // Bits 5-7 of the high bytes are reserved and never written
+    if (read[0] != written[0] || (read[1] & 0x1F) != written[1] || read[2] != written[2] ||
+        (read[3] & 0x1F) != written[3]) {
+      mismatch_mask |= static_cast<uint16_t>(1U << ch);
+    }
+  }
+  last_error_ = Error::None;
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::readChannelImage(
+    ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_>& image) noexcept {
+  for (size_t offset = 0; offset < CHANNEL_IMAGE_SIZE_; offset += max_burst_bytes_) {
+    const size_t len = ::std::min<size_t>(CHANNEL_IMAGE_SIZE_ - offset, max_burst_bytes_);
+    if (!readRegBlock(static_cast<uint8_t>(static_cast<uint8_t>(Register::LED0_ON_L) + offset),
+                      image.data() + offset, len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename I2cType>
+bool pca9685::PCA9685<I2cType>::writeChannelRange(
+    const ::std::array<uint8_t, CHANNEL_IMAGE_SIZE_>& image, uint8_t first,
+    uint8_t count) noexcept {
+  size_t offset = 4U * first;
+  size_t remaining = 4U * count;
+  while (remaining > 0) {
+    const size_t len = ::std::min<size_t>(remaining, max_burst_bytes_);
+    if (!writeRegBlock(static_cast<uint8_t>(static_cast<uint8_t>(Register::LED0_ON_L) + offset),
+                       image.data() + offset, len)) {
+      return false;
+    }
+    if (&image != &channel_image_) {
+      ::std::copy(image.begin() + offset, image.begin() + offset + len,
+                  channel_image_.begin() + offset);
+    }
+    offset += len;
+    remaining -= len;
+  }
+  notePowerActivity();
+  return true;
 }
 
 // Note: Namespace is closed in pca9685.hpp, not here
@@ -0,0 +1,62 @@
+/**
+ * @file pca9685_animation_test.cpp
+ * @brief Host tests of table sampling and the animation player
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Interpolation between full-scale neighbours (a sawtooth wrapping from 65535 to 0, a square
+ * or step table) is checked both in constant evaluation and at run time.
+ */
+#include <array>
+#include <cstdint>
+
+#include "pca9685_animation.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+constexpr std::array<uint16_t, 4> SAW = {0, 21845, 43690, 65535};
+constexpr std::array<uint16_t, 2> SQUARE = {65535, 0};
+
+// Full-scale jumps, evaluated at compile time
+static_assert(pca9685::SampleTable(SAW.data(), 4, (3U << 16) | 0x8000U) == 32767,
+              "sawtooth wrap, halfway down");
+static_assert(pca9685::SampleTable(SAW.data(), 4, (3U << 16) | 0xFFFFU) == 0,
+              "sawtooth wrap, end of the step");
+static_assert(pca9685::SampleTable(SQUARE.data(), 2, (1U << 16) | 0xFFFFU) == 65534,
+              "rising full-scale edge");
+static_assert(pca9685::SampleTable(SAW.data(), 4, (3U << 16) | 0x8000U, false) == 65535,
+              "no wrap: hold the last entry");
+
+void testFullScaleInterpolation() {
+  // Run time, so the sanitizer build sees the same arithmetic
+  volatile uint32_t index = (3U << 16) | 0xFFFFU;
+  Expect(pca9685::SampleTable(SAW.data(), 4, index) == 0, "falling full-scale step");
+  index = (1U << 16) | 0x4000U;
+  Expect(pca9685::SampleTable(SQUARE.data(), 2, index) == 16383, "rising full-scale step");
+  index = 0x4000U;
+  Expect(pca9685::SampleTable(SQUARE.data(), 2, index) == 49151, "falling quarter way");
+}
+
+void testSawtoothTrack() {
+  // 4 entries over 8 frames: half an entry per frame, so frame 7 sits halfway down the wrap
+  pca9685::AnimationPlayer<1> player;
+  Expect(player.AddTrack(0, SAW, 8) == 0, "track added");
+  std::array<uint16_t, 9> out{};
+  for (uint16_t& value : out) {
+    (void)player.Step();
+    value = player.GetOutput(0);
+  }
+  Expect(out[0] == 0 && out[1] == 10922 && out[6] == 65535, "sawtooth rises");
+  Expect(out[7] == 32767 && out[8] == 0, "interpolated wrap from 65535 to 0");
+}
+
+} // namespace
+
+int main() {
+  testFullScaleInterpolation();
+  testSawtoothTrack();
+  return Finish("animation");
+}
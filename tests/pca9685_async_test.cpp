@@ -0,0 +1,122 @@
+/**
+ * @file pca9685_async_test.cpp
+ * @brief Host tests of the coroutine front-end against the blocking driver
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * The same operations go through PCA9685 on one simulator and AsyncPCA9685 on another;
+ * both devices must end up with identical registers.
+ */
+#include <cstdint>
+#include <type_traits>
+
+#include "pca9685.hpp"
+#include "pca9685_async.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+using Bus = pca9685::QueuedBusAdapter<Sim>;
+using AsyncDriver = pca9685::AsyncPCA9685<Bus>;
+using PhaseMode = Driver::PhaseMode;
+
+static_assert(static_cast<uint16_t>(AsyncDriver::Error::DeviceNotFound) ==
+              static_cast<uint16_t>(Driver::Error::DeviceNotFound));
+static_assert(std::is_same_v<AsyncDriver::Error, pca9685::PCA9685<Bus>::Error>);
+
+constexpr uint8_t PRE_SCALE = 0xFE;
+
+/** @brief Blocking driver and coroutine front-end, each on its own simulated device. */
+struct Pair {
+  Sim sync_sim;
+  Sim async_sim;
+  Bus bus{async_sim};
+  Driver sync{&sync_sim, 0x40};
+  AsyncDriver async{&bus, 0x40};
+
+  /** @brief Run a task to completion by polling the queued bus. */
+  bool Run(pca9685::Task<bool> task) {
+    task.Start();
+    while (!task.IsDone()) {
+      bus.Poll();
+    }
+    return task.GetResult();
+  }
+
+  /** @brief true if the LEDn and PRE_SCALE registers of both devices match. */
+  bool Same() const {
+    for (uint8_t reg = 0x06; reg < 0x46; ++reg) {
+      if (sync_sim.GetRegister(reg) != async_sim.GetRegister(reg)) {
+        return false;
+      }
+    }
+    return sync_sim.GetRegister(PRE_SCALE) == async_sim.GetRegister(PRE_SCALE);
+  }
+};
+
+void testFrequency() {
+  Pair p;
+  Expect(p.sync.EnsureInitialized() && p.Run(p.async.EnsureInitializedAsync()), "init");
+  p.sync.SetOscillatorHz(27000000);
+  p.async.SetOscillatorHz(27000000);
+  Expect(p.async.GetMaxPwmFreq() == p.sync.GetMaxPwmFreq() &&
+             p.async.GetMinPwmFreq() == p.sync.GetMinPwmFreq(),
+         "limits follow the clock");
+  Expect(p.sync.SetPwmFreq(1600.0F) && p.Run(p.async.SetPwmFreqAsync(1600.0F)) && p.Same(),
+         "same prescale above the 25 MHz limit");
+  Expect(!p.Run(p.async.SetPwmFreqAsync(p.async.GetMaxPwmFreq() + 1.0F)) &&
+             p.async.GetLastError() == AsyncDriver::Error::OutOfRange,
+         "out of range");
+  p.async.SetOscillatorHz(0);
+  Expect(p.async.GetOscillatorHz() == 27000000, "invalid clock ignored");
+}
+
+void testPhaseLayout(PhaseMode mode) {
+  Pair p;
+  Expect(p.sync.EnsureInitialized() && p.Run(p.async.EnsureInitializedAsync()), "init");
+  p.sync.SetPhaseMode(mode, 100);
+  p.async.SetPhaseMode(static_cast<AsyncDriver::PhaseMode>(mode), 100);
+  bool ok = true;
+  for (uint8_t ch = 0; ch < 4; ++ch) {
+    ok &= p.sync.SetDuty(ch, 0.2F) && p.Run(p.async.SetDutyAsync(ch, 0.2F));
+  }
+  Expect(ok && p.Same(), "direct duty writes");
+  Expect(p.async.GetPhaseOffset(3) == p.sync.GetPhaseOffset(3), "same offsets");
+
+  // Staged duties, full-on/full-off and raw values in one frame
+  for (uint8_t ch = 4; ch < 8; ++ch) {
+    Expect(p.sync.StageDutyTicks(ch, ch * 300U) && p.async.StageDutyTicks(ch, ch * 300U),
+           "stage");
+  }
+  Expect(p.sync.StageDutyTicks(8, 4096) && p.async.StageDutyTicks(8, 4096) &&
+             p.sync.StageDutyTicks(9, 0) && p.async.StageDutyTicks(9, 0) &&
+             p.sync.StagePwm(10, 5, 6) && p.async.StagePwm(10, 5, 6),
+         "stage full-on, full-off and raw");
+  Expect(p.sync.CommitFrame() && p.Run(p.async.CommitFrameAsync()) && p.Same(), "commit");
+
+  // A longer duty moves the later channels at the next commit; discard restores the layout
+  Expect(p.sync.SetDuty(0, 0.5F) && p.Run(p.async.SetDutyAsync(0, 0.5F)), "duty change");
+  Expect(p.sync.StageDutyTicks(2, 3000) && p.async.StageDutyTicks(2, 3000), "stage");
+  p.sync.DiscardFrame();
+  p.async.DiscardFrame();
+  Expect(p.sync.CommitFrame() && p.Run(p.async.CommitFrameAsync()) && p.Same(), "re-laid out");
+
+  Expect(p.sync.SetAllPwm(0, 1000) && p.Run(p.async.SetAllPwmAsync(0, 1000)) && p.Same(),
+         "all channels");
+  Expect(p.async.GetErrorFlags() == 0, "no errors");
+}
+
+} // namespace
+
+int main() {
+  testFrequency();
+  testPhaseLayout(PhaseMode::None);
+  testPhaseLayout(PhaseMode::Even);
+  testPhaseLayout(PhaseMode::LoadBalanced);
+  return Finish("async");
+}
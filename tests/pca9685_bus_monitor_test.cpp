@@ -0,0 +1,196 @@
+/**
+ * @file pca9685_bus_monitor_test.cpp
+ * @brief Host tests of BusMonitor: wire-time accounting, windows, peaks, warnings, projection
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Runs on a virtual microsecond clock. The wire time charged for driver writes is checked
+ * against the simulator, which advances its own clock by the same per-transfer duration.
+ */
+#include <cmath>
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_bus_monitor.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+
+uint32_t g_now_us = 0;
+uint32_t NowUs() {
+  return g_now_us;
+}
+
+bool near(float value, float expected, float tolerance) {
+  return std::fabs(value - expected) <= tolerance;
+}
+
+/** @brief Bus that accepts every transfer (pure accounting tests). */
+class NullBus : public pca9685::I2cInterface<NullBus> {
+public:
+  bool Write(uint8_t /*addr*/, uint8_t /*reg*/, const uint8_t* /*data*/, size_t /*len*/) {
+    return true;
+  }
+  bool Read(uint8_t addr, uint8_t /*reg*/, uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = 0;
+    }
+    return addr != 0x7F; // 0x7F: no device
+  }
+  bool EnsureInitialized() {
+    return true;
+  }
+};
+
+struct WarningLog {
+  uint32_t windows = 0;
+  uint32_t demand = 0;
+  float last = 0.0F;
+};
+
+void OnWarning(void* context, pca9685::BusWarning warning, float utilisation) {
+  auto* log = static_cast<WarningLog*>(context);
+  if (warning == pca9685::BusWarning::WindowOverThreshold) {
+    ++log->windows;
+  } else {
+    ++log->demand;
+  }
+  log->last = utilisation;
+}
+
+void testTransferClocks() {
+  using Monitor = pca9685::BusMonitor<NullBus>;
+  // Write: address, register, 4 data bytes (9 clocks each) + START + STOP
+  Expect(Monitor::TransferClocks(4, false) == 56, "write clocks");
+  // Read: address, register, address again, 1 data byte + START, repeated START, STOP
+  Expect(Monitor::TransferClocks(1, true) == 39, "read clocks");
+}
+
+/** @brief Driver writes are charged exactly the time the simulator spends on the wire. */
+void testMatchesSimulator() {
+  Sim sim(0x40, 400000);
+  pca9685::BusMonitor<Sim> monitor(sim);
+  pca9685::BusMonitor<Sim>::Config cfg;
+  cfg.bus_hz = 400000;
+  monitor.Configure(cfg);
+  pca9685::PCA9685<pca9685::BusMonitor<Sim>> pwm(&monitor, 0x40);
+  bool ok = pwm.EnsureInitialized();
+  monitor.Reset();
+  const uint64_t start_ns = sim.NowNs();
+  for (uint16_t i = 0; i < 200 && ok; ++i) {
+    ok = pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, i);
+  }
+  ok &= pwm.SetAllPwm(0, 2048);
+  Expect(ok, "driver workload");
+  Expect(monitor.GetBusyNs() == sim.NowNs() - start_ns, "busy time equals simulated wire time");
+  const auto* device = monitor.FindDevice(0x40);
+  Expect(device != nullptr && device->transfers == 201 && device->bytes == 804 &&
+             device->busy_ns == monitor.GetBusyNs(),
+         "per-device totals");
+}
+
+void testWindowsAndPeak() {
+  NullBus bus;
+  pca9685::BusMonitor<NullBus, 2> monitor(bus);
+  pca9685::BusMonitor<NullBus, 2>::Config cfg;
+  cfg.bus_hz = 100000; // 10 us per clock
+  cfg.window_us = 100000;
+  cfg.warn_percent = 50.0F;
+  monitor.Configure(cfg);
+  WarningLog log;
+  monitor.SetWarningCallback(OnWarning, &log);
+  g_now_us = 1000;
+  monitor.SetClock(NowUs);
+
+  const uint8_t frame[64] = {};
+  // Window 1: 5 bursts of 64 bytes to 0x40 (5 x 596 clocks = 29.8 ms) and 5 single-channel
+  // writes to 0x41 (5 x 56 clocks = 2.8 ms): 32.6 %
+  for (int i = 0; i < 5; ++i) {
+    (void)monitor.Write(0x40, 0x06, frame, sizeof(frame));
+    (void)monitor.Write(0x41, 0x06, frame, 4);
+    g_now_us += 10000;
+  }
+  // Window 2: 15 bursts (89.4 %), then window 3 idle
+  g_now_us = 1000 + 100000;
+  for (int i = 0; i < 15; ++i) {
+    (void)monitor.Write(0x40, 0x06, frame, sizeof(frame));
+    g_now_us += 5000;
+  }
+  g_now_us = 1000 + 250000;
+  monitor.Update();
+  Expect(monitor.GetWindowCount() == 2, "two windows closed");
+  Expect(near(monitor.GetUtilisationPercent(), 89.4F, 0.01F), "last window utilisation");
+  Expect(near(monitor.GetPeakUtilisationPercent(), 89.4F, 0.01F) &&
+             monitor.GetPeakWindowStartUs() == 101000,
+         "peak window");
+  Expect(log.windows == 1 && monitor.GetOverThresholdCount() == 1 && near(log.last, 89.4F, 0.01F),
+         "one window over the threshold");
+  Expect(near(monitor.GetDeviceUtilisationPercent(0), 89.4F, 0.01F) &&
+             monitor.GetDeviceStats(1).window_busy_ns == 0,
+         "per-device window share");
+
+  // Long idle gap: every skipped window counts, utilisation drops to zero
+  g_now_us = 1000 + 800000;
+  monitor.Update();
+  Expect(monitor.GetWindowCount() == 8 && monitor.GetUtilisationPercent() == 0.0F,
+         "idle windows counted");
+  Expect(near(monitor.GetPeakUtilisationPercent(), 89.4F, 0.01F), "peak kept over idle windows");
+
+  // Addresses beyond MaxDevices are summed as untracked; failures are counted
+  (void)monitor.Write(0x42, 0x06, frame, 4);
+  uint8_t value = 0;
+  (void)monitor.Read(0x7F, 0x00, &value, 1);
+  Expect(monitor.GetDeviceCount() == 2 && monitor.FindDevice(0x42) == nullptr, "table full");
+  Expect(monitor.GetUntrackedStats().transfers == 2 && monitor.GetUntrackedStats().failed == 1,
+         "untracked traffic");
+
+  // Clock wrap-around
+  monitor.Reset();
+  g_now_us = 0xFFFFFFFFU - 50000U;
+  monitor.Update();
+  g_now_us += 150000;
+  monitor.Update();
+  Expect(monitor.GetWindowCount() == 1, "window closes across clock wrap");
+}
+
+void testProjection() {
+  NullBus bus;
+  pca9685::BusMonitor<NullBus> monitor(bus);
+  pca9685::BusMonitor<NullBus>::Config cfg;
+  cfg.bus_hz = 400000;
+  monitor.Configure(cfg);
+  WarningLog log;
+  monitor.SetWarningCallback(OnWarning, &log);
+
+  // 2 boards x 100 frames/s x 596 clocks = 119200 clocks/s of 400000
+  pca9685::FrameDemand demand;
+  demand.devices = 2;
+  demand.frame_hz = 100.0F;
+  Expect(near(monitor.ProjectUtilisationPercent(demand), 29.8F, 0.01F), "projected demand");
+  Expect(monitor.CheckDemand(demand) && log.demand == 0, "demand fits");
+
+  demand.devices = 8;
+  demand.frame_hz = 200.0F;
+  Expect(!monitor.CheckDemand(demand) && log.demand == 1 && log.last > 100.0F,
+         "over-capacity demand warned");
+
+  const float max_hz = monitor.MaxFrameRateHz(8, 16);
+  demand.frame_hz = max_hz;
+  Expect(near(monitor.ProjectUtilisationPercent(demand), cfg.warn_percent, 0.01F),
+         "max frame rate sits on the threshold");
+}
+
+} // namespace
+
+int main() {
+  testTransferClocks();
+  testMatchesSimulator();
+  testWindowsAndPeak();
+  testProjection();
+  return Finish("bus monitor");
+}
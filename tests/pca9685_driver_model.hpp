@@ -0,0 +1,341 @@
+/**
+ * @file pca9685_driver_model.hpp
+ * @brief Reference model and operation decoder shared by the property test and fuzz target
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Each input byte sequence is decoded into driver API calls (channel writes, frames,
+ * sleep/wake, frequency, output configuration, injected bus failures, passing time) that
+ * run against PCA9685Simulator. After every call the simulator's register file is compared
+ * with a reference model that applies each call's documented effect on success, and the
+ * driver's own Verify() must agree with the device.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "pca9685.hpp"
+#include "pca9685_fault_injector.hpp"
+#include "pca9685_simulator.hpp"
+
+namespace pca9685_test {
+
+/** @brief Simulator behind a fault injector (scripted failures only). */
+using FaultyBus = pca9685::FaultInjectingBus<pca9685::PCA9685Simulator>;
+
+/**
+ * @brief Sequential reader over fuzz/property input; yields zeros once exhausted.
+ */
+class InputReader {
+public:
+  InputReader(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  [[nodiscard]] bool Empty() const noexcept {
+    return pos_ >= size_;
+  }
+  uint8_t Byte() noexcept {
+    return pos_ < size_ ? data_[pos_++] : 0;
+  }
+  uint16_t Word() noexcept {
+    const uint16_t low = Byte();
+    return static_cast<uint16_t>(low | (Byte() << 8));
+  }
+
+private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_{0};
+};
+
+/**
+ * @class DriverModel
+ * @brief Driver + simulator + reference model; Step() runs one decoded call and checks it.
+ */
+class DriverModel {
+public:
+  using Driver = pca9685::PCA9685<FaultyBus>;
+
+  static constexpr uint8_t ADDRESS_ = 0x40;
+  static constexpr uint16_t FULL_ = 0x1000;
+
+  /** @brief Counters for the end-of-run summary. */
+  struct Stats {
+    uint32_t calls{0};
+    uint32_t rejected{0};      ///< Calls refused for invalid parameters
+    uint32_t failed{0};        ///< Valid calls that failed under injected faults
+    uint32_t fault_windows{0}; ///< Calls run with faults pending
+  };
+
+  DriverModel() noexcept : bus_(sim_), driver_(&bus_, ADDRESS_) {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+      setChannel(image_, ch, 0, FULL_); // Power-on default: full-off
+    }
+    frame_ = image_;
+    ok_ = driver_.EnsureInitialized();
+    mode1_ = 0x20; // Reset(): auto-increment, awake
+    check("initialisation");
+  }
+
+  /**
+   * @brief Decode and run one call from @p in, then check every property.
+   * @return false once a property has been violated (see GetFailure()).
+   */
+  bool Step(InputReader& in) noexcept {
+    if (!ok_) {
+      return false;
+    }
+    const uint32_t faults = bus_.GetPendingFailures() + (bus_.IsStuck() ? 1U : 0U);
+    if (faults > 0) {
+      ++stats_.fault_windows;
+    }
+    ++stats_.calls;
+    const uint8_t op = in.Byte() % 17;
+    switch (op) {
+    case 0: {
+      const uint8_t ch = channelArg(in);
+      const uint16_t on = tickArg(in);
+      const uint16_t off = tickArg(in);
+      writeCall("SetPwm", driver_.SetPwm(ch, on, off), ch < 16 && on <= 4095 && off <= 4095,
+                faults, [&] { directWrite(ch, on, off); });
+      break;
+    }
+    case 1: {
+      const uint8_t ch = channelArg(in);
+      const float duty = (static_cast<float>(in.Byte()) / 200.0F) - 0.1F;
+      const auto ticks = static_cast<uint16_t>(lroundf(std::clamp(duty, 0.0F, 1.0F) * 4095));
+      writeCall("SetDuty", driver_.SetDuty(ch, duty), ch < 16, faults,
+                [&] { directWrite(ch, 0, ticks); });
+      break;
+    }
+    case 2: {
+      const uint16_t on = tickArg(in);
+      const uint16_t off = tickArg(in);
+      writeCall("SetAllPwm", driver_.SetAllPwm(on, off), on <= 4095 && off <= 4095, faults, [&] {
+        for (uint8_t ch = 0; ch < 16; ++ch) {
+          directWrite(ch, on, off);
+        }
+      });
+      break;
+    }
+    case 3: {
+      const uint8_t ch = channelArg(in);
+      writeCall("SetChannelFullOn", driver_.SetChannelFullOn(ch), ch < 16, faults,
+                [&] { directWrite(ch, FULL_, 0); });
+      break;
+    }
+    case 4: {
+      const uint8_t ch = channelArg(in);
+      writeCall("SetChannelFullOff", driver_.SetChannelFullOff(ch), ch < 16, faults,
+                [&] { directWrite(ch, 0, FULL_); });
+      break;
+    }
+    case 5: {
+      const uint8_t ch = channelArg(in);
+      const uint16_t ticks = static_cast<uint16_t>(in.Word() % 4200);
+      writeCall("StageDutyTicks", driver_.StageDutyTicks(ch, ticks), ch < 16 && ticks <= 4096,
+                0, [&] {
+                  if (ticks >= 4096) {
+                    setChannel(frame_, ch, FULL_, 0);
+                  } else {
+                    setChannel(frame_, ch, 0, ticks == 0 ? FULL_ : ticks);
+                  }
+                });
+      break;
+    }
+    case 6: {
+      const uint8_t ch = channelArg(in);
+      const uint16_t on = tickArg(in);
+      const uint16_t off = tickArg(in);
+      writeCall("StagePwm", driver_.StagePwm(ch, on, off), ch < 16 && on <= 4095 && off <= 4095,
+                0, [&] { setChannel(frame_, ch, on, off); });
+      break;
+    }
+    case 7:
+      writeCall("CommitFrame", driver_.CommitFrame(), true, faults, [&] { image_ = frame_; });
+      break;
+    case 8:
+      driver_.DiscardFrame();
+      frame_ = image_;
+      break;
+    case 9:
+      writeCall("Sleep", driver_.Sleep(), true, faults, [&] { mode1_ |= 0x10; });
+      break;
+    case 10:
+      writeCall("Wake", driver_.Wake(), true, faults,
+                 [&] { mode1_ &= static_cast<uint8_t>(~0x10U); });
+      break;
+    case 11: {
+      const float freq = 20.0F + (static_cast<float>(in.Byte()) * 6.0F);
+      writeCall("SetPwmFreq", driver_.SetPwmFreq(freq), freq >= 24.0F && freq <= 1526.0F,
+                 faults, [&] {
+                   const float value = std::clamp((25000000.0F / (4096.0F * freq)) - 1.0F, 3.0F,
+                                                  255.0F);
+                   prescale_ = static_cast<uint8_t>(lroundf(value));
+                 });
+      break;
+    }
+    case 12: {
+      const bool invert = (in.Byte() & 1U) != 0;
+      writeCall("SetOutputInvert", driver_.SetOutputInvert(invert), true, faults, [&] {
+        mode2_ = static_cast<uint8_t>((mode2_ & ~0x10U) | (invert ? 0x10U : 0U));
+      });
+      break;
+    }
+    case 13: {
+      const bool totem_pole = (in.Byte() & 1U) != 0;
+      writeCall("SetOutputDriverMode", driver_.SetOutputDriverMode(totem_pole), true, faults,
+                 [&] {
+                   mode2_ = static_cast<uint8_t>((mode2_ & ~0x04U) | (totem_pole ? 0x04U : 0U));
+                 });
+      break;
+    }
+    case 14: {
+      // Faults apply to the next call only
+      const uint8_t arg = in.Byte();
+      bus_.FailNext(arg % 6, static_cast<pca9685::BusFault>(1 + ((arg / 6) % 3)));
+      return ok_;
+    }
+    case 15:
+      sim_.AdvanceUs(static_cast<uint64_t>(in.Byte()) * 20U);
+      break;
+    case 16:
+      writeCall("RestoreState", driver_.RestoreState(), true, faults, [] {});
+      break;
+    default:
+      break;
+    }
+    bus_.FailNext(0);
+    bus_.ClearStuckBus();
+    if (faults != 0) {
+      resyncConfig();
+    }
+    check(NAMES_[op]);
+    return ok_;
+  }
+
+  [[nodiscard]] const char* GetFailure() const noexcept {
+    return failure_;
+  }
+  [[nodiscard]] const Stats& GetStats() const noexcept {
+    return stats_;
+  }
+  [[nodiscard]] const FaultyBus& GetBus() const noexcept {
+    return bus_;
+  }
+
+private:
+  static constexpr const char* NAMES_[] = {
+      "SetPwm",          "SetDuty",         "SetAllPwm",           "SetChannelFullOn",
+      "SetChannelFullOff", "StageDutyTicks", "StagePwm",           "CommitFrame",
+      "DiscardFrame",    "Sleep",           "Wake",                "SetPwmFreq",
+      "SetOutputInvert", "SetOutputDriverMode", "InjectFaults",    "AdvanceTime",
+      "RestoreState"};
+
+  pca9685::PCA9685Simulator sim_;
+  FaultyBus bus_;
+  Driver driver_;
+  std::array<uint8_t, 64> image_{}; ///< Expected LEDn registers
+  std::array<uint8_t, 64> frame_{}; ///< Expected pending frame
+  uint8_t mode1_{0};
+  uint8_t mode2_{0x04};
+  uint8_t prescale_{0x1E};
+  bool ok_{true};
+  char failure_[160]{};
+  Stats stats_{};
+
+  static uint8_t channelArg(InputReader& in) noexcept {
+    return static_cast<uint8_t>(in.Byte() % 18); // 16, 17 are invalid
+  }
+  static uint16_t tickArg(InputReader& in) noexcept {
+    return static_cast<uint16_t>(in.Word() % 4200); // > 4095 is invalid
+  }
+
+  static void setChannel(std::array<uint8_t, 64>& image, uint8_t ch, uint16_t on,
+                         uint16_t off) noexcept {
+    image[(4 * ch) + 0] = static_cast<uint8_t>(on & 0xFF);
+    image[(4 * ch) + 1] = static_cast<uint8_t>((on >> 8) & 0x1F);
+    image[(4 * ch) + 2] = static_cast<uint8_t>(off & 0xFF);
+    image[(4 * ch) + 3] = static_cast<uint8_t>((off >> 8) & 0x1F);
+  }
+
+  /** @brief A direct write lands on the device and supersedes anything staged. */
+  void directWrite(uint8_t ch, uint16_t on, uint16_t off) noexcept {
+    setChannel(image_, ch, on, off);
+    setChannel(frame_, ch, on, off);
+  }
+
+  void fail(const char* call, const char* what) noexcept {
+    if (ok_) {
+      (void)std::snprintf(failure_, sizeof(failure_), "after call %u (%s): %s", stats_.calls,
+                          call, what);
+      ok_ = false;
+    }
+  }
+
+  /**
+   * @brief Channel writes are one transaction: on failure nothing may have changed.
+   */
+  template <typename Apply>
+  void writeCall(const char* name, bool result, bool valid, uint32_t faults,
+                 Apply&& apply) noexcept {
+    if (!valid) {
+      ++stats_.rejected;
+      if (result) {
+        fail(name, "invalid parameters accepted");
+      }
+      return;
+    }
+    if (result) {
+      apply();
+    } else if (faults == 0) {
+      fail(name, "valid call failed without a bus fault");
+    } else {
+      ++stats_.failed;
+    }
+  }
+
+  /**
+   * @brief Configuration sequences span several transactions and a failed transfer makes
+   *        the next call run the driver's VerifyAndRestore(), so after any call that ran with
+   *        faults pending the mode registers are indeterminate: take them from the device.
+   */
+  void resyncConfig() noexcept {
+    mode1_ = static_cast<uint8_t>(sim_.GetRegister(0x00) & 0x7F);
+    mode2_ = sim_.GetRegister(0x01);
+    prescale_ = sim_.GetRegister(0xFE);
+  }
+
+  void check(const char* call) noexcept {
+    if (!ok_) {
+      fail(call, "call failed");
+      return;
+    }
+    for (uint8_t i = 0; i < 64; ++i) {
+      if (sim_.GetRegister(static_cast<uint8_t>(0x06 + i)) != image_[i]) {
+        char what[64];
+        (void)std::snprintf(what, sizeof(what), "LED register 0x%02X is 0x%02X, model 0x%02X",
+                            0x06 + i, sim_.GetRegister(static_cast<uint8_t>(0x06 + i)),
+                            image_[i]);
+        fail(call, what);
+        return;
+      }
+    }
+    // RESTART (bit 7) is device-controlled
+    if ((sim_.GetRegister(0x00) & 0x7F) != mode1_) {
+      fail(call, "MODE1 differs from the model");
+    } else if (sim_.GetRegister(0x01) != mode2_) {
+      fail(call, "MODE2 differs from the model");
+    } else if (sim_.GetRegister(0xFE) != prescale_) {
+      fail(call, "PRE_SCALE differs from the model");
+    }
+    uint16_t mismatch = 0;
+    if (ok_ && (!driver_.Verify(mismatch) || mismatch != 0)) {
+      fail(call, "driver shadow image disagrees with the device");
+    }
+  }
+};
+
+} // namespace pca9685_test
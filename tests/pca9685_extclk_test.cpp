@@ -0,0 +1,131 @@
+/**
+ * @file pca9685_extclk_test.cpp
+ * @brief Host tests of the EXTCLK switch sequence and clock-aware frequency math
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * The simulator counts EXTCLK or PRE_SCALE writes made while awake as timing violations and
+ * derives the PWM period from its own clock, so both the register sequence and the prescale
+ * math are checked against the modelled device.
+ */
+#include <cstdint>
+#include <cstdlib>
+
+#include "pca9685.hpp"
+#include "pca9685_fault_injector.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+
+constexpr uint8_t MODE1 = 0x00;
+constexpr uint8_t PRE_SCALE = 0xFE;
+
+void testExternalClock() {
+  Sim sim;
+  sim.SetExternalClockHz(50000000);
+  Driver pwm(&sim, 0x40);
+  Expect(pwm.EnsureInitialized() && pwm.EnableExternalClock(50000000), "enable EXTCLK");
+  Expect((sim.GetRegister(MODE1) & 0x40) != 0 && sim.GetClockHz() == 50000000,
+         "device runs from EXTCLK");
+  Expect((sim.GetRegister(MODE1) & 0x10) == 0, "previous (awake) state restored");
+  Expect(pwm.IsExternalClock() && pwm.GetOscillatorHz() == 50000000, "driver clock updated");
+
+  // Range scales with the clock: 48-3052 Hz at 50 MHz
+  Expect(pwm.SetPwmFreq(3000.0F) && sim.GetRegister(PRE_SCALE) == 3 &&
+             sim.GetPeriodNs() == 327680,
+         "3 kHz from a 50 MHz clock");
+  Expect(pwm.SetPwmFreq(1000.0F) && sim.GetRegister(PRE_SCALE) == 11, "1 kHz prescale");
+  Expect(!pwm.SetPwmFreq(3100.0F) && pwm.HasError(Driver::Error::OutOfRange), "above range");
+  Expect(!pwm.SetPwmFreq(40.0F), "below range");
+
+  // Reset() rewrites MODE1 but EXTCLK is sticky: the cache must agree with the device
+  const uint32_t restores = pwm.GetRestoreCount();
+  Expect(pwm.Reset() && pwm.VerifyAndRestore() && pwm.GetRestoreCount() == restores,
+         "no restore after Reset()");
+
+  // Power loss drops EXTCLK; the restore sequence brings it back
+  sim.PowerCycle();
+  Expect(pwm.VerifyAndRestore() && pwm.GetRestoreCount() == restores + 1, "restore ran");
+  Expect((sim.GetRegister(MODE1) & 0x40) != 0 && sim.GetRegister(PRE_SCALE) == 11,
+         "EXTCLK and prescale restored");
+  Expect(sim.GetTimingViolations() == 0, "no EXTCLK/PRE_SCALE writes while awake");
+
+  Expect(!pwm.EnableExternalClock(60000000) && pwm.GetOscillatorHz() == 50000000,
+         "clock above 50 MHz rejected");
+}
+
+/** @brief Failed writes in the EXTCLK sequence leave the driver matching the device. */
+void testExternalClockFailures() {
+  using FaultyBus = pca9685::FaultInjectingBus<Sim>;
+  using FaultyDriver = pca9685::PCA9685<FaultyBus>;
+  for (uint32_t failing = 3; failing <= 4; ++failing) {
+    Sim sim;
+    sim.SetExternalClockHz(50000000);
+    FaultyBus bus(sim);
+    FaultyDriver pwm(&bus, 0x40);
+    pca9685::RetryPolicy::Config policy;
+    policy.max_retries = 0;
+    pwm.SetRetryPolicy(policy);
+    Expect(pwm.EnsureInitialized(), "init");
+
+    // MODE1 read, SLEEP write, SLEEP|EXTCLK write, wake write: fail the third or the fourth
+    FaultyBus::Config cfg;
+    cfg.every_n = bus.GetStats().transfers + failing;
+    bus.Configure(cfg);
+    Expect(!pwm.EnableExternalClock(50000000), "sequence fails");
+    bus.Configure(FaultyBus::Config{});
+    const bool latched = (sim.GetRegister(MODE1) & 0x40) != 0;
+    if (failing == 3) {
+      Expect(!latched && !pwm.IsExternalClock() && pwm.GetOscillatorHz() == Driver::OSC_FREQ_,
+             "EXTCLK write failed: previous clock kept");
+    } else {
+      Expect(latched && pwm.IsExternalClock() && pwm.GetOscillatorHz() == 50000000 &&
+                 pwm.GetPowerState() == FaultyDriver::PowerState::Asleep,
+             "wake write failed: on EXTCLK, asleep");
+      Expect(pwm.Wake() && (sim.GetRegister(MODE1) & 0x50) == 0x40, "Wake() resumes on EXTCLK");
+    }
+    const uint32_t restores = pwm.GetRestoreCount();
+    Expect(pwm.VerifyAndRestore() && pwm.GetRestoreCount() == restores, "cache matches device");
+    Expect(sim.GetTimingViolations() == 0, "no timing violations");
+  }
+}
+
+/** @brief A measured internal oscillator frequency brings the period closer to the target. */
+void testCalibratedOscillator() {
+  constexpr uint32_t ACTUAL_HZ = 26200000; // 4.8 % fast
+  constexpr int64_t TARGET_NS = 5000000;   // 200 Hz
+  int64_t error_ns[2] = {};
+  for (int calibrated = 0; calibrated < 2; ++calibrated) {
+    Sim sim;
+    sim.SetInternalOscillatorHz(ACTUAL_HZ);
+    Driver pwm(&sim, 0x40);
+    if (calibrated != 0) {
+      pwm.SetOscillatorHz(ACTUAL_HZ);
+    }
+    Expect(pwm.SetPwmFreq(200.0F), "set 200 Hz");
+    error_ns[calibrated] = std::llabs(static_cast<int64_t>(sim.GetPeriodNs()) - TARGET_NS);
+  }
+  Expect(error_ns[1] < error_ns[0] && error_ns[1] < 20000, "calibration reduces period error");
+
+  Driver pwm(nullptr, 0x40);
+  pwm.SetOscillatorHz(0);
+  Expect(pwm.GetOscillatorHz() == Driver::OSC_FREQ_ && !pwm.IsExternalClock(),
+         "invalid calibration ignored");
+  Expect(pwm.GetMinPwmFreq() == 24.0F && pwm.GetMaxPwmFreq() == 1526.0F,
+         "internal oscillator keeps the 24-1526 Hz range");
+}
+
+} // namespace
+
+int main() {
+  testExternalClock();
+  testExternalClockFailures();
+  testCalibratedOscillator();
+  return Finish("extclk");
+}
@@ -0,0 +1,254 @@
+/**
+ * @file pca9685_fault_injection_test.cpp
+ * @brief Host tests of FaultInjectingBus and a degraded-bus retry benchmark
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Checks the injector's scripted, pattern, burst, stuck-bus and random faults, then drives
+ * the driver through it on a virtual clock and prints, per fault rate and retry count, the
+ * share of SetPwm calls that succeed, their p50/p99 latency and the resulting throughput.
+ */
+#include <cstdint>
+#include <cstdio>
+
+#include "pca9685.hpp"
+#include "pca9685_fault_injector.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+using FaultyBus = pca9685::FaultInjectingBus<Sim>;
+
+uint32_t g_now_us = 0;
+uint32_t NowUs() {
+  return g_now_us;
+}
+void SpendUs(uint32_t us) {
+  g_now_us += us;
+}
+
+bool writeLed0(FaultyBus& bus, uint8_t value) {
+  return bus.Write(0x40, 0x06, &value, 1);
+}
+
+void testScripted() {
+  Sim sim;
+  FaultyBus bus(sim);
+  bus.FailNext(2);
+  Expect(!writeLed0(bus, 0x11) && !writeLed0(bus, 0x22), "scripted NACKs fail");
+  Expect(sim.GetRegister(0x06) == 0x00, "failed transfer does not reach the device");
+  Expect(writeLed0(bus, 0x33) && sim.GetRegister(0x06) == 0x33, "transfer after script passes");
+  Expect(bus.GetStats().nacks == 2 && bus.GetStats().passed == 1, "scripted counters");
+
+  bus.FailNext(1, pca9685::BusFault::Timeout);
+  const uint64_t charged = bus.GetStats().charged_us;
+  Expect(!writeLed0(bus, 0x44), "scripted timeout fails");
+  Expect(bus.GetStats().charged_us - charged == bus.GetConfig().timeout_us, "timeout charged");
+}
+
+void testPatternAndBurst() {
+  Sim sim;
+  FaultyBus bus(sim);
+  FaultyBus::Config cfg;
+  cfg.every_n = 4;
+  bus.Configure(cfg);
+  uint32_t failed_mask = 0;
+  for (uint32_t i = 1; i <= 12; ++i) {
+    failed_mask |= writeLed0(bus, 0) ? 0U : (1U << i);
+  }
+  Expect(failed_mask == ((1U << 4) | (1U << 8) | (1U << 12)), "every_n pattern");
+
+  FaultyBus burst_bus(sim);
+  cfg.every_n = 10;
+  cfg.burst_length = 3;
+  burst_bus.Configure(cfg);
+  failed_mask = 0;
+  for (uint32_t i = 1; i <= 15; ++i) {
+    failed_mask |= writeLed0(burst_bus, 0) ? 0U : (1U << i);
+  }
+  Expect(failed_mask == ((1U << 10) | (1U << 11) | (1U << 12)), "burst after pattern fault");
+}
+
+void testStuckBus() {
+  Sim sim;
+  FaultyBus bus(sim);
+  FaultyBus::Config cfg;
+  cfg.stuck_transfers = 0; // Until cleared
+  cfg.every_n = 3;
+  cfg.every_n_fault = pca9685::BusFault::StuckBus;
+  bus.Configure(cfg);
+  Expect(writeLed0(bus, 1) && writeLed0(bus, 2), "transfers before the bus sticks pass");
+  for (int i = 0; i < 20; ++i) {
+    (void)writeLed0(bus, 3);
+  }
+  Expect(bus.IsStuck() && bus.GetStats().stuck_failures == 20, "stuck until cleared");
+  Expect(bus.GetStats().stuck_events == 1, "one stuck event");
+  bus.ClearStuckBus();
+  bus.Configure(FaultyBus::Config{});
+  Expect(writeLed0(bus, 4) && sim.GetRegister(0x06) == 4, "bus usable after clearing");
+
+  bus.FailNext(5, pca9685::BusFault::StuckBus);
+  int failed = 0;
+  for (int i = 0; i < 8; ++i) {
+    failed += writeLed0(bus, 5) ? 0 : 1;
+  }
+  Expect(failed == 5 && !bus.IsStuck(), "scripted stuck bus lasts its count");
+}
+
+void testRandomRate() {
+  Sim sim;
+  FaultyBus bus(sim);
+  FaultyBus::Config cfg;
+  cfg.nack_ppm = 50000;    // 5 %
+  cfg.timeout_ppm = 10000; // 1 %
+  bus.Configure(cfg);
+  bus.Seed(1234);
+  constexpr uint32_t TRANSFERS = 100000;
+  for (uint32_t i = 0; i < TRANSFERS; ++i) {
+    (void)writeLed0(bus, 0);
+  }
+  const auto& stats = bus.GetStats();
+  Expect(stats.nacks > 4500 && stats.nacks < 5500, "NACK rate near 5 %");
+  Expect(stats.timeouts > 800 && stats.timeouts < 1200, "timeout rate near 1 %");
+  Expect(stats.passed + bus.GetInjectedCount() == TRANSFERS, "every transfer accounted for");
+}
+
+void testDriverRecovers() {
+  Sim sim;
+  FaultyBus bus(sim);
+  FaultyBus::Config cfg;
+  cfg.nack_ppm = 50000;
+  bus.Configure(cfg);
+  pca9685::PCA9685<FaultyBus> pwm(&bus, 0x40);
+  uint32_t ok = 0;
+  for (uint16_t i = 0; i < 1000; ++i) {
+    ok += pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, i) ? 1U : 0U;
+  }
+  Expect(ok == 1000, "3 retries hide a 5 % NACK rate");
+  Expect(pwm.GetRetryPolicy().GetStats().retries == bus.GetStats().nacks,
+         "one retry per injected NACK");
+  bus.Configure(FaultyBus::Config{});
+  uint16_t mismatch = 0xFFFF;
+  Expect(pwm.Verify(mismatch) && mismatch == 0, "device matches the shadow image");
+}
+
+void testResetClosesBreaker() {
+  Sim sim;
+  FaultyBus bus(sim);
+  pca9685::PCA9685<FaultyBus> pwm(&bus, 0x40);
+  pca9685::RetryPolicy::Config policy;
+  policy.max_retries = 1;
+  policy.frame_retry_budget = 2;
+  pwm.SetRetryPolicy(policy);
+  pca9685::DeviceHealth::Config breaker;
+  breaker.failure_threshold = 2;
+  pwm.SetCircuitBreaker(breaker);
+  Expect(pwm.EnsureInitialized(), "init");
+
+  // No clock: nothing probes the device once the breaker is open
+  bus.FailNext(4);
+  Expect(!pwm.SetPwm(0, 0, 100) && !pwm.SetPwm(0, 0, 100), "writes fail");
+  Expect(pwm.GetHealth().GetState() == pca9685::DeviceHealth::State::Open &&
+             pwm.GetRetryPolicy().GetFrameBudgetRemaining() == 0,
+         "breaker open, retry budget spent");
+  const uint32_t passed = bus.GetStats().passed;
+  Expect(!pwm.SetPwm(0, 0, 100) && bus.GetStats().passed == passed &&
+             pwm.GetLastError() == pca9685::PCA9685<FaultyBus>::Error::DeviceNotFound,
+         "open breaker skips the bus");
+
+  Expect(pwm.Reset() && bus.GetStats().passed == passed + 1, "Reset() reaches the bus");
+  Expect(pwm.GetHealth().GetState() == pca9685::DeviceHealth::State::Closed &&
+             pwm.GetRetryPolicy().GetFrameBudgetRemaining() == 2,
+         "breaker closed, retry budget refilled");
+  Expect(pwm.SetPwm(0, 0, 100) && sim.GetRegister(0x08) == 100, "writes go through again");
+}
+
+void testRestoreRetryWakes() {
+  Sim sim;
+  FaultyBus bus(sim);
+  pca9685::PCA9685<FaultyBus> pwm(&bus, 0x40);
+  pca9685::RetryPolicy::Config policy;
+  policy.max_retries = 0;
+  pwm.SetRetryPolicy(policy);
+  Expect(pwm.EnsureInitialized() && pwm.SetPwmFreq(200.0F) && pwm.SetPwm(0, 0, 2048),
+         "set up");
+
+  // Power loss, then a restore whose LEDn burst fails: MODE1 read, parked MODE1 write,
+  // PRE_SCALE write, then the burst
+  sim.PowerCycle();
+  FaultyBus::Config cfg;
+  cfg.every_n = bus.GetStats().transfers + 4;
+  bus.Configure(cfg);
+  Expect(!pwm.VerifyAndRestore() && bus.GetStats().nacks == 1, "burst fails");
+  Expect((sim.GetRegister(0x00) & 0x10) != 0, "device left parked");
+
+  bus.Configure(FaultyBus::Config{});
+  Expect(pwm.VerifyAndRestore() && pwm.GetRestoreCount() == 1, "second restore runs");
+  Expect((sim.GetRegister(0x00) & 0x10) == 0 && sim.GetRegister(0x08) == 0x00 &&
+             sim.GetRegister(0x09) == 0x08,
+         "device awake with its channels back");
+}
+
+/** @brief Degraded-bus benchmark: 2000 SetPwm calls per (fault rate, retry count) cell. */
+void benchmarkRetries() {
+  static constexpr uint32_t RATES_PPM[] = {0, 10000, 50000, 200000};
+  std::printf("\n%-8s %-7s %9s %8s %8s %10s\n", "NACK", "retries", "success", "p50 us",
+              "p99 us", "calls/s");
+  for (const uint32_t rate : RATES_PPM) {
+    for (uint8_t retries = 0; retries <= 3; ++retries) {
+      Sim sim;
+      FaultyBus bus(sim);
+      FaultyBus::Config cfg;
+      cfg.nack_ppm = rate;
+      cfg.timeout_ppm = rate / 10; // A tenth of the faults are 1 ms timeouts
+      cfg.bus_hz = 400000;
+      bus.Configure(cfg);
+      bus.SetDelayUs(SpendUs);
+      pca9685::PCA9685<FaultyBus> pwm(&bus, 0x40);
+      pwm.SetClock(NowUs);
+      pwm.SetRetryDelayUs(SpendUs);
+      pca9685::RetryPolicy::Config policy;
+      policy.max_retries = retries;
+      policy.base_delay_us = 50;
+      pwm.SetRetryPolicy(policy);
+      (void)pwm.EnsureInitialized();
+      pwm.ResetLatencyHistograms();
+
+      constexpr uint32_t CALLS = 2000;
+      uint32_t ok = 0;
+      const uint32_t start = g_now_us;
+      for (uint32_t i = 0; i < CALLS; ++i) {
+        ok += pwm.SetPwm(static_cast<uint8_t>(i % 16), 0, static_cast<uint16_t>(i & 0xFFF))
+                  ? 1U
+                  : 0U;
+      }
+      const uint32_t elapsed = g_now_us - start;
+      const auto& histogram =
+          pwm.GetLatencyHistogram(pca9685::PCA9685<FaultyBus>::Operation::SetPwm);
+      std::printf("%5.1f %%  %-7u %8.2f%% %8u %8u %10.0f\n", static_cast<double>(rate) / 1e4,
+                  retries, 100.0 * ok / CALLS, histogram.GetPercentileUs(50),
+                  histogram.GetPercentileUs(99), CALLS * 1e6 / (elapsed != 0 ? elapsed : 1));
+      if (rate == 0) {
+        Expect(ok == CALLS, "fault-free bus never fails");
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  testScripted();
+  testPatternAndBurst();
+  testStuckBus();
+  testRandomRate();
+  testDriverRecovers();
+  testResetClosesBreaker();
+  testRestoreRetryWakes();
+  benchmarkRetries();
+  return Finish("fault injection");
+}
@@ -0,0 +1,113 @@
+/**
+ * @file pca9685_freq_switch_test.cpp
+ * @brief Host tests of SetPwmFreqFast() and the deferred RESTART (ServiceRestart())
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Counts the transfers of each switch path and checks that the outputs resume with their
+ * previous values at the new period.
+ */
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::AttachSimClock;
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+using pca9685_test::SimNowUs;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+
+constexpr uint8_t PRE_SCALE = 0xFE;
+
+/** @brief Driver at 50 Hz with a few channels set, outputs running. */
+bool setUp(Sim& sim, Driver& pwm) {
+  AttachSimClock(sim, pwm);
+  bool ok = pwm.EnsureInitialized() && pwm.SetPwmFreq(50.0F);
+  ok &= pwm.SetPwm(0, 0, 2048) && pwm.SetPwm(5, 1000, 3000);
+  sim.AdvanceUs(1000);
+  return ok && sim.IsRunning() && !sim.IsRestartPending();
+}
+
+void testFastSwitch() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm), "set up");
+
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.SetPwmFreqFast(1000.0F), "fast switch");
+  Expect(sim.GetTransactionCount() - before == 3, "three writes, no MODE1 read");
+  Expect(sim.GetRegister(PRE_SCALE) == 5, "1 kHz prescale");
+  Expect(pwm.IsRestartPending() && sim.IsRestartPending(), "outputs wait for RESTART");
+  Expect(pwm.GetRestartDueUs() == SimNowUs() + Driver::OSC_SETTLE_US_, "due after 500 us");
+
+  // Too early: nothing is written
+  sim.AdvanceUs(300);
+  Expect(pwm.ServiceRestart() && pwm.IsRestartPending() &&
+             sim.GetTransactionCount() - before == 3,
+         "no RESTART before the oscillator settles");
+
+  sim.AdvanceUs(200);
+  Expect(pwm.ServiceRestart() && !pwm.IsRestartPending() &&
+             sim.GetTransactionCount() - before == 4,
+         "RESTART once due");
+  Expect(sim.IsRunning() && !sim.IsRestartPending(), "outputs resumed");
+  uint16_t mismatch = 0;
+  Expect(pwm.Verify(mismatch) && mismatch == 0, "channels kept their values");
+  Expect(sim.GetPeriodNs() == 6ULL * 4096ULL * 40ULL, "1 kHz period (prescale 5)");
+
+  // Same prescale: nothing to do
+  const uint32_t settled = sim.GetTransactionCount();
+  Expect(pwm.SetPwmFreqFast(1000.0F) && sim.GetTransactionCount() == settled &&
+             !pwm.IsRestartPending(),
+         "unchanged prescale costs nothing");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+/** @brief SetPwmFreq() for comparison: a read more, and the outputs stay held. */
+void testLegacyPath() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm), "set up");
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.SetPwmFreq(1000.0F), "legacy switch");
+  Expect(sim.GetTransactionCount() - before == 4, "legacy: read + three writes");
+  Expect(sim.IsRestartPending() && !pwm.IsRestartPending(), "legacy leaves outputs held");
+}
+
+void testWhileAsleep() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm) && pwm.Sleep(), "asleep");
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.SetPwmFreqFast(200.0F) && sim.GetTransactionCount() - before == 1 &&
+             sim.GetRegister(PRE_SCALE) == 30 && !pwm.IsRestartPending(),
+         "asleep: PRE_SCALE only, no RESTART scheduled");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+void testWithoutClock() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm), "set up");
+  pwm.SetClock(nullptr);
+  Expect(pwm.SetPwmFreqFast(1000.0F) && pwm.IsRestartPending(), "switch without clock");
+  sim.AdvanceUs(Driver::OSC_SETTLE_US_); // The caller waits
+  Expect(pwm.ServiceRestart() && !pwm.IsRestartPending() && !sim.IsRestartPending(),
+         "RESTART on the first service call");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+} // namespace
+
+int main() {
+  testFastSwitch();
+  testLegacyPath();
+  testWhileAsleep();
+  testWithoutClock();
+  return Finish("freq switch");
+}
@@ -0,0 +1,68 @@
+/**
+ * @file pca9685_fuzz_driver.cpp
+ * @brief libFuzzer target: arbitrary driver call sequences against the register model
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Built with -DHF_PCA9685_BUILD_FUZZERS=ON (Clang) this is a libFuzzer target:
+ *
+ *   ./pca9685_fuzz_driver -max_len=4096 corpus/
+ *
+ * Without libFuzzer the same file builds a replay runner: each argument is an input file
+ * (e.g. a crash reproducer); with no arguments a fixed set of generated inputs is run.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "pca9685_driver_model.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  pca9685_test::DriverModel model;
+  pca9685_test::InputReader reader(data, size);
+  while (!reader.Empty()) {
+    if (!model.Step(reader)) {
+      std::fprintf(stderr, "property violated %s\n", model.GetFailure());
+      std::abort();
+    }
+  }
+  return 0;
+}
+
+#ifndef HF_PCA9685_LIBFUZZER
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) {
+      std::FILE* file = std::fopen(argv[i], "rb");
+      if (file == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", argv[i]);
+        return 1;
+      }
+      std::vector<uint8_t> input;
+      int c = 0;
+      while ((c = std::fgetc(file)) != EOF) {
+        input.push_back(static_cast<uint8_t>(c));
+      }
+      (void)std::fclose(file);
+      std::printf("%s: %zu bytes\n", argv[i], input.size());
+      (void)LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    return 0;
+  }
+  // Generated inputs of varying length, biased towards fault injection and frames
+  std::mt19937 rng(0x9685);
+  for (int i = 0; i < 2000; ++i) {
+    std::vector<uint8_t> input(rng() % 512);
+    for (auto& byte : input) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    (void)LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  (void)LLVMFuzzerTestOneInput(nullptr, 0);
+  std::printf("fuzz replay: 2000 generated inputs\n");
+  return 0;
+}
+#endif
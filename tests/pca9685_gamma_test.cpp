@@ -0,0 +1,87 @@
+/**
+ * @file pca9685_gamma_test.cpp
+ * @brief Host tests of GammaLookup() interpolation on built-in and user-supplied tables
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * User tables need not be monotonic or stay within 0-4096; lookups must still interpolate
+ * in the right direction and return valid duty ticks. Most checks run at compile time.
+ */
+#include <cstdint>
+
+#include "pca9685_gamma.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685::GammaLookup;
+using pca9685::GammaLookup8;
+using pca9685::GammaTable;
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+/** @brief Falls from 4096 to 0 over the first segment, then rises back linearly. */
+constexpr GammaTable makeDipTable() {
+  GammaTable table{};
+  table[0] = 4096;
+  for (size_t i = 1; i < table.size(); ++i) {
+    table[i] = static_cast<uint16_t>(16 * (i - 1));
+  }
+  table[256] = 4096;
+  return table;
+}
+
+/** @brief Falling curve from 6000 (above full scale) to 880. */
+constexpr GammaTable makeFallingTable() {
+  GammaTable table{};
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = static_cast<uint16_t>(6000 - (20 * i));
+  }
+  return table;
+}
+
+constexpr GammaTable DIP = makeDipTable();
+constexpr GammaTable FALLING = makeFallingTable();
+
+// Built-in tables: end points and monotonic interpolation
+static_assert(GammaLookup(pca9685::GAMMA_2_2_TABLE, 0) == 0);
+static_assert(GammaLookup(pca9685::GAMMA_2_2_TABLE, 65535) == 4096);
+static_assert(GammaLookup8(pca9685::GAMMA_CIE1931_TABLE, 255) == 4096);
+
+// A falling segment interpolates downwards instead of wrapping
+static_assert(GammaLookup(DIP, 0) == 4096);
+static_assert(GammaLookup(DIP, 128) == 2048); // Halfway through the first segment
+static_assert(GammaLookup(DIP, 255) == 16);
+static_assert(GammaLookup(DIP, 256) == 0);
+
+// Entries above full scale are clamped to 4096
+static_assert(GammaLookup(FALLING, 0) == 4096);
+static_assert(GammaLookup(FALLING, 65535) == 880);
+
+void testMonotonicBetweenEntries() {
+  bool rising = true;
+  uint16_t previous = 0;
+  for (uint32_t level = 0; level <= 65535; ++level) {
+    const uint16_t ticks = GammaLookup(pca9685::GAMMA_CIE1931_TABLE, static_cast<uint16_t>(level));
+    rising &= ticks >= previous;
+    previous = ticks;
+  }
+  Expect(rising, "CIE 1931 lookups never decrease");
+
+  bool falling = true;
+  bool in_range = true;
+  previous = 4096;
+  for (uint32_t level = 0; level <= 65535; ++level) {
+    const uint16_t ticks = GammaLookup(FALLING, static_cast<uint16_t>(level));
+    falling &= ticks <= previous;
+    in_range &= ticks <= 4096;
+    previous = ticks;
+  }
+  Expect(falling && in_range, "falling table: decreasing, within 0-4096");
+}
+
+} // namespace
+
+int main() {
+  testMonotonicBetweenEntries();
+  return Finish("gamma");
+}
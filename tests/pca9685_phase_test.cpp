@@ -0,0 +1,88 @@
+/**
+ * @file pca9685_phase_test.cpp
+ * @brief Host tests of phase-staggered duty writes (PhaseMode::Even and LoadBalanced)
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Checks the ON edges the driver places for direct SetDuty() writes and for staged frames,
+ * read back from the simulator's register file.
+ */
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+using pca9685_test::OffTicks;
+using pca9685_test::OnTicks;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+using PhaseMode = Driver::PhaseMode;
+
+/** @brief High time of a channel in ticks (0-4095) from its ON and OFF edges. */
+uint16_t highTicks(const Sim& sim, uint8_t channel) {
+  return static_cast<uint16_t>((OffTicks(sim, channel) - OnTicks(sim, channel)) & 0x0FFF);
+}
+
+void testLoadBalancedSetDuty() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  pwm.SetPhaseMode(PhaseMode::LoadBalanced);
+  bool ok = true;
+  for (uint8_t ch = 0; ch < 4; ++ch) {
+    ok &= pwm.SetDuty(ch, 0.25F);
+  }
+  Expect(ok, "direct duty writes");
+  Expect(OnTicks(sim, 0) == 0 && OnTicks(sim, 1) == 1024 && OnTicks(sim, 2) == 2048 &&
+             OnTicks(sim, 3) == 3072,
+         "SetDuty() channels laid end to end");
+  Expect(highTicks(sim, 3) == 1024, "duty unchanged by the offset");
+
+  // A staged channel goes after the direct ones
+  Expect(pwm.StageDutyTicks(4, 500) && pwm.CommitFrame() && OnTicks(sim, 4) == 0 &&
+             OffTicks(sim, 4) == 500,
+         "staged channel after the direct duties (wrapping)");
+
+  // A longer duty on channel 0 moves the channels after it at the next commit
+  Expect(pwm.SetDuty(0, 0.5F) && pwm.CommitFrame(), "duty change");
+  Expect(OnTicks(sim, 1) == 2048 && OnTicks(sim, 2) == 3072 && OnTicks(sim, 3) == 0 &&
+             highTicks(sim, 2) == 1024,
+         "later channels moved, duties kept");
+
+  // Zero duty and raw writes take no slot
+  Expect(pwm.SetDuty(1, 0.0F) && pwm.SetPwm(2, 100, 200) && pwm.SetDuty(5, 0.1F),
+         "mixed writes");
+  Expect(OnTicks(sim, 5) == (2048 + 1024 + 500) % 4096, "only duty channels take a slot");
+
+  // Discarding a staged duty restores the written layout
+  Expect(pwm.StageDutyTicks(3, 2000), "stage");
+  pwm.DiscardFrame();
+  Expect(pwm.SetDuty(5, 0.1F) && OnTicks(sim, 5) == (2048 + 1024 + 500) % 4096,
+         "discarded duty takes no slot");
+  uint16_t mismatch = 0;
+  Expect(pwm.Verify(mismatch) && mismatch == 0, "shadow image matches");
+}
+
+void testEvenSetDuty() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  pwm.SetPhaseMode(PhaseMode::Even, 100);
+  Expect(pwm.SetDuty(0, 0.5F) && pwm.SetDuty(3, 0.5F) && pwm.SetDuty(15, 0.5F), "writes");
+  Expect(OnTicks(sim, 0) == 100 && OnTicks(sim, 3) == 100 + (3 * 256) &&
+             OnTicks(sim, 15) == (100 + (15 * 256)) % 4096,
+         "fixed per-channel offsets");
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.CommitFrame() && sim.GetTransactionCount() == before, "commit rewrites nothing");
+}
+
+} // namespace
+
+int main() {
+  testLoadBalancedSetDuty();
+  testEvenSetDuty();
+  return Finish("phase");
+}
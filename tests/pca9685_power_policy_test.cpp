@@ -0,0 +1,147 @@
+/**
+ * @file pca9685_power_policy_test.cpp
+ * @brief Host tests of the idle-sleep power policy: idle detection, sleep, wake on write
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * The simulator holds channels that were running when sleep was entered until RESTART, so
+ * outputs that run again without one show that the device only slept with every channel off.
+ */
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::AttachSimClock;
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+using pca9685_test::OffTicks;
+using pca9685_test::SimNowUs;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+using PowerState = Driver::PowerState;
+
+constexpr uint8_t MODE1 = 0x00;
+constexpr uint8_t SLEEP = 0x10;
+constexpr uint32_t TIMEOUT_US = 10000;
+
+bool deviceAsleep(const Sim& sim) {
+  return (sim.GetRegister(MODE1) & SLEEP) != 0;
+}
+
+/** @brief Awake driver with the policy enabled and channel 0 running. */
+bool setUp(Sim& sim, Driver& pwm) {
+  AttachSimClock(sim, pwm);
+  pca9685::PowerPolicy::Config cfg;
+  cfg.idle_timeout_us = TIMEOUT_US;
+  pwm.SetPowerPolicy(cfg);
+  const bool ok = pwm.EnsureInitialized() && pwm.SetPwm(0, 0, 2048);
+  sim.AdvanceUs(1000);
+  return ok && sim.IsRunning() && !pwm.GetPowerPolicy().IsIdle();
+}
+
+/** @brief Turn every channel off, then sleep once the timeout has passed. */
+bool sleepIdle(Sim& sim, Driver& pwm) {
+  bool ok = pwm.SetChannelFullOff(0) && pwm.GetPowerPolicy().IsIdle();
+  sim.AdvanceUs(TIMEOUT_US);
+  ok &= pwm.ServicePowerPolicy();
+  return ok && deviceAsleep(sim) && pwm.GetPowerPolicy().IsAsleep();
+}
+
+void testIdleSleepAndWake() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm), "set up");
+
+  // Running channels keep the device awake
+  sim.AdvanceUs(2 * TIMEOUT_US);
+  uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.ServicePowerPolicy() && sim.GetTransactionCount() == before && !deviceAsleep(sim),
+         "active device stays awake");
+
+  // Idle, but not for long enough yet
+  Expect(pwm.SetDuty(0, 0.0F) && pwm.GetPowerPolicy().IsIdle(), "zero duty counts as idle");
+  sim.AdvanceUs(TIMEOUT_US / 2);
+  before = sim.GetTransactionCount();
+  Expect(pwm.ServicePowerPolicy() && sim.GetTransactionCount() == before, "timeout not reached");
+
+  sim.AdvanceUs(TIMEOUT_US / 2);
+  Expect(pwm.ServicePowerPolicy() && sim.GetTransactionCount() - before == 2, "MODE1 read + write");
+  Expect(deviceAsleep(sim) && pwm.GetPowerState() == PowerState::Asleep, "asleep");
+  Expect(pwm.GetPowerPolicy().GetSleepCount() == 1, "one sleep");
+  const uint32_t slept_at = SimNowUs();
+
+  // Writes that keep the channels off go straight to the sleeping device
+  before = sim.GetTransactionCount();
+  Expect(pwm.SetChannelFullOff(3) && pwm.SetAllPwm(0, 0) && deviceAsleep(sim) &&
+             sim.GetTransactionCount() - before == 2,
+         "off writes do not wake");
+
+  // The first channel that turns on wakes the device
+  sim.AdvanceUs(50000);
+  before = sim.GetTransactionCount();
+  Expect(pwm.SetPwm(4, 0, 1000) && sim.GetTransactionCount() - before == 2,
+         "MODE1 write + channel write");
+  Expect(!deviceAsleep(sim) && pwm.GetPowerState() == PowerState::Awake &&
+             !pwm.GetPowerPolicy().IsAsleep() && !pwm.GetPowerPolicy().IsIdle(),
+         "awake");
+  sim.AdvanceUs(1000);
+  Expect(sim.IsRunning() && !sim.IsRestartPending() && OffTicks(sim, 4) == 1000,
+         "outputs run without RESTART");
+  Expect(pwm.GetPowerPolicy().GetWakeCount() == 1, "one wake");
+  const uint64_t asleep = pwm.GetPowerPolicy().GetAsleepUs(SimNowUs());
+  Expect(asleep >= 50000 && asleep <= SimNowUs() - slept_at, "time asleep accounted");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+void testFrameCommitWakes() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm) && sleepIdle(sim, pwm), "asleep");
+  Expect(pwm.StageDutyTicks(2, 0) && pwm.CommitFrame() && deviceAsleep(sim),
+         "idle frame keeps sleeping");
+  Expect(pwm.StageDutyTicks(9, 3000) && pwm.CommitFrame() && !deviceAsleep(sim),
+         "frame with a running channel wakes");
+  sim.AdvanceUs(1000);
+  Expect(sim.IsRunning() && OffTicks(sim, 9) == 3000, "frame on the device");
+
+  // The idle timer restarts: another full timeout before the next sleep
+  Expect(pwm.SetChannelFullOff(9) && pwm.GetPowerPolicy().IsIdle(), "idle again");
+  sim.AdvanceUs(TIMEOUT_US - 100);
+  Expect(pwm.ServicePowerPolicy() && !deviceAsleep(sim), "new idle period not over");
+  sim.AdvanceUs(100);
+  Expect(pwm.ServicePowerPolicy() && deviceAsleep(sim), "asleep again");
+  Expect(pwm.SetAllPwm(0, 2000) && !deviceAsleep(sim), "SetAllPwm wakes");
+  Expect(pwm.GetPowerPolicy().GetSleepCount() == 2 && pwm.GetPowerPolicy().GetWakeCount() == 2,
+         "two sleeps, two wakes");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+void testManualSleepAndDisabled() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUp(sim, pwm) && pwm.SetChannelFullOff(0) && pwm.Sleep(), "slept by the application");
+  Expect(pwm.SetPwm(1, 0, 500) && deviceAsleep(sim) && !pwm.GetPowerPolicy().IsAsleep(),
+         "application sleep is not undone by a write");
+  Expect(pwm.Wake() && pwm.GetPowerPolicy().GetWakeCount() == 0, "not counted as a policy wake");
+
+  // Disabling the policy stops automatic sleep
+  Expect(pwm.SetChannelFullOff(1), "idle");
+  pwm.SetPowerPolicy(pca9685::PowerPolicy::Config{});
+  sim.AdvanceUs(10 * TIMEOUT_US);
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.ServicePowerPolicy() && sim.GetTransactionCount() == before && !deviceAsleep(sim),
+         "disabled policy never sleeps");
+}
+
+} // namespace
+
+int main() {
+  testIdleSleepAndWake();
+  testFrameCommitWakes();
+  testManualSleepAndDisabled();
+  return Finish("power policy");
+}
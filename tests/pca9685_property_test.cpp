@@ -0,0 +1,186 @@
+/**
+ * @file pca9685_property_test.cpp
+ * @brief Host property-based tests of the PCA9685 driver against PCA9685Simulator
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Two properties, each over many seeded random cases:
+ *  - Register model: random sequences of driver calls with injected bus failures leave the
+ *    simulated register file equal to the reference model (pca9685_driver_model.hpp).
+ *  - Waveform: for random (ON, OFF) register values the simulated LEDn pin is high for
+ *    exactly the time the datasheet encoding specifies.
+ *
+ * A failure prints the seed so the case can be replayed with `pca9685_property_test <seed>`.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "pca9685_driver_model.hpp"
+
+namespace {
+
+constexpr uint32_t REGISTER_SEEDS = 400;
+constexpr size_t REGISTER_INPUT_BYTES = 2048;
+constexpr uint32_t WAVEFORM_SEEDS = 200;
+
+/** @brief Driver bus that writes straight into the simulator. */
+class SimBus : public pca9685::I2cInterface<SimBus> {
+public:
+  explicit SimBus(pca9685::PCA9685Simulator& sim) noexcept : sim_(sim) {}
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    return sim_.Write(addr, reg, data, len);
+  }
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    return sim_.Read(addr, reg, data, len);
+  }
+  bool EnsureInitialized() noexcept {
+    return true;
+  }
+
+private:
+  pca9685::PCA9685Simulator& sim_;
+};
+
+bool runRegisterModel(uint32_t seed, pca9685_test::DriverModel::Stats& total) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> input(REGISTER_INPUT_BYTES);
+  for (auto& byte : input) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  pca9685_test::DriverModel model;
+  pca9685_test::InputReader reader(input.data(), input.size());
+  while (!reader.Empty()) {
+    if (!model.Step(reader)) {
+      std::printf("FAIL register model, seed %u: %s\n", seed, model.GetFailure());
+      return false;
+    }
+  }
+  total.calls += model.GetStats().calls;
+  total.rejected += model.GetStats().rejected;
+  total.failed += model.GetStats().failed;
+  total.fault_windows += model.GetStats().fault_windows;
+  return true;
+}
+
+/** @brief Accumulates the high time of one channel over a window of the edge timeline. */
+struct HighTime {
+  uint8_t channel;
+  uint64_t window_start;
+  uint64_t high_since;
+  bool high;
+  uint64_t total;
+
+  static void OnEdge(void* context, const pca9685::SimEdge& edge) {
+    auto* self = static_cast<HighTime*>(context);
+    if (edge.channel != self->channel) {
+      return;
+    }
+    const bool high = edge.level == pca9685::SimLevel::High;
+    if (high == self->high) {
+      return;
+    }
+    if (self->high) {
+      self->total += edge.time_ns - std::max(self->high_since, self->window_start);
+    }
+    self->high = high;
+    self->high_since = edge.time_ns;
+  }
+};
+
+/**
+ * @brief Expected high ticks per period for an (ON, OFF) register pair, per the datasheet:
+ *        full-off wins over full-on, full-on is always high, otherwise the output is high
+ *        from ON to OFF (wrapping), and ON == OFF is always low.
+ */
+uint16_t expectedHighTicks(uint16_t on, uint16_t off) {
+  if ((off & 0x1000) != 0) {
+    return 0;
+  }
+  if ((on & 0x1000) != 0) {
+    return 4096;
+  }
+  return static_cast<uint16_t>((off - on) & 0x0FFF);
+}
+
+bool runWaveform(uint32_t seed) {
+  std::mt19937 rng(seed);
+  pca9685::PCA9685Simulator sim;
+  SimBus bus(sim);
+  pca9685::PCA9685<SimBus> driver(&bus, 0x40);
+  const uint8_t channel = static_cast<uint8_t>(rng() % 16);
+  uint16_t on = static_cast<uint16_t>(rng() % 4096);
+  uint16_t off = static_cast<uint16_t>(rng() % 4096);
+  bool ok = driver.EnsureInitialized() &&
+            driver.SetPwmFreq(200.0F + static_cast<float>(rng() % 800));
+  switch (rng() % 8) {
+  case 0:
+    ok = ok && driver.SetChannelFullOn(channel);
+    on = 0x1000;
+    off = 0;
+    break;
+  case 1:
+    ok = ok && driver.SetChannelFullOff(channel);
+    on = 0;
+    off = 0x1000;
+    break;
+  default:
+    ok = ok && driver.SetPwm(channel, on, off);
+    break;
+  }
+  if (!ok) {
+    std::printf("FAIL waveform, seed %u: driver call failed\n", seed);
+    return false;
+  }
+  // Let the oscillator start and the new values latch, then measure whole periods
+  const uint64_t period = sim.GetPeriodNs();
+  sim.AdvanceNs(2 * period);
+  const uint64_t periods = 3;
+  HighTime meter{channel, sim.NowNs(), sim.NowNs(),
+                 sim.GetOutput(channel) == pca9685::SimLevel::High, 0};
+  sim.SetEdgeCallback(&HighTime::OnEdge, &meter);
+  sim.AdvanceNs(periods * period);
+  sim.SetEdgeCallback(nullptr, nullptr);
+  if (meter.high) {
+    meter.total += sim.NowNs() - std::max(meter.high_since, meter.window_start);
+  }
+  // Edges fall on whole counter steps: allow one step of rounding per edge
+  const uint64_t expected = periods * period * expectedHighTicks(on, off) / 4096;
+  const uint64_t tolerance = 2 * periods * (period / 4096 + 1);
+  const uint64_t error = meter.total > expected ? meter.total - expected : expected - meter.total;
+  if (error > tolerance) {
+    std::printf("FAIL waveform, seed %u: ch %u ON 0x%04X OFF 0x%04X high %llu ns, expected %llu\n",
+                seed, channel, on, off, static_cast<unsigned long long>(meter.total),
+                static_cast<unsigned long long>(expected));
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    // Replay one seed of both properties
+    const auto seed = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 0));
+    pca9685_test::DriverModel::Stats stats{};
+    return runRegisterModel(seed, stats) && runWaveform(seed) ? 0 : 1;
+  }
+  pca9685_test::DriverModel::Stats stats{};
+  for (uint32_t seed = 0; seed < REGISTER_SEEDS; ++seed) {
+    if (!runRegisterModel(seed, stats)) {
+      return 1;
+    }
+  }
+  std::printf("register model: %u seeds, %u calls (%u rejected, %u failed, %u with faults)\n",
+              REGISTER_SEEDS, stats.calls, stats.rejected, stats.failed, stats.fault_windows);
+  for (uint32_t seed = 0; seed < WAVEFORM_SEEDS; ++seed) {
+    if (!runWaveform(seed)) {
+      return 1;
+    }
+  }
+  std::printf("waveform: %u seeds\n", WAVEFORM_SEEDS);
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file pca9685_test_support.hpp
+ * @brief Check counter, simulator clock and register helpers shared by the host tests
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Each host test is a plain executable: checks go through Expect(), and main() returns
+ * Finish(), which prints a summary and yields the exit code CTest looks at.
+ */
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+#include "pca9685_simulator.hpp"
+
+namespace pca9685_test {
+
+/** @brief Number of failed Expect() checks so far. */
+inline int g_failures = 0;
+
+/**
+ * @brief Count a check, printing it if it fails.
+ * @param condition Check result.
+ * @param what Short description of what was checked.
+ */
+inline void Expect(bool condition, const char* what) {
+  if (!condition) {
+    std::printf("FAIL %s\n", what);
+    ++g_failures;
+  }
+}
+
+/**
+ * @brief Print the summary line of a test program.
+ * @param suite Name printed when every check passed.
+ * @return Exit code for main(): 0 if every check passed, 1 otherwise.
+ */
+inline int Finish(const char* suite) {
+  if (g_failures != 0) {
+    std::printf("%d check(s) failed\n", g_failures);
+    return 1;
+  }
+  std::printf("%s: all checks passed\n", suite);
+  return 0;
+}
+
+/** @brief Simulator whose clock SimNowUs() reads (see AttachSimClock()). */
+inline pca9685::PCA9685Simulator* g_clock_sim = nullptr;
+
+/** @brief Current simulated time in µs; a ClockFn for the driver. */
+inline uint32_t SimNowUs() {
+  return static_cast<uint32_t>(g_clock_sim->NowNs() / 1000U);
+}
+
+/**
+ * @brief Make the driver's clock follow the simulator's clock.
+ *
+ * The simulator then checks the driver's timing against its datasheet rules (500 µs
+ * oscillator start-up before RESTART, the RESTART hold of running outputs).
+ */
+template <typename Driver>
+void AttachSimClock(pca9685::PCA9685Simulator& sim, Driver& pwm) {
+  g_clock_sim = &sim;
+  pwm.SetClock(SimNowUs);
+}
+
+/** @brief ON tick count (bits 0-11 of LEDn_ON) of a channel in the simulator. */
+inline uint16_t OnTicks(const pca9685::PCA9685Simulator& sim, uint8_t channel) {
+  const auto reg = static_cast<uint8_t>(0x06 + (4 * channel));
+  return static_cast<uint16_t>(sim.GetRegister(reg) | ((sim.GetRegister(reg + 1) & 0x0F) << 8));
+}
+
+/** @brief OFF tick count (bits 0-11 of LEDn_OFF) of a channel in the simulator. */
+inline uint16_t OffTicks(const pca9685::PCA9685Simulator& sim, uint8_t channel) {
+  const auto reg = static_cast<uint8_t>(0x08 + (4 * channel));
+  return static_cast<uint16_t>(sim.GetRegister(reg) | ((sim.GetRegister(reg + 1) & 0x0F) << 8));
+}
+
+} // namespace pca9685_test
@@ -0,0 +1,158 @@
+/**
+ * @file pca9685_trace_test.cpp
+ * @brief Host tests of TraceRecorder, the dump format, TraceReader and ReplayTrace
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Records a driver workload on the simulator, replays the dump into a fresh simulator and
+ * compares the register files; checks ring overwrite and failure flags. With a file argument
+ * the recorded dump is also written there (used by the trace replay tool test).
+ */
+#include <cstdint>
+#include <vector>
+
+#include "pca9685.hpp"
+#include "pca9685_fault_injector.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+#include "pca9685_trace.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+
+uint32_t g_now_us = 0;
+uint32_t NowUs() {
+  return g_now_us += 500;
+}
+
+struct VectorSink {
+  std::vector<uint8_t> bytes;
+  bool Write(const uint8_t* data, size_t size) {
+    bytes.insert(bytes.end(), data, data + size);
+    return true;
+  }
+};
+
+/** @brief Record a small workload, then check the dump round-trips into a fresh simulator. */
+std::vector<uint8_t> testRecordAndReplay() {
+  Sim sim;
+  pca9685::TraceRecorder<Sim> recorder(sim);
+  recorder.SetClock(NowUs);
+  pca9685::PCA9685<pca9685::TraceRecorder<Sim>> pwm(&recorder, 0x40);
+  bool ok = pwm.EnsureInitialized() && pwm.SetPwmFreq(500.0F);
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    ok &= pwm.SetDuty(ch, static_cast<float>(ch) / 15.0F);
+  }
+  for (uint8_t ch = 0; ch < 16; ++ch) {
+    ok &= pwm.StageDutyTicks(ch, static_cast<uint16_t>(4096 - (ch * 256)));
+  }
+  ok &= pwm.CommitFrame();
+  uint16_t mismatch = 0;
+  ok &= pwm.Verify(mismatch) && mismatch == 0;
+  Expect(ok, "workload through the recorder");
+  Expect(recorder.GetRecordCount() == sim.GetTransactionCount(), "one record per transfer");
+  Expect(recorder.GetDroppedCount() == 0, "nothing dropped");
+
+  VectorSink dump;
+  Expect(recorder.Dump(dump) && dump.bytes.size() == recorder.GetDumpSize(), "dump size");
+
+  pca9685::TraceReader reader(dump.bytes.data(), dump.bytes.size());
+  Expect(reader.IsValid() && reader.GetRecordCount() == recorder.GetRecordCount(),
+         "reader accepts the dump");
+  pca9685::TraceEvent event{};
+  uint32_t records = 0;
+  uint32_t last_time = 0;
+  bool ordered = true;
+  while (reader.Next(event)) {
+    ordered &= records == 0 || event.time_us > last_time;
+    last_time = event.time_us;
+    ++records;
+  }
+  Expect(records == reader.GetRecordCount() && ordered, "records in recording order");
+
+  Sim replica;
+  reader.Rewind();
+  pca9685::ReplayStats stats;
+  Expect(pca9685::ReplayTrace(reader, replica, pca9685::ReplayOptions{}, stats),
+         "replay succeeds with matching reads");
+  Expect(stats.reads > 0 && stats.read_mismatches == 0, "reads compared");
+  bool same = true;
+  for (uint16_t reg = 0; reg <= 0xFF; ++reg) {
+    same &= replica.GetRegister(static_cast<uint8_t>(reg)) ==
+            sim.GetRegister(static_cast<uint8_t>(reg));
+  }
+  Expect(same, "replayed register file equals the original");
+  return dump.bytes;
+}
+
+void testRingOverwrite() {
+  Sim sim;
+  pca9685::TraceRecorder<Sim, 512> recorder(sim);
+  const uint8_t payload[4] = {1, 2, 3, 4};
+  for (uint32_t i = 0; i < 200; ++i) {
+    const auto reg = static_cast<uint8_t>(0x06 + ((i % 16) * 4));
+    (void)recorder.Write(0x40, reg, payload, sizeof(payload));
+  }
+  // 12-byte records: 42 fit in 512 bytes
+  Expect(recorder.GetRecordCount() == 42 && recorder.GetDroppedCount() == 158,
+         "oldest records overwritten");
+  VectorSink dump;
+  (void)recorder.Dump(dump);
+  pca9685::TraceReader reader(dump.bytes.data(), dump.bytes.size());
+  pca9685::TraceEvent event{};
+  Expect(reader.Next(event) && event.reg == 0x06 + ((158 % 16) * 4) && event.len == 4,
+         "first record after wrap is the oldest kept");
+  uint32_t records = 1;
+  while (reader.Next(event)) {
+    ++records;
+  }
+  Expect(records == 42 && reader.IsValid(), "wrapped ring dumps intact records");
+
+  // Truncated dump is detected
+  pca9685::TraceReader cut(dump.bytes.data(), dump.bytes.size() - 3);
+  while (cut.Next(event)) {
+  }
+  Expect(!cut.IsValid(), "truncated dump rejected");
+}
+
+void testFailedTransfers() {
+  Sim sim;
+  pca9685::FaultInjectingBus<Sim> faulty(sim);
+  pca9685::TraceRecorder<pca9685::FaultInjectingBus<Sim>> recorder(faulty);
+  const uint8_t value = 0x55;
+  faulty.FailNext(1);
+  Expect(!recorder.Write(0x40, 0x06, &value, 1), "injected failure passes through");
+  Expect(recorder.Write(0x40, 0x06, &value, 1), "next write succeeds");
+  VectorSink dump;
+  (void)recorder.Dump(dump);
+  pca9685::TraceReader reader(dump.bytes.data(), dump.bytes.size());
+  pca9685::TraceEvent event{};
+  Expect(reader.Next(event) && event.Failed() && !event.IsRead(), "failure flagged");
+  Expect(reader.Next(event) && !event.Failed(), "success not flagged");
+
+  reader.Rewind();
+  Sim replica;
+  pca9685::ReplayStats stats;
+  (void)pca9685::ReplayTrace(reader, replica, pca9685::ReplayOptions{}, stats);
+  Expect(stats.skipped == 1 && stats.writes == 1, "failed records skipped by default");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::vector<uint8_t> dump = testRecordAndReplay();
+  testRingOverwrite();
+  testFailedTransfers();
+  if (argc > 1) {
+    std::FILE* file = std::fopen(argv[1], "wb");
+    Expect(file != nullptr && std::fwrite(dump.data(), 1, dump.size(), file) == dump.size(),
+           "write dump file");
+    if (file != nullptr) {
+      (void)std::fclose(file);
+    }
+  }
+  return Finish("trace");
+}
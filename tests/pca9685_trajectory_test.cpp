@@ -0,0 +1,112 @@
+/**
+ * @file pca9685_trajectory_test.cpp
+ * @brief Host tests of Trajectory outputs when targets or limits change mid-move
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Every frame is staged into a driver on the simulator, so an output outside the axis range
+ * (or a wrapped negative position) shows up as a rejected StageDutyTicks().
+ */
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+#include "pca9685_trajectory.hpp"
+
+namespace {
+
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+using Motion = pca9685::Trajectory<1>;
+
+/** @brief Fast axis: 64 ticks per frame, 8 ticks per frame^2. */
+Motion::Limits fastLimits() {
+  Motion::Limits limits;
+  limits.max_velocity = 64 << 8;
+  limits.max_accel = 8 << 8;
+  return limits;
+}
+
+/**
+ * @brief Step until the axis settles, staging every frame.
+ * @return true if every frame staged, every output stayed in [lo, hi] and the axis settled.
+ */
+bool runToTarget(Motion& motion, Driver& pwm, uint16_t lo, uint16_t hi) {
+  for (int frame = 0; frame < 1000 && !motion.AtTarget(0); ++frame) {
+    motion.Step();
+    const uint16_t position = motion.GetPosition(0);
+    if (!motion.Stage(pwm, 0, 1) || position < lo || position > hi) {
+      return false;
+    }
+  }
+  return motion.AtTarget(0);
+}
+
+void testTargetChangeMidMove() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Motion motion;
+  motion.SetAllLimits(fastLimits());
+
+  // Reverse at full speed
+  motion.SetTarget(0, 4095);
+  for (int frame = 0; frame < 40; ++frame) {
+    motion.Step();
+  }
+  motion.SetTarget(0, 0);
+  Expect(runToTarget(motion, pwm, 0, 4095) && motion.GetPosition(0) == 0, "reversed to 0");
+
+  // Target jumps just ahead of a fast axis: it brakes past the target and comes back
+  motion.SetTarget(0, 4095);
+  while (motion.GetPosition(0) < 3900) {
+    motion.Step();
+  }
+  motion.SetTarget(0, 3950);
+  Expect(runToTarget(motion, pwm, 0, 4095) && motion.GetPosition(0) == 3950,
+         "overshoot and return");
+}
+
+void testSlowerBrakingStaysInRange() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Motion motion;
+  Motion::Limits limits = fastLimits();
+  motion.SetAllLimits(limits);
+  motion.Jump(0, 4095);
+  motion.SetTarget(0, 0);
+  while (motion.GetPosition(0) > 600) {
+    motion.Step();
+  }
+
+  // Too little deceleration left to stop on 0: the unfiltered position goes negative
+  limits.max_accel = 1 << 8;
+  motion.SetAllLimits(limits);
+  motion.Step();
+  Expect(motion.Stage(pwm, 0, 1), "staged while braking");
+  Expect(runToTarget(motion, pwm, 0, 600) && motion.GetPosition(0) == 0, "output held at 0");
+}
+
+void testNarrowedRange() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Motion motion;
+  motion.SetAllLimits(fastLimits());
+  motion.Jump(0, 500);
+  Motion::Limits limits = fastLimits();
+  limits.min_ticks = 1000;
+  motion.SetAllLimits(limits);
+  Expect(motion.GetPosition(0) == 1000 && motion.GetTarget(0) == 1000, "output in the new range");
+  Expect(runToTarget(motion, pwm, 1000, 1000), "settles on the new minimum");
+}
+
+} // namespace
+
+int main() {
+  testTargetChangeMidMove();
+  testSlowerBrakingStaysInRange();
+  testNarrowedRange();
+  return Finish("trajectory");
+}
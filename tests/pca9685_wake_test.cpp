@@ -0,0 +1,137 @@
+/**
+ * @file pca9685_wake_test.cpp
+ * @brief Host tests of WakeAsync(), the power state and channel writes queued until RESTART
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * A PWM register write releases the simulator's RESTART hold just as RESTART does, so a
+ * write that slipped out while settling would show up as a premature restart.
+ */
+#include <cstdint>
+
+#include "pca9685.hpp"
+#include "pca9685_simulator.hpp"
+#include "pca9685_test_support.hpp"
+
+namespace {
+
+using pca9685_test::AttachSimClock;
+using pca9685_test::Expect;
+using pca9685_test::Finish;
+using pca9685_test::OffTicks;
+using pca9685_test::SimNowUs;
+
+using Sim = pca9685::PCA9685Simulator;
+using Driver = pca9685::PCA9685<Sim>;
+using PowerState = Driver::PowerState;
+
+/** @brief Driver with two channels running, then put to sleep (outputs held for RESTART). */
+bool setUpAsleep(Sim& sim, Driver& pwm) {
+  AttachSimClock(sim, pwm);
+  bool ok = pwm.EnsureInitialized() && pwm.SetPwm(0, 0, 2048) && pwm.SetPwm(5, 1000, 3000);
+  sim.AdvanceUs(1000);
+  ok &= pwm.GetPowerState() == PowerState::Awake && pwm.Sleep();
+  sim.AdvanceUs(1000);
+  return ok && pwm.GetPowerState() == PowerState::Asleep && sim.IsRestartPending();
+}
+
+void testWakeAsync() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUpAsleep(sim, pwm), "asleep with outputs held");
+
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.WakeAsync() && sim.GetTransactionCount() - before == 1, "one MODE1 write");
+  Expect(pwm.GetPowerState() == PowerState::Settling &&
+             pwm.GetRestartDueUs() == SimNowUs() + Driver::OSC_SETTLE_US_,
+         "settling with a ready-at time");
+
+  // Channel writes while settling are queued, not sent
+  Expect(pwm.SetPwm(3, 0, 1000) && pwm.SetDuty(7, 0.25F), "writes accepted while settling");
+  Expect(pwm.StageDutyTicks(9, 2048) && pwm.CommitFrame(), "frame commit accepted");
+  Expect(sim.GetTransactionCount() - before == 1 && sim.IsRestartPending(),
+         "nothing written, RESTART hold intact");
+
+  sim.AdvanceUs(300);
+  Expect(pwm.ServiceRestart() && pwm.GetPowerState() == PowerState::Settling &&
+             sim.GetTransactionCount() - before == 1,
+         "too early: no transfer");
+
+  sim.AdvanceUs(200);
+  Expect(pwm.ServiceRestart() && pwm.GetPowerState() == PowerState::Awake, "restarted");
+  Expect(sim.GetTransactionCount() - before == 3, "RESTART + one burst of queued channels");
+  Expect(sim.IsRunning() && !sim.IsRestartPending(), "outputs resumed");
+  Expect(OffTicks(sim, 0) == 2048 && OffTicks(sim, 3) == 1000 && OffTicks(sim, 7) == 1024 &&
+             OffTicks(sim, 9) == 2048,
+         "previous and queued values on the device");
+  uint16_t mismatch = 0;
+  Expect(pwm.Verify(mismatch) && mismatch == 0, "shadow image matches");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+
+  const uint32_t awake = sim.GetTransactionCount();
+  Expect(pwm.WakeAsync() && sim.GetTransactionCount() == awake, "already awake: no transfer");
+  Expect(pwm.SetPwm(3, 0, 500) && sim.GetTransactionCount() == awake + 1, "direct writes again");
+}
+
+/** @brief Legacy Wake() for comparison: RESTART right after clearing SLEEP is too early. */
+void testLegacyWake() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUpAsleep(sim, pwm), "asleep with outputs held");
+  Expect(pwm.Wake() && sim.GetTimingViolations() == 1,
+         "legacy Wake() restarts 0 us after clearing SLEEP");
+}
+
+void testSleepWhileSettling() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  Expect(setUpAsleep(sim, pwm) && pwm.WakeAsync(), "settling");
+  Expect(pwm.SetPwm(2, 0, 300), "queued");
+  Expect(pwm.Sleep() && pwm.GetPowerState() == PowerState::Asleep && !pwm.IsRestartPending(),
+         "asleep again, RESTART dropped");
+  Expect(OffTicks(sim, 2) == 300, "queued write flushed while asleep");
+  Expect(pwm.SetAllPwm(0, 100) && OffTicks(sim, 15) == 100, "asleep: writes go straight out");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+}
+
+/** @brief Retry-delay hook that lets simulated time pass (see SetRetryDelayUs()). */
+uint32_t g_waited_us = 0;
+void SimDelayUs(uint32_t delay_us) {
+  g_waited_us += delay_us;
+  pca9685_test::g_clock_sim->AdvanceUs(delay_us);
+}
+
+/** @brief Wake() while settling finishes the pending wake instead of leaving it queued. */
+void testWakeWhileSettling() {
+  Sim sim;
+  Driver pwm(&sim, 0x40);
+  pwm.SetRetryDelayUs(SimDelayUs);
+  Expect(setUpAsleep(sim, pwm) && pwm.WakeAsync() && pwm.SetPwm(2, 0, 300), "settling, queued");
+  sim.AdvanceUs(200);
+  g_waited_us = 0;
+  Expect(pwm.Wake() && pwm.GetPowerState() == PowerState::Awake && !pwm.IsRestartPending(),
+         "Wake() completes the wake");
+  Expect(g_waited_us == Driver::OSC_SETTLE_US_ - 200, "waited out the settle time");
+  Expect(OffTicks(sim, 2) == 300 && sim.IsRunning() && !sim.IsRestartPending(),
+         "queued write flushed, outputs resumed");
+  Expect(sim.GetTimingViolations() == 0, "no timing violations");
+  const uint32_t before = sim.GetTransactionCount();
+  Expect(pwm.SetPwm(2, 0, 400) && sim.GetTransactionCount() == before + 1, "direct writes again");
+
+  // Without a delay hook the RESTART goes out at once (as legacy Wake()), but nothing stays queued
+  Driver bare(&sim, 0x40);
+  Expect(bare.EnsureInitialized() && bare.SetPwm(0, 0, 1000) && bare.Sleep(), "asleep");
+  sim.AdvanceUs(1000);
+  Expect(bare.WakeAsync() && bare.SetPwm(4, 0, 700), "settling, queued");
+  Expect(bare.Wake() && bare.GetPowerState() == PowerState::Awake && OffTicks(sim, 4) == 700,
+         "awake, queue flushed");
+}
+
+} // namespace
+
+int main() {
+  testWakeAsync();
+  testLegacyWake();
+  testSleepWhileSettling();
+  testWakeWhileSettling();
+  return Finish("wake");
+}
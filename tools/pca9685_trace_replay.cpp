@@ -0,0 +1,317 @@
+/**
+ * @file pca9685_trace_replay.cpp
+ * @brief Host tool: inspect a PCA9685 bus trace and replay it into the simulator or a real bus
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ *
+ * Usage: pca9685_trace_replay [options] TRACE
+ *
+ *   --list           Print every record
+ *   --bus-hz N       SCL frequency for wire-time estimates (default 400000)
+ *   --address A      Simulator replay: device address (default 0x40)
+ *   --vcd FILE       Simulator replay: write the output waveforms as VCD
+ *   --i2c DEVICE     Replay onto a Linux i2c-dev bus (e.g. /dev/i2c-1) instead of the simulator
+ *   --realtime       Bus replay: reproduce the recorded gaps between transfers (the
+ *                    simulator always follows the recorded timeline)
+ *   --replay-failed  Also replay transfers that failed when recorded
+ *
+ * The summary shows the traffic mix, estimated wire time and bus utilisation, and what
+ * merging consecutive writes to adjacent registers of one device into single bursts would
+ * save (the effect of batching the same workload with StagePwm()/CommitFrame()).
+ *
+ * Exit status: 0 if the trace replayed without bus failures or read mismatches.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "pca9685_simulator.hpp"
+#include "pca9685_trace.hpp"
+
+#if defined(__linux__) && __has_include(<linux/i2c-dev.h>)
+#define HF_PCA9685_HAVE_I2C_DEV 1
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Options {
+  const char* trace = nullptr;
+  const char* vcd = nullptr;
+  const char* i2c = nullptr;
+  uint32_t bus_hz = 400000;
+  uint8_t address = 0x40;
+  bool list = false;
+  bool realtime = false;
+  bool replay_failed = false;
+};
+
+/** @brief Clock cycles of one register transfer: START, address, register, payload, STOP. */
+uint64_t transferClocks(const pca9685::TraceEvent& event) {
+  // A read adds a repeated START and the address byte again
+  const uint64_t bytes = 2U + event.len + (event.IsRead() ? 1U : 0U);
+  return (9U * bytes) + (event.IsRead() ? 3U : 2U);
+}
+
+void printRecord(uint32_t index, const pca9685::TraceEvent& event) {
+  std::printf("%6u %10u us  0x%02X %s 0x%02X %3u%s%s ", index, event.time_us, event.addr,
+              event.IsRead() ? "R" : "W", event.reg, event.len, event.Failed() ? " FAIL" : "",
+              (event.flags & pca9685::TraceEvent::TRUNCATED_) != 0 ? " TRUNC" : "");
+  for (uint8_t i = 0; i < event.len && i < 16; ++i) {
+    std::printf(" %02X", event.data[i]);
+  }
+  std::printf("%s\n", event.len > 16 ? " ..." : "");
+}
+
+/**
+ * @brief Traffic summary, and the same traffic with adjacent writes merged into bursts.
+ */
+void summarize(pca9685::TraceReader& reader, const Options& options) {
+  uint32_t writes = 0;
+  uint32_t reads = 0;
+  uint32_t failed = 0;
+  uint64_t payload = 0;
+  uint64_t clocks = 0;
+  uint32_t merged_transfers = 0;
+  uint64_t merged_clocks = 0;
+  uint32_t first_time = 0;
+  uint32_t last_time = 0;
+  bool first = true;
+  bool open_burst = false;
+  uint8_t burst_addr = 0;
+  uint16_t burst_next_reg = 0;
+
+  pca9685::TraceEvent event{};
+  for (uint32_t index = 0; reader.Next(event); ++index) {
+    if (options.list) {
+      printRecord(index, event);
+    }
+    if (first) {
+      first_time = event.time_us;
+      first = false;
+    }
+    last_time = event.time_us;
+    (event.IsRead() ? reads : writes) += 1;
+    failed += event.Failed() ? 1U : 0U;
+    payload += event.len;
+    clocks += transferClocks(event);
+
+    // Merge a write into the open burst if it continues it on the same device
+    if (!event.IsRead() && open_burst && event.addr == burst_addr && event.reg == burst_next_reg) {
+      merged_clocks += 9U * event.len;
+    } else {
+      ++merged_transfers;
+      merged_clocks += transferClocks(event);
+    }
+    open_burst = !event.IsRead();
+    burst_addr = event.addr;
+    burst_next_reg = static_cast<uint16_t>(event.reg + event.len);
+  }
+
+  const double wire_us = 1e6 * static_cast<double>(clocks) / options.bus_hz;
+  const double merged_us = 1e6 * static_cast<double>(merged_clocks) / options.bus_hz;
+  const uint32_t span_us = last_time - first_time;
+  std::printf("records:      %u (%u dropped before the first), %u writes, %u reads, %u failed\n",
+              reader.GetRecordCount(), reader.GetDroppedCount(), writes, reads, failed);
+  std::printf("payload:      %llu bytes, %.1f bytes per transfer\n",
+              static_cast<unsigned long long>(payload),
+              writes + reads != 0 ? static_cast<double>(payload) / (writes + reads) : 0.0);
+  std::printf("wire time:    %.0f us at %u Hz", wire_us, options.bus_hz);
+  if (span_us != 0) {
+    std::printf(" over %u us recorded (%.1f %% bus utilisation)", span_us,
+                100.0 * wire_us / span_us);
+  }
+  const double saved = wire_us > 0 ? 100.0 * (wire_us - merged_us) / wire_us : 0.0;
+  std::printf("\nbatched:      %u transfers, %.0f us wire time (%.1f %% saved)\n",
+              merged_transfers, merged_us, saved);
+}
+
+void sleepUs(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+pca9685::PCA9685Simulator* g_sim = nullptr;
+uint64_t g_sim_target_ns = 0;
+
+/** @brief Keep simulated time on the recorded timeline (transfers themselves take time too). */
+void advanceSimUs(uint32_t us) {
+  g_sim_target_ns += static_cast<uint64_t>(us) * 1000U;
+  if (g_sim_target_ns > g_sim->NowNs()) {
+    g_sim->AdvanceNs(g_sim_target_ns - g_sim->NowNs());
+  }
+}
+
+struct FileSink {
+  std::FILE* file;
+  bool Write(const uint8_t* data, size_t size) {
+    return std::fwrite(data, 1, size, file) == size;
+  }
+};
+
+#ifdef HF_PCA9685_HAVE_I2C_DEV
+/**
+ * @brief Linux i2c-dev bus (register write, and register read with repeated START).
+ */
+class LinuxI2cBus : public pca9685::I2cInterface<LinuxI2cBus> {
+public:
+  explicit LinuxI2cBus(const char* device) noexcept : fd_(::open(device, O_RDWR)) {}
+  ~LinuxI2cBus() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+  LinuxI2cBus(const LinuxI2cBus&) = delete;
+  LinuxI2cBus& operator=(const LinuxI2cBus&) = delete;
+
+  bool Write(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) noexcept {
+    uint8_t buffer[257];
+    if (len > 256) {
+      return false;
+    }
+    buffer[0] = reg;
+    std::memcpy(buffer + 1, data, len);
+    // A general-call reset (0x00, 0x06) is the single byte 0x06
+    i2c_msg msg{addr, 0, static_cast<uint16_t>(len + 1), buffer};
+    return transfer(&msg, 1);
+  }
+  bool Read(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) noexcept {
+    i2c_msg msgs[2] = {{addr, 0, 1, &reg}, {addr, I2C_M_RD, static_cast<uint16_t>(len), data}};
+    return transfer(msgs, 2);
+  }
+  bool EnsureInitialized() noexcept {
+    return fd_ >= 0;
+  }
+
+private:
+  int fd_;
+
+  bool transfer(i2c_msg* msgs, uint32_t count) noexcept {
+    i2c_rdwr_ioctl_data request{msgs, count};
+    return fd_ >= 0 && ::ioctl(fd_, I2C_RDWR, &request) >= 0;
+  }
+};
+#endif
+
+template <typename Bus>
+bool replay(pca9685::TraceReader& reader, Bus& bus, const Options& options,
+            pca9685::ReplayOptions::DelayUsFn delay) {
+  pca9685::ReplayOptions replay_options;
+  replay_options.replay_failed = options.replay_failed;
+  replay_options.delay_us = delay;
+  pca9685::ReplayStats stats;
+  const bool ok = pca9685::ReplayTrace(reader, bus, replay_options, stats);
+  std::printf("replay:       %u writes, %u reads, %u failed, %u read mismatches, %u skipped\n",
+              stats.writes, stats.reads, stats.failed, stats.read_mismatches, stats.skipped);
+  return ok;
+}
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: pca9685_trace_replay [--list] [--bus-hz N] [--address A] [--vcd FILE]\n"
+               "                            [--i2c DEVICE] [--realtime] [--replay-failed] TRACE\n");
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "--list") == 0) {
+      options.list = true;
+    } else if (std::strcmp(argv[i], "--realtime") == 0) {
+      options.realtime = true;
+    } else if (std::strcmp(argv[i], "--replay-failed") == 0) {
+      options.replay_failed = true;
+    } else if (std::strcmp(argv[i], "--bus-hz") == 0 && has_value) {
+      options.bus_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(argv[i], "--address") == 0 && has_value) {
+      options.address = static_cast<uint8_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(argv[i], "--vcd") == 0 && has_value) {
+      options.vcd = argv[++i];
+    } else if (std::strcmp(argv[i], "--i2c") == 0 && has_value) {
+      options.i2c = argv[++i];
+    } else if (argv[i][0] != '-' && options.trace == nullptr) {
+      options.trace = argv[i];
+    } else {
+      return usage();
+    }
+  }
+  if (options.trace == nullptr || options.bus_hz == 0) {
+    return usage();
+  }
+
+  std::FILE* file = std::fopen(options.trace, "rb");
+  if (file == nullptr) {
+    std::fprintf(stderr, "cannot open %s\n", options.trace);
+    return 1;
+  }
+  std::vector<uint8_t> dump;
+  uint8_t chunk[4096];
+  size_t n = 0;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), file)) != 0) {
+    dump.insert(dump.end(), chunk, chunk + n);
+  }
+  (void)std::fclose(file);
+
+  pca9685::TraceReader reader(dump.data(), dump.size());
+  if (!reader.IsValid()) {
+    std::fprintf(stderr, "%s is not a PCA9685 trace (version %u)\n", options.trace,
+                 pca9685::TRACE_VERSION);
+    return 1;
+  }
+  summarize(reader, options);
+  if (!reader.IsValid()) {
+    std::fprintf(stderr, "trace is truncated or corrupt\n");
+    return 1;
+  }
+  reader.Rewind();
+
+  if (options.i2c != nullptr) {
+#ifdef HF_PCA9685_HAVE_I2C_DEV
+    LinuxI2cBus bus(options.i2c);
+    if (!bus.EnsureInitialized()) {
+      std::fprintf(stderr, "cannot open %s\n", options.i2c);
+      return 1;
+    }
+    return replay(reader, bus, options, options.realtime ? sleepUs : nullptr) ? 0 : 1;
+#else
+    std::fprintf(stderr, "--i2c needs Linux i2c-dev support\n");
+    return 1;
+#endif
+  }
+
+  // Simulator replay (recorded gaps are simulated time, so always reproduced)
+  pca9685::PCA9685Simulator sim(options.address, options.bus_hz);
+  g_sim = &sim;
+  g_sim_target_ns = sim.NowNs();
+  FileSink vcd_file{nullptr};
+  pca9685::VcdWriter<FileSink> vcd(vcd_file);
+  if (options.vcd != nullptr) {
+    vcd_file.file = std::fopen(options.vcd, "w");
+    if (vcd_file.file == nullptr) {
+      std::fprintf(stderr, "cannot create %s\n", options.vcd);
+      return 1;
+    }
+    (void)vcd.Begin();
+    sim.SetEdgeCallback(pca9685::VcdWriter<FileSink>::OnEdge, &vcd);
+  }
+  const bool ok = replay(reader, sim, options, advanceSimUs);
+  std::printf("simulator:    %u transactions, %u timing violations, %.3f ms simulated\n",
+              sim.GetTransactionCount(), sim.GetTimingViolations(),
+              static_cast<double>(sim.NowNs()) / 1e6);
+  if (vcd_file.file != nullptr) {
+    sim.AdvanceNs(2 * sim.GetPeriodNs());
+    (void)vcd.End(sim.NowNs());
+    (void)std::fclose(vcd_file.file);
+  }
+  return ok ? 0 : 1;
+}